@@ -153,7 +153,7 @@ function(parse_automake AM_FILE_NAME)
   endforeach()
 
   # Search for programs, creating CMake targets
-  foreach(AM_FILE ${bin_PROGRAMS})
+  foreach(AM_FILE ${bin_PROGRAMS} ${noinst_PROGRAMS})
     string(REPLACE "." "_" AM_NAME "${AM_FILE}")
     string(REPLACE "/" "_" AM_NAME "${AM_NAME}")
     am_add_target(bin ${AM_FOLDER} ${AM_FILE} "${${AM_NAME}_SOURCES}" "${${AM_NAME}_LDADD}")
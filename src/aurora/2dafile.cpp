@@ -27,6 +27,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -125,6 +126,9 @@ const Common::UString &TwoDARow::getCell(size_t n) const {
 }
 
 
+TwoDAFile::TwoDAFile() : _defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+}
+
 TwoDAFile::TwoDAFile(Common::SeekableReadStream &twoda) :
 	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
 
@@ -674,6 +678,76 @@ bool TwoDAFile::writeCSV(const Common::UString &fileName) const {
 	return true;
 }
 
+void TwoDAFile::writeSnapshotString(Common::WriteStream &out, const Common::UString &str) {
+	const size_t length = std::strlen(str.c_str());
+
+	out.writeUint32LE((uint32) length);
+	out.write(str.c_str(), length);
+}
+
+Common::UString TwoDAFile::readSnapshotString(Common::SeekableReadStream &snapshot) {
+	const size_t length = snapshot.readUint32LE();
+	if (length > (size_t)(snapshot.size() - snapshot.pos()))
+		throw Common::Exception(Common::kReadError);
+
+	return Common::readStringFixed(snapshot, Common::kEncodingUTF8, length);
+}
+
+void TwoDAFile::writeSnapshot(Common::WriteStream &out) const {
+	writeSnapshotString(out, _defaultString);
+
+	out.writeUint32LE((uint32) _headers.size());
+	for (std::vector<Common::UString>::const_iterator h = _headers.begin(); h != _headers.end(); ++h)
+		writeSnapshotString(out, *h);
+
+	out.writeUint32LE((uint32) _rows.size());
+	for (std::vector<TwoDARow *>::const_iterator r = _rows.begin(); r != _rows.end(); ++r) {
+		// Rows that failed to load are written as empty rows, which behave exactly the same
+		if (!*r) {
+			out.writeUint32LE(0);
+			continue;
+		}
+
+		out.writeUint32LE((uint32) (*r)->_data.size());
+		for (std::vector<Common::UString>::const_iterator c = (*r)->_data.begin(); c != (*r)->_data.end(); ++c)
+			writeSnapshotString(out, *c);
+	}
+}
+
+TwoDAFile *TwoDAFile::readSnapshot(Common::SeekableReadStream &snapshot) {
+	Common::ScopedPtr<TwoDAFile> twoda(new TwoDAFile);
+
+	try {
+		twoda->_defaultString = readSnapshotString(snapshot);
+		twoda->_defaultInt    = parseInt(twoda->_defaultString);
+		twoda->_defaultFloat  = parseFloat(twoda->_defaultString);
+
+		const size_t headerCount = snapshot.readUint32LE();
+		twoda->_headers.reserve(headerCount);
+		for (size_t i = 0; i < headerCount; i++)
+			twoda->_headers.push_back(readSnapshotString(snapshot));
+
+		const size_t rowCount = snapshot.readUint32LE();
+		twoda->_rows.reserve(rowCount);
+		for (size_t i = 0; i < rowCount; i++) {
+			twoda->_rows.push_back(new TwoDARow(*twoda));
+
+			const size_t cellCount = snapshot.readUint32LE();
+			twoda->_rows.back()->_data.reserve(cellCount);
+			for (size_t j = 0; j < cellCount; j++)
+				twoda->_rows.back()->_data.push_back(readSnapshotString(snapshot));
+		}
+
+		twoda->createHeaderMap();
+
+	} catch (Common::Exception &e) {
+		e.add("Failed reading 2DA snapshot");
+		throw;
+	}
+
+	return twoda.release();
+}
+
 int32 TwoDAFile::parseInt(const Common::UString &str) {
 	if (str.empty())
 		return 0;
@@ -160,8 +160,19 @@ public:
 	void writeCSV(Common::WriteStream &out) const;
 	/** Write the 2DA data into a CSV file. */
 	bool writeCSV(const Common::UString &fileName) const;
+
+	/** Write the parsed 2DA data into an xoreos-internal binary snapshot.
+	 *
+	 *  Unlike a V2.b binary 2DA, a snapshot preserves the default value
+	 *  and can be read back without any tokenizing or string lookups.
+	 *  See TwoDARegistry::loadSnapshot().
+	 */
+	void writeSnapshot(Common::WriteStream &out) const;
 	// '---
 
+	/** Create a 2DA out of a snapshot written by writeSnapshot(). */
+	static TwoDAFile *readSnapshot(Common::SeekableReadStream &snapshot);
+
 private:
 	typedef std::map<Common::UString, size_t, Common::UString::iless> HeaderMap;
 
@@ -175,6 +186,8 @@ private:
 	TwoDARow _emptyRow;
 	Common::PtrVector<TwoDARow> _rows;
 
+	TwoDAFile();
+
 	// Loading helpers
 	void load(Common::SeekableReadStream &twoda);
 	void read2a(Common::SeekableReadStream &twoda);
@@ -193,6 +206,10 @@ private:
 	// GDA loading/conversion helpers
 	void load(const GDAFile &gda);
 
+	// Snapshot helpers
+	static void writeSnapshotString(Common::WriteStream &out, const Common::UString &str);
+	static Common::UString readSnapshotString(Common::SeekableReadStream &snapshot);
+
 	void createHeaderMap();
 
 	static int32 parseInt(const Common::UString &str);
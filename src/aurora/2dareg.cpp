@@ -25,6 +25,13 @@
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
 #include "src/common/readstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/encoding.h"
+#include "src/common/hash.h"
+#include "src/common/threadpool.h"
+#include "src/common/util.h"
 
 #include "src/aurora/2dareg.h"
 #include "src/aurora/types.h"
@@ -34,9 +41,130 @@
 
 DECLARE_SINGLETON(Aurora::TwoDARegistry)
 
+static const uint32 kSnapshotID      = MKTAG('X', '2', 'D', 'S');
+static const uint32 kSnapshotVersion = 1;
+
 namespace Aurora {
 
-TwoDARegistry::TwoDARegistry() {
+/** Hash the complete contents of a resource stream. */
+static uint64 hashStream(Common::SeekableReadStream &stream) {
+	uint64 hash = 0xCBF29CE484222325LL;
+
+	stream.seek(0);
+
+	byte buffer[4096];
+
+	size_t n;
+	while ((n = stream.read(buffer, sizeof(buffer))) > 0)
+		for (size_t i = 0; i < n; i++)
+			hash = Common::hashFNV64(hash, buffer[i]);
+
+	stream.seek(0);
+
+	return hash;
+}
+
+
+/** Parse a table in the background. */
+class TwoDARegistry::PreloadJob : public Common::Job {
+public:
+	enum Type {
+		kType2DA,
+		kTypeGDA,
+		kTypeMGDA
+	};
+
+	PreloadJob(TwoDARegistry &registry, Type type, const Common::UString &name) :
+		_registry(&registry), _type(type), _name(name) {
+	}
+
+	~PreloadJob() {
+	}
+
+	Type getType() const {
+		return _type;
+	}
+
+	const Common::UString &getName() const {
+		return _name;
+	}
+
+	Streams &getStreams() {
+		return _streams;
+	}
+
+	void run() {
+		try {
+			if      (_type == kType2DA)
+				_twoda.reset(_registry->parse2DA(_name, *_streams[0], _source.hash));
+			else if (_type == kTypeGDA) {
+				Common::SeekableReadStream *stream = _streams[0];
+				_streams[0] = 0;
+
+				_gda.reset(new GDAFile(stream));
+			} else if (_type == kTypeMGDA)
+				_gda.reset(mergeMGDA(_streams));
+
+		} catch (Common::Exception &e) {
+			e.add("Failed preloading \"%s\"", _name.c_str());
+
+			Common::printException(e, "WARNING: ");
+		}
+
+		_registry->finishPreload(*this);
+	}
+
+private:
+	TwoDARegistry *_registry;
+
+	Type _type;
+	Common::UString _name;
+
+	Streams _streams;
+
+	Source _source;
+	Common::ScopedPtr<TwoDAFile> _twoda;
+	Common::ScopedPtr<GDAFile>   _gda;
+
+	friend class TwoDARegistry;
+};
+
+
+/** Mark a table as loading, and release the registry's mutex for the duration.
+ *
+ *  Everybody else asking for the same table waits for it to finish
+ *  loading, while other tables can be queried and loaded in parallel.
+ */
+class TwoDARegistry::PendingLoad : boost::noncopyable {
+public:
+	/** Must be called with the mutex held. */
+	PendingLoad(TwoDARegistry &registry, std::set<Common::UString> &pending, const Common::UString &name) :
+		_registry(&registry), _pending(&pending), _name(name) {
+
+		_pending->insert(_name);
+		_registry->_mutex.unlock();
+	}
+
+	~PendingLoad() {
+		_registry->_mutex.lock();
+		_pending->erase(_name);
+
+		_registry->_loaded.broadcast();
+	}
+
+private:
+	TwoDARegistry *_registry;
+
+	std::set<Common::UString> *_pending;
+	Common::UString _name;
+};
+
+
+TwoDARegistry::Source::Source() : hash(0) {
+}
+
+
+TwoDARegistry::TwoDARegistry() : _loaded(_mutex), _hashSources(false) {
 }
 
 TwoDARegistry::~TwoDARegistry() {
@@ -44,11 +172,50 @@ TwoDARegistry::~TwoDARegistry() {
 }
 
 void TwoDARegistry::clear() {
+	waitForPreload();
+
+	Common::StackLock lock(_mutex);
+
 	_twodas.clear();
 	_gdas.clear();
+
+	_sources.clear();
+}
+
+void TwoDARegistry::clearChanged() {
+	waitForPreload();
+
+	Common::StackLock lock(_mutex);
+
+	// We don't know where GDAs came from, so we can't check them
+	_gdas.clear();
+
+	/* Drop all 2DAs that would now be loaded from a different resource.
+	 * Where a resource is found is known without reading it. */
+
+	for (Sources::iterator s = _sources.begin(); s != _sources.end(); ) {
+		ResourceManager::ResourceOrigin origin;
+		if (ResMan.getResourceOrigin(s->first, kFileType2DA, origin) && (origin == s->second.origin)) {
+			++s;
+			continue;
+		}
+
+		_twodas.erase(s->first);
+		_sources.erase(s++);
+	}
+}
+
+void TwoDARegistry::waitForPending(const std::set<Common::UString> &pending, const Common::UString &name) {
+	// Must be called with the mutex held. Waiting on the condition releases it
+	while (pending.find(name) != pending.end())
+		_loaded.wait();
 }
 
 const TwoDAFile &TwoDARegistry::get2DA(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pending2DAs, name);
+
 	TwoDAMap::const_iterator twoda = _twodas.find(name);
 	if (twoda != _twodas.end())
 		// Entry exists => return
@@ -56,15 +223,27 @@ const TwoDAFile &TwoDARegistry::get2DA(const Common::UString &name) {
 
 	// Entry doesn't exist => load and add
 
-	TwoDAFile *newTwoDA = load2DA(name);
+	Source source;
+	TwoDAFile *newTwoDA = 0;
+	{
+		PendingLoad loading(*this, _pending2DAs, name);
+
+		newTwoDA = load2DA(name, source);
+	}
 
 	std::pair<TwoDAMap::iterator, bool> result;
 	result = _twodas.insert(std::make_pair(name, newTwoDA));
 
+	_sources[name] = source;
+
 	return *result.first->second;
 }
 
 const GDAFile &TwoDARegistry::getGDA(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pendingGDAs, name);
+
 	GDAMap::const_iterator gda = _gdas.find(name);
 	if (gda != _gdas.end())
 		// Entry exists => return
@@ -72,7 +251,12 @@ const GDAFile &TwoDARegistry::getGDA(const Common::UString &name) {
 
 	// Entry doesn't exist => load and add
 
-	GDAFile *newGDA = loadGDA(name);
+	GDAFile *newGDA = 0;
+	{
+		PendingLoad loading(*this, _pendingGDAs, name);
+
+		newGDA = loadGDA(name);
+	}
 
 	std::pair<GDAMap::iterator, bool> result;
 	result = _gdas.insert(std::make_pair(name, newGDA));
@@ -81,6 +265,10 @@ const GDAFile &TwoDARegistry::getGDA(const Common::UString &name) {
 }
 
 const GDAFile &TwoDARegistry::getMGDA(const Common::UString &prefix) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pendingGDAs, prefix);
+
 	GDAMap::const_iterator gda = _gdas.find(prefix);
 	if (gda != _gdas.end())
 		// Entry exists => return
@@ -88,7 +276,12 @@ const GDAFile &TwoDARegistry::getMGDA(const Common::UString &prefix) {
 
 	// Entry doesn't exist => load and add
 
-	GDAFile *newGDA = loadMGDA(prefix);
+	GDAFile *newGDA = 0;
+	{
+		PendingLoad loading(*this, _pendingGDAs, prefix);
+
+		newGDA = loadMGDA(prefix);
+	}
 
 	std::pair<GDAMap::iterator, bool> result;
 	result = _gdas.insert(std::make_pair(prefix, newGDA));
@@ -97,45 +290,91 @@ const GDAFile &TwoDARegistry::getMGDA(const Common::UString &prefix) {
 }
 
 void TwoDARegistry::add2DA(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pending2DAs, name);
+
 	TwoDAMap::iterator twoda = _twodas.find(name);
 	if (twoda != _twodas.end())
 		// Entry exists => remove first
 		_twodas.erase(twoda);
 
+	_sources.erase(name);
+
 	// Load and add
-	_twodas[name] = load2DA(name);
+	Source source;
+	TwoDAFile *newTwoDA = 0;
+	{
+		PendingLoad loading(*this, _pending2DAs, name);
+
+		newTwoDA = load2DA(name, source);
+	}
+
+	_twodas[name] = newTwoDA;
+	_sources[name] = source;
 }
 
 void TwoDARegistry::remove2DA(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pending2DAs, name);
+
 	TwoDAMap::iterator twoda = _twodas.find(name);
 	if (twoda == _twodas.end())
 		// Doesn't exist, nothing to do
 		return;
 
 	_twodas.erase(twoda);
+	_sources.erase(name);
 }
 
 void TwoDARegistry::addGDA(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pendingGDAs, name);
+
 	GDAMap::iterator gda = _gdas.find(name);
 	if (gda != _gdas.end())
 		// Entry exists => remove first
 		_gdas.erase(gda);
 
 	// Load and add
-	_gdas[name] = loadGDA(name);
+	GDAFile *newGDA = 0;
+	{
+		PendingLoad loading(*this, _pendingGDAs, name);
+
+		newGDA = loadGDA(name);
+	}
+
+	_gdas[name] = newGDA;
 }
 
 void TwoDARegistry::addMGDA(const Common::UString &prefix) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pendingGDAs, prefix);
+
 	GDAMap::iterator gda = _gdas.find(prefix);
 	if (gda != _gdas.end())
 		// Entry exists => remove first
 		_gdas.erase(gda);
 
 	// Load and add
-	_gdas[prefix] = loadMGDA(prefix);
+	GDAFile *newGDA = 0;
+	{
+		PendingLoad loading(*this, _pendingGDAs, prefix);
+
+		newGDA = loadMGDA(prefix);
+	}
+
+	_gdas[prefix] = newGDA;
 }
 
 void TwoDARegistry::removeGDA(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	waitForPending(_pendingGDAs, name);
+
 	GDAMap::iterator gda = _gdas.find(name);
 	if (gda == _gdas.end())
 		// Doesn't exist, nothing to do
@@ -144,16 +383,303 @@ void TwoDARegistry::removeGDA(const Common::UString &name) {
 	_gdas.erase(gda);
 }
 
-TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name) {
+void TwoDARegistry::preload(const std::vector<Common::UString> &twoDAs,
+                            const std::vector<Common::UString> &gdas,
+                            const std::vector<Common::UString> &mgdas) {
+
+	Common::StackLock lock(_mutex);
+
+	/* Reading the resources themselves has to happen here, since the
+	 * ResourceManager is not thread-safe. Only the parsing is done by
+	 * the worker threads. */
+
+	for (std::vector<Common::UString>::const_iterator t = twoDAs.begin(); t != twoDAs.end(); ++t) {
+		if ((_twodas.find(*t) != _twodas.end()) || (_pending2DAs.find(*t) != _pending2DAs.end()))
+			continue;
+
+		Common::ScopedPtr<PreloadJob> job(new PreloadJob(*this, PreloadJob::kType2DA, *t));
+
+		try {
+			ResMan.getResourceOrigin(*t, kFileType2DA, job->_source.origin);
+
+			job->getStreams().push_back(ResMan.getResource(*t, kFileType2DA));
+			if (!job->getStreams().back())
+				throw Common::Exception("No such 2DA");
+
+		} catch (Common::Exception &e) {
+			e.add("Failed preloading 2DA \"%s\"", t->c_str());
+
+			Common::printException(e, "WARNING: ");
+			continue;
+		}
+
+		_pending2DAs.insert(*t);
+		_preloadJobs.push_back(job.release());
+		ThreadPoolMan.addJob(*_preloadJobs.back(), _preloadGroup);
+	}
+
+	for (std::vector<Common::UString>::const_iterator g = gdas.begin(); g != gdas.end(); ++g) {
+		if ((_gdas.find(*g) != _gdas.end()) || (_pendingGDAs.find(*g) != _pendingGDAs.end()))
+			continue;
+
+		Common::ScopedPtr<PreloadJob> job(new PreloadJob(*this, PreloadJob::kTypeGDA, *g));
+
+		try {
+			job->getStreams().push_back(ResMan.getResource(*g, kFileTypeGDA));
+			if (!job->getStreams().back())
+				throw Common::Exception("No such GDA");
+
+		} catch (Common::Exception &e) {
+			e.add("Failed preloading GDA \"%s\"", g->c_str());
+
+			Common::printException(e, "WARNING: ");
+			continue;
+		}
+
+		_pendingGDAs.insert(*g);
+		_preloadJobs.push_back(job.release());
+		ThreadPoolMan.addJob(*_preloadJobs.back(), _preloadGroup);
+	}
+
+	for (std::vector<Common::UString>::const_iterator m = mgdas.begin(); m != mgdas.end(); ++m) {
+		if ((_gdas.find(*m) != _gdas.end()) || (_pendingGDAs.find(*m) != _pendingGDAs.end()))
+			continue;
+
+		Common::ScopedPtr<PreloadJob> job(new PreloadJob(*this, PreloadJob::kTypeMGDA, *m));
+
+		try {
+			getMGDAStreams(*m, job->getStreams());
+
+		} catch (Common::Exception &e) {
+			e.add("Failed preloading multiple GDA \"%s\"", m->c_str());
+
+			Common::printException(e, "WARNING: ");
+			continue;
+		}
+
+		_pendingGDAs.insert(*m);
+		_preloadJobs.push_back(job.release());
+		ThreadPoolMan.addJob(*_preloadJobs.back(), _preloadGroup);
+	}
+}
+
+void TwoDARegistry::waitForPreload() {
+	// Don't hold the mutex while waiting, the jobs need it to finish
+	ThreadPoolMan.wait(_preloadGroup);
+
+	Common::StackLock lock(_mutex);
+
+	// Somebody might have queued new jobs while we were waiting
+	if (_preloadGroup.isDone())
+		_preloadJobs.clear();
+}
+
+void TwoDARegistry::finishPreload(PreloadJob &job) {
+	Common::StackLock lock(_mutex);
+
+	if (job.getType() == PreloadJob::kType2DA) {
+		// If the 2DA was not replaced in the meantime, add it
+		if (job._twoda && (_twodas.find(job.getName()) == _twodas.end())) {
+			_twodas.insert(std::make_pair(job.getName(), job._twoda.release()));
+			_sources[job.getName()] = job._source;
+		}
+
+		_pending2DAs.erase(job.getName());
+
+	} else {
+		if (job._gda && (_gdas.find(job.getName()) == _gdas.end()))
+			_gdas.insert(std::make_pair(job.getName(), job._gda.release()));
+
+		_pendingGDAs.erase(job.getName());
+	}
+
+	/* If the job failed, nothing was added. Whoever waits on that table
+	 * will then try to load it themselves and get the proper exception. */
+
+	_loaded.broadcast();
+}
+
+bool TwoDARegistry::loadSnapshot(const Common::UString &fileName) {
+	{
+		Common::StackLock lock(_mutex);
+
+		// Even without a snapshot to read, the sources need hashes to write one later
+		_hashSources = true;
+	}
+
+	Common::ScopedPtr<Common::SeekableReadStream> snapshot;
+	SnapshotEntries entries;
+
+	try {
+		Common::ReadFile file;
+		if (!file.open(fileName))
+			return false;
+
+		snapshot.reset(file.readStream(file.size()));
+
+		if ((snapshot->readUint32BE() != kSnapshotID) || (snapshot->readUint32LE() != kSnapshotVersion))
+			throw Common::Exception("Not a 2DA snapshot");
+
+		const size_t count = snapshot->readUint32LE();
+		for (size_t i = 0; i < count; i++) {
+			const Common::UString name = Common::readString(*snapshot, Common::kEncodingUTF8);
+
+			SnapshotEntry entry;
+
+			entry.hash   = snapshot->readUint64LE();
+			entry.size   = snapshot->readUint32LE();
+			entry.offset = snapshot->pos();
+
+			if ((entry.offset + entry.size) > snapshot->size())
+				throw Common::Exception(Common::kReadError);
+
+			snapshot->skip(entry.size);
+
+			entries[name] = entry;
+		}
+
+	} catch (Common::Exception &e) {
+		e.add("Failed loading 2DA snapshot \"%s\"", fileName.c_str());
+
+		Common::printException(e, "WARNING: ");
+		return false;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	_snapshot.reset(snapshot.release());
+	_snapshotEntries.swap(entries);
+
+	return true;
+}
+
+bool TwoDARegistry::saveSnapshot(const Common::UString &fileName) {
+	Common::StackLock lock(_mutex);
+
+	/* Write all 2DAs we currently have loaded, plus all entries of the
+	 * old snapshot we haven't touched in this run, so that a snapshot
+	 * doesn't lose the 2DAs of areas we didn't visit this time. */
+
+	Common::MemoryWriteStreamDynamic data(true);
+	uint32 count = 0;
+
+	try {
+		for (TwoDAMap::const_iterator t = _twodas.begin(); t != _twodas.end(); ++t) {
+			// Without a hash, the 2DA can't be matched against its source later
+			Sources::const_iterator source = _sources.find(t->first);
+			if ((source == _sources.end()) || (source->second.hash == 0))
+				continue;
+
+			Common::MemoryWriteStreamDynamic twoda(true);
+			t->second->writeSnapshot(twoda);
+
+			Common::writeString(data, t->first, Common::kEncodingUTF8, true);
+			data.writeUint64LE(source->second.hash);
+			data.writeUint32LE((uint32) twoda.size());
+			data.write(twoda.getData(), twoda.size());
+
+			count++;
+		}
+
+		if (_snapshot) {
+			for (SnapshotEntries::const_iterator e = _snapshotEntries.begin(); e != _snapshotEntries.end(); ++e) {
+				if (_twodas.find(e->first) != _twodas.end())
+					continue;
+
+				Common::ScopedArray<byte> twoda(new byte[e->second.size]);
+
+				_snapshot->seek(e->second.offset);
+				if (_snapshot->read(twoda.get(), e->second.size) != e->second.size)
+					throw Common::Exception(Common::kReadError);
+
+				Common::writeString(data, e->first, Common::kEncodingUTF8, true);
+				data.writeUint64LE(e->second.hash);
+				data.writeUint32LE((uint32) e->second.size);
+				data.write(twoda.get(), e->second.size);
+
+				count++;
+			}
+		}
+
+		Common::WriteFile file;
+		if (!file.open(fileName))
+			throw Common::Exception(Common::kOpenError);
+
+		file.writeUint32BE(kSnapshotID);
+		file.writeUint32LE(kSnapshotVersion);
+		file.writeUint32LE(count);
+		file.write(data.getData(), data.size());
+
+		file.flush();
+		file.close();
+
+	} catch (Common::Exception &e) {
+		e.add("Failed saving 2DA snapshot \"%s\"", fileName.c_str());
+
+		Common::printException(e, "WARNING: ");
+		return false;
+	}
+
+	return true;
+}
+
+Common::SeekableReadStream *TwoDARegistry::getSnapshot(const Common::UString &name, uint64 hash) {
+	Common::StackLock lock(_mutex);
+
+	if (!_snapshot)
+		return 0;
+
+	SnapshotEntries::const_iterator entry = _snapshotEntries.find(name);
+	if ((entry == _snapshotEntries.end()) || (entry->second.hash != hash))
+		return 0;
+
+	_snapshot->seek(entry->second.offset);
+
+	return _snapshot->readStream(entry->second.size);
+}
+
+TwoDAFile *TwoDARegistry::parse2DA(const Common::UString &name, Common::SeekableReadStream &stream,
+                                   uint64 &hash) {
+
+	hash = 0;
+
+	bool hashSources;
+	{
+		Common::StackLock lock(_mutex);
+
+		hashSources = _hashSources;
+	}
+
+	// Without snapshots, there's no need to read the whole 2DA one extra time
+	if (!hashSources)
+		return new TwoDAFile(stream);
+
+	hash = hashStream(stream);
+
+	Common::ScopedPtr<Common::SeekableReadStream> snapshot(getSnapshot(name, hash));
+	if (snapshot) {
+		try {
+			return TwoDAFile::readSnapshot(*snapshot);
+		} catch (...) {
+			// Broken snapshot entry. Ignore it and parse the original 2DA
+		}
+	}
+
+	return new TwoDAFile(stream);
+}
+
+TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name, Source &source) {
 	Common::ScopedPtr<Common::SeekableReadStream> twodaFile;
 	Common::ScopedPtr<TwoDAFile> twoda;
 
 	try {
+		ResMan.getResourceOrigin(name, kFileType2DA, source.origin);
+
 		twodaFile.reset(ResMan.getResource(name, kFileType2DA));
 		if (!twodaFile)
 			throw Common::Exception("No such 2DA");
 
-		twoda.reset(new TwoDAFile(*twodaFile));
+		twoda.reset(parse2DA(name, *twodaFile, source.hash));
 
 	} catch (Common::Exception &e) {
 		e.add("Failed loading 2DA \"%s\"", name.c_str());
@@ -185,6 +711,19 @@ GDAFile *TwoDARegistry::loadGDA(const Common::UString &name) {
 GDAFile *TwoDARegistry::loadMGDA(Common::UString prefix) {
 	/* Load multiple GDAs with the same prefix, and merge them together into a single GDA. */
 
+	try {
+		Streams streams;
+		getMGDAStreams(prefix, streams);
+
+		return mergeMGDA(streams);
+
+	} catch (Common::Exception &e) {
+		e.add("Failed loading multiple GDA \"%s\"", prefix.c_str());
+		throw;
+	}
+}
+
+void TwoDARegistry::getMGDAStreams(Common::UString prefix, Streams &streams) {
 	if (prefix.empty())
 		throw Common::Exception("Trying to load MGDA \"\"");
 
@@ -193,35 +732,37 @@ GDAFile *TwoDARegistry::loadMGDA(Common::UString prefix) {
 	std::list<ResourceManager::ResourceID> gdas;
 	ResMan.getAvailableResources(kFileTypeGDA, gdas);
 
-	Common::ScopedPtr<GDAFile> gda;
+	for (std::list<ResourceManager::ResourceID>::const_iterator g = gdas.begin(); g != gdas.end(); ++g) {
+		// Find all GDAs that match the prefix
+		if (!g->name.toLower().beginsWith(prefix))
+			continue;
 
-	try {
-		for (std::list<ResourceManager::ResourceID>::const_iterator g = gdas.begin(); g != gdas.end(); ++g) {
-			// Find all GDAs that match the prefix
-			if (!g->name.toLower().beginsWith(prefix))
-				continue;
+		streams.push_back(ResMan.getResource(g->name, kFileTypeGDA));
+		if (!streams.back())
+			throw Common::Exception("No such GDA \"%s\"", g->name.c_str());
+	}
 
-			// Load the GDA
+	if (streams.empty())
+		throw Common::Exception("No such GDA");
+}
 
-			Common::ScopedPtr<Common::SeekableReadStream> stream(ResMan.getResource(g->name, kFileTypeGDA));
-			if (!stream)
-				throw Common::Exception("No such GDA \"%s\"", g->name.c_str());
+GDAFile *TwoDARegistry::mergeMGDA(Streams &streams) {
+	Common::ScopedPtr<GDAFile> gda;
 
-			// If this is the first GDA, plain load it. Otherwise, merge it into the first one
-			if (!gda)
-				gda.reset(new GDAFile(stream.release()));
-			else
-				gda->add(stream.release());
-		}
+	for (Streams::iterator s = streams.begin(); s != streams.end(); ++s) {
+		Common::SeekableReadStream *stream = *s;
+		*s = 0;
 
+		// If this is the first GDA, plain load it. Otherwise, merge it into the first one
 		if (!gda)
-			throw Common::Exception("No such GDA");
-
-	} catch (Common::Exception &e) {
-		e.add("Failed loading multiple GDA \"%s\"", prefix.c_str());
-		throw;
+			gda.reset(new GDAFile(stream));
+		else
+			gda->add(stream);
 	}
 
+	if (!gda)
+		throw Common::Exception("No such GDA");
+
 	return gda.release();
 }
 
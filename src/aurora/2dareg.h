@@ -25,9 +25,24 @@
 #ifndef AURORA_2DAREG_H
 #define AURORA_2DAREG_H
 
+#include <vector>
+#include <map>
+#include <set>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
 #include "src/common/ptrmap.h"
+#include "src/common/ptrvector.h"
+#include "src/common/mutex.h"
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
+#include "src/common/threadpool.h"
+
+#include "src/aurora/resman.h"
+
+namespace Common {
+	class SeekableReadStream;
+}
 
 namespace Aurora {
 
@@ -44,6 +59,9 @@ class GDAFile;
  *  method is called, which should be done in a moment appropriate for
  *  the game. Most likely, this moment is the unloading of a module
  *  or campaign, when the context of the current 2DAs/GDAs expires.
+ *  When the resources change only partially, for example because a
+ *  module brought its own HAKs, clearChanged() only drops those 2DAs
+ *  that now would be loaded from a different source.
  *
  *  TwoDARegistry can also be used to load a so-called MGDA, a concat-
  *  enation of multiple GDA files with the same prefix. This is used
@@ -54,6 +72,20 @@ class GDAFile;
  *
  *  All 2DA and GDA files are directly and automatically loaded from
  *  the ResourceManager.
+ *
+ *  To avoid stalling the first time a table is needed, engines can
+ *  declare a list of tables they will need with preload(). These are
+ *  then parsed in parallel by the shared pool of worker threads. While
+ *  this is happening, the registry can still be safely queried: asking
+ *  for a table that is currently being (pre)loaded waits for it to
+ *  finish, and all other tables are loaded as usual.
+ *
+ *  Additionally, the parsed 2DAs can be written into a snapshot file
+ *  with saveSnapshot(). When that snapshot is read back in with
+ *  loadSnapshot() in a later run, 2DAs whose source resource still
+ *  has the same hash are taken from the snapshot instead of being
+ *  parsed again. The source resources are only hashed once
+ *  loadSnapshot() has been called.
  */
 class TwoDARegistry : public Common::Singleton<TwoDARegistry> {
 public:
@@ -61,6 +93,8 @@ public:
 	~TwoDARegistry();
 
 	void clear();
+	/** Remove all 2DAs whose source resource changed since they were loaded, and all GDAs. */
+	void clearChanged();
 
 	/** Get a certain 2DA, loading it if necessary. */
 	const TwoDAFile &get2DA(const Common::UString &name);
@@ -83,16 +117,88 @@ public:
 	/** Remove a certain GDA from the registry. */
 	void removeGDA(const Common::UString &name);
 
+	/** Load these 2DAs, GDAs and multiple GDAs in the background.
+	 *
+	 *  The resources are read on the calling thread, but parsing them
+	 *  happens in parallel on worker threads. Tables that are already
+	 *  loaded or preloading are skipped.
+	 */
+	void preload(const std::vector<Common::UString> &twoDAs,
+	             const std::vector<Common::UString> &gdas  = std::vector<Common::UString>(),
+	             const std::vector<Common::UString> &mgdas = std::vector<Common::UString>());
+
+	/** Wait for all tables currently preloading to finish. */
+	void waitForPreload();
+
+	/** Read a snapshot of parsed 2DAs, to be used instead of parsing them again.
+	 *
+	 *  This also starts hashing the source of every 2DA loaded from now on,
+	 *  which saveSnapshot() needs, even if there is no snapshot to read yet.
+	 */
+	bool loadSnapshot(const Common::UString &fileName);
+	/** Write all loaded 2DAs, and still-valid snapshot entries, into a snapshot file. */
+	bool saveSnapshot(const Common::UString &fileName);
+
 private:
+	class PreloadJob;
+	class PendingLoad;
+
 	typedef Common::PtrMap<Common::UString, TwoDAFile> TwoDAMap;
 	typedef Common::PtrMap<Common::UString, GDAFile> GDAMap;
 
+	typedef Common::PtrVector<Common::SeekableReadStream> Streams;
+
+	/** A 2DA within the snapshot data. */
+	struct SnapshotEntry {
+		uint64 hash;   ///< Hash of the 2DA source resource.
+		size_t offset; ///< Offset of the snapshot 2DA data.
+		size_t size;   ///< Size of the snapshot 2DA data.
+	};
+
+	/** Where a loaded 2DA came from. */
+	struct Source {
+		ResourceManager::ResourceOrigin origin; ///< The resource the 2DA was parsed from.
+		uint64 hash; ///< Hash of that resource, or 0 if it wasn't hashed.
+
+		Source();
+	};
+
+	typedef std::map<Common::UString, SnapshotEntry> SnapshotEntries;
+	typedef std::map<Common::UString, Source> Sources;
+
+	/** Protects everything. Not held while a table is loaded. */
+	Common::Mutex     _mutex;
+	/** Signals that a loading or preloading table has finished. */
+	Common::Condition _loaded;
+
 	TwoDAMap _twodas;
 	GDAMap   _gdas;
 
-	TwoDAFile *load2DA(const Common::UString &name);
+	Sources _sources; ///< The sources of all loaded 2DAs.
+	bool _hashSources; ///< Should the 2DA sources be hashed, for the snapshots?
+
+	std::set<Common::UString> _pending2DAs; ///< 2DAs currently loading or preloading.
+	std::set<Common::UString> _pendingGDAs; ///< GDAs and MGDAs currently loading or preloading.
+
+	Common::JobGroup              _preloadGroup;
+	Common::PtrVector<PreloadJob> _preloadJobs;
+
+	Common::ScopedPtr<Common::SeekableReadStream> _snapshot;
+	SnapshotEntries _snapshotEntries;
+
+	void waitForPending(const std::set<Common::UString> &pending, const Common::UString &name);
+	void finishPreload(PreloadJob &job);
+
+	Common::SeekableReadStream *getSnapshot(const Common::UString &name, uint64 hash);
+
+	TwoDAFile *load2DA(const Common::UString &name, Source &source);
 	GDAFile   *loadGDA(const Common::UString &name);
 	GDAFile   *loadMGDA(Common::UString prefix);
+
+	TwoDAFile *parse2DA(const Common::UString &name, Common::SeekableReadStream &stream, uint64 &hash);
+
+	static void getMGDAStreams(Common::UString prefix, Streams &streams);
+	static GDAFile *mergeMGDA(Streams &streams);
 };
 
 } // End of namespace Aurora
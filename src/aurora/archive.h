@@ -65,6 +65,9 @@ public:
 	/** Return the size of a resource. */
 	virtual uint32 getResourceSize(uint32 index) const;
 
+	/** Is this resource stored compressed or encrypted, i.e. expensive to unpack? */
+	virtual bool isResourcePacked(uint32 index) const;
+
 	/** Return a stream of the resource's contents.
 	 *
 	 *  @param  index The index of the resource we want.
@@ -42,7 +42,7 @@ static const uint32 kVersion11 = MKTAG('V', '1', '.', '1');
 
 namespace Aurora {
 
-BIFFile::BIFFile(Common::SeekableReadStream *bif) : _bif(bif) {
+BIFFile::BIFFile(Common::SeekableReadStream *bif) : _bif(Common::SeekableStreamView::wrap(bif)) {
 	assert(_bif);
 
 	load(*_bif);
@@ -142,11 +142,9 @@ Common::SeekableReadStream *BIFFile::getResource(uint32 index, bool tryNoCopy) c
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_bif.get(), res.offset, res.offset + res.size);
+		return _bif->createView(res.offset, res.offset + res.size);
 
-	_bif->seek(res.offset);
-
-	return _bif->readStream(res.size);
+	return _bif->copyRange(res.offset, res.offset + res.size);
 }
 
 } // End of namespace Aurora
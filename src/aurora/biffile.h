@@ -29,6 +29,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/streamview.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/archive.h"
@@ -104,7 +105,7 @@ private:
 
 	typedef std::vector<IResource> IResourceList;
 
-	Common::ScopedPtr<Common::SeekableReadStream> _bif;
+	Common::ScopedPtr<Common::SeekableStreamView> _bif;
 
 	/** External list of resource names and types. */
 	ResourceList _resources;
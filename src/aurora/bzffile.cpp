@@ -143,6 +143,10 @@ uint32 BZFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool BZFFile::isResourcePacked(uint32 UNUSED(index)) const {
+	return true;
+}
+
 Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
@@ -55,6 +55,9 @@ namespace Aurora {
 
 static const size_t kNWNPremiumKeyLength = 56;
 
+/** Size of the encrypted part of the header of a NWN premium module that identifies the key. */
+static const size_t kNWNPremiumHeaderSize = 152;
+
 static const byte kNWNPremiumKeys[][kNWNPremiumKeyLength] = {
 	{
 		0x8A, 0x83, 0x5A, 0x2D, 0x01, 0x10, 0x5C, 0xBE, 0xCE, 0x2C, 0xD0, 0x69, 0xB8, 0x48, 0xC9, 0xBE,
@@ -147,7 +150,7 @@ bool ERFFile::ERFHeader::isSensible(size_t fileSize) {
 
 
 ERFFile::ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &password) :
-	_erf(erf), _password(password) {
+	_erf(Common::SeekableStreamView::wrap(erf)), _password(password), _decryptedOnRead(false) {
 
 	assert(_erf);
 
@@ -225,7 +228,7 @@ bool ERFFile::decryptNWNPremiumHeader(Common::SeekableReadStream &erf, ERFHeader
                                       const std::vector<byte> &password) {
 
 	Common::ScopedPtr<Common::SeekableReadStream>
-		decryptERF(decrypt(erf, erf.pos(), 152, kEncryptionBlowfishNWN, password));
+		decryptERF(decrypt(erf, erf.pos(), kNWNPremiumHeaderSize, kEncryptionBlowfishNWN, password));
 
 	readV11Header(*decryptERF, header);
 
@@ -301,11 +304,12 @@ void ERFFile::load() {
 void ERFFile::decryptNWNPremium() {
 	assert(_header.encryption == kEncryptionBlowfishNWN);
 
-	_erf->seek(0);
-
-	_erf.reset(decrypt(*_erf, kEncryptionBlowfishNWN, _password));
+	/* Premium modules are big, so instead of decrypting them completely,
+	 * we only decrypt the blocks we actually read from, when we read them. */
+	_erf.reset(Common::SeekableStreamView::wrap(new Common::BlowfishEBCReadStream(_erf.release(), _password)));
 
 	_header.encryption = kEncryptionNone;
+	_decryptedOnRead   = true;
 }
 
 void ERFFile::readV10Header(Common::SeekableReadStream &erf, ERFHeader &header) {
@@ -659,16 +663,24 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).unpackedSize;
 }
 
+bool ERFFile::isResourcePacked(uint32 index) const {
+	// Reading a resource of an ERF that's decrypted on the fly is as costly as unpacking it
+	if ((_header.encryption != kEncryptionNone) || _decryptedOnRead)
+		return true;
+
+	const IResource &res = getIResource(index);
+
+	return (_header.compression != kCompressionNone) && (res.packedSize != res.unpackedSize);
+}
+
 Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy && (_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
-		return new Common::SeekableSubReadStream(_erf.get(), res.offset, res.offset + res.packedSize);
-
-	_erf->seek(res.offset);
+		return _erf->createView(res.offset, res.offset + res.packedSize);
 
 	// Read
-	Common::MemoryReadStream *stream = _erf->readStream(res.packedSize);
+	Common::MemoryReadStream *stream = _erf->copyRange(res.offset, res.offset + res.packedSize);
 
 	// Decrypt
 	if (_header.encryption != kEncryptionNone)
@@ -29,6 +29,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/streamview.h"
 #include "src/common/ustring.h"
 
 #include "src/aurora/types.h"
@@ -121,6 +122,9 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Is this resource stored compressed or encrypted? */
+	bool isResourcePacked(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
@@ -200,7 +204,7 @@ private:
 
 	typedef std::vector<IResource> IResourceList;
 
-	Common::ScopedPtr<Common::SeekableReadStream> _erf;
+	Common::ScopedPtr<Common::SeekableStreamView> _erf;
 
 	ERFHeader _header;
 
@@ -216,6 +220,9 @@ private:
 	/** The password we were given, if any. */
 	std::vector<byte> _password;
 
+	/** Is the whole ERF decrypted on the fly, while reading from it? */
+	bool _decryptedOnRead;
+
 	void load();
 
 	// .--- Header
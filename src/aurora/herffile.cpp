@@ -36,7 +36,9 @@
 
 namespace Aurora {
 
-HERFFile::HERFFile(Common::SeekableReadStream *herf) : _herf(herf), _dictOffset(0xFFFFFFFF), _dictSize(0) {
+HERFFile::HERFFile(Common::SeekableReadStream *herf) :
+	_herf(Common::SeekableStreamView::wrap(herf)), _dictOffset(0xFFFFFFFF), _dictSize(0) {
+
 	assert(_herf);
 
 	load(*_herf);
@@ -160,11 +162,9 @@ Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool tryNoCopy)
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_herf.get(), res.offset, res.offset + res.size);
-
-	_herf->seek(res.offset);
+		return _herf->createView(res.offset, res.offset + res.size);
 
-	return _herf->readStream(res.size);
+	return _herf->copyRange(res.offset, res.offset + res.size);
 }
 
 Common::HashAlgo HERFFile::getNameHashAlgo() const {
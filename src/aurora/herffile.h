@@ -30,6 +30,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/streamview.h"
 #include "src/common/ustring.h"
 
 #include "src/aurora/types.h"
@@ -77,7 +78,7 @@ private:
 
 	typedef std::vector<IResource> IResourceList;
 
-	Common::ScopedPtr<Common::SeekableReadStream> _herf;
+	Common::ScopedPtr<Common::SeekableStreamView> _herf;
 
 	/** External list of resource names and types. */
 	ResourceList _resources;
@@ -39,12 +39,12 @@
 namespace Aurora {
 
 NDSFile::NDSFile(const Common::UString &fileName) {
-	_nds.reset(new Common::ReadFile(fileName));
+	_nds.reset(Common::SeekableStreamView::wrap(new Common::ReadFile(fileName)));
 
 	load(*_nds);
 }
 
-NDSFile::NDSFile(Common::SeekableReadStream *nds) : _nds(nds) {
+NDSFile::NDSFile(Common::SeekableReadStream *nds) : _nds(Common::SeekableStreamView::wrap(nds)) {
 	assert(_nds);
 
 	load(*_nds);
@@ -166,14 +166,10 @@ uint32 NDSFile::getResourceSize(uint32 index) const {
 Common::SeekableReadStream *NDSFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
-	_nds->seek(res.offset);
-
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_nds.get(), res.offset, res.offset + res.size);
-
-	_nds->seek(res.offset);
+		return _nds->createView(res.offset, res.offset + res.size);
 
-	return _nds->readStream(res.size);
+	return _nds->copyRange(res.offset, res.offset + res.size);
 }
 
 } // End of namespace Aurora
@@ -29,6 +29,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/streamview.h"
 #include "src/common/ustring.h"
 
 #include "src/aurora/types.h"
@@ -82,7 +83,7 @@ private:
 
 	typedef std::vector<IResource> IResourceList;
 
-	Common::ScopedPtr<Common::SeekableReadStream> _nds;
+	Common::ScopedPtr<Common::SeekableStreamView> _nds;
 
 	Common::UString _title;
 	Common::UString _code;
@@ -140,11 +140,11 @@ const Variable &FunctionContext::getReturn() const {
 	return _return;
 }
 
-Parameters &FunctionContext::getParams() {
+const Parameters &FunctionContext::getParams() const {
 	return _parameters;
 }
 
-const Parameters &FunctionContext::getParams() const {
+Parameters &FunctionContext::getWritableParams() {
 	return _parameters;
 }
 
@@ -68,8 +68,10 @@ public:
 	Variable &getReturn();
 	const Variable &getReturn() const;
 
-	Parameters &getParams();
+	/** Return the parameters, for the engine function to read. */
 	const Parameters &getParams() const;
+	/** Return the parameters, for filling them in before calling the engine function. */
+	Parameters &getWritableParams();
 
 	void setCurrentScript(NCSFile *script = 0);
 	NCSFile *getCurrentScript() const;
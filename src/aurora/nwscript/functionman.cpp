@@ -27,6 +27,7 @@
 #include "src/common/debug.h"
 
 #include "src/aurora/nwscript/functionman.h"
+#include "src/aurora/nwscript/profiler.h"
 
 DECLARE_SINGLETON(Aurora::NWScript::FunctionManager)
 
@@ -35,7 +36,7 @@ namespace Aurora {
 namespace NWScript {
 
 FunctionManager::FunctionEntry::FunctionEntry(const Common::UString &name) :
-	empty(true), ctx(name) {
+	empty(true), id(0xFFFFFFFF), ctx(name) {
 }
 
 
@@ -73,6 +74,7 @@ void FunctionManager::registerFunction(const Common::UString &name, uint32 id,
 	f.ctx.setSignature(signature);
 	f.ctx.setDefaults(defaults);
 	f.empty = false;
+	f.id    = id;
 
 	if (_functionArray.size() <= id)
 		_functionArray.resize(id + 1);
@@ -85,17 +87,7 @@ FunctionContext FunctionManager::createContext(const Common::UString &function)
 }
 
 void FunctionManager::call(const Common::UString &function, FunctionContext &ctx) const {
-	debugCN(Common::kDebugEngineScripts, 5, "%s %s(%s)", formatType(ctx.getReturn().getType()).c_str(),
-	        ctx.getName().c_str(), formatParams(ctx).c_str());
-
-	find(function).func(ctx);
-
-	const Common::UString r = formatReturn(ctx);
-	debugC(Common::kDebugEngineScripts, 5, "%s%s", r.empty() ? "" : " => ", r.c_str());
-
-	if (DebugMan.getVerbosityLevel(Common::kDebugEngineScripts) < 5)
-		debugC(Common::kDebugEngineScripts, 2, "%s %s(%s)%s%s", formatType(ctx.getReturn().getType()).c_str(),
-		       ctx.getName().c_str(), formatParams(ctx).c_str(), r.empty() ? "" : " => ", r.c_str());
+	call(find(function), ctx);
 }
 
 FunctionContext FunctionManager::createContext(uint32 function) const {
@@ -103,10 +95,21 @@ FunctionContext FunctionManager::createContext(uint32 function) const {
 }
 
 void FunctionManager::call(uint32 function, FunctionContext &ctx) const {
+	call(find(function), ctx);
+}
+
+void FunctionManager::call(const FunctionEntry &function, FunctionContext &ctx) {
 	debugCN(Common::kDebugEngineScripts, 5, "%s %s(%s)", formatType(ctx.getReturn().getType()).c_str(),
 	        ctx.getName().c_str(), formatParams(ctx).c_str());
 
-	find(function).func(ctx);
+	if (ScriptProf.isEnabled()) {
+		const uint64 start = ScriptProfiler::getTicks();
+
+		function.func(ctx);
+
+		ScriptProf.addFunctionCall(function.id, ctx.getName(), ScriptProfiler::getTicks() - start);
+	} else
+		function.func(ctx);
 
 	const Common::UString r = formatReturn(ctx);
 	debugC(Common::kDebugEngineScripts, 5, "%s%s", r.empty() ? "" : " => ", r.c_str());
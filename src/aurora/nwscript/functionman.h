@@ -60,6 +60,7 @@ public:
 private:
 	struct FunctionEntry {
 		bool empty;
+		uint32 id;
 
 		Function func;
 		FunctionContext ctx;
@@ -75,6 +76,8 @@ private:
 
 	const FunctionEntry &find(const Common::UString &function) const;
 	const FunctionEntry &find(uint32 function) const;
+
+	static void call(const FunctionEntry &function, FunctionContext &ctx);
 };
 
 } // End of namespace NWScript
@@ -43,6 +43,7 @@
 #include "src/aurora/nwscript/ncsfile.h"
 #include "src/aurora/nwscript/object.h"
 #include "src/aurora/nwscript/functionman.h"
+#include "src/aurora/nwscript/profiler.h"
 
 using Common::kDebugScripts;
 
@@ -66,7 +67,11 @@ NCSStack::~NCSStack() {
 }
 
 void NCSStack::reset() {
-	clear();
+	/* Drop all the values, but keep the stack slots themselves around.
+	 * Strings and engine types go back into their pools, so the next
+	 * script run can reuse both the slots and the value holders. */
+	for (iterator v = begin(); v != end(); ++v)
+		v->setType(kTypeVoid);
 
 	_stackPtr = -1;
 	_basePtr  = -1;
@@ -87,7 +92,13 @@ Variable NCSStack::pop() {
 	if (_stackPtr == -1)
 		throw Common::Exception("NCSStack: Stack underflow");
 
-	return at(_stackPtr--);
+	Variable &slot = at(_stackPtr--);
+	Variable var(slot);
+
+	// Empty the slot, so that it doesn't keep sharing the value we return
+	slot.setType(kTypeVoid);
+
+	return var;
 }
 
 void NCSStack::push(const Variable &obj) {
@@ -102,6 +113,18 @@ void NCSStack::push(const Variable &obj) {
 	_stackPtr++;
 }
 
+void NCSStack::push(Type type) {
+	if (_stackPtr == 0x7FFFFFFF) // Like this will ever happen :P
+		throw Common::Exception("NCSStack: Stack overflow");
+
+	if (_stackPtr == (int32)size() - 1)
+		push_back(Variable(type));
+	else
+		at(_stackPtr + 1).setType(type);
+
+	_stackPtr++;
+}
+
 Variable &NCSStack::getRelSP(int32 pos) {
 	if ((pos > -4) || ((pos % 4) != 0))
 		throw Common::Exception("NCSStack::get(): Illegal position %d", pos);
@@ -154,8 +177,14 @@ void NCSStack::setStackPtr(int32 pos) {
 	if ((pos > 0) || ((pos % 4) != 0))
 		throw Common::Exception("NCSStack::setStackPtr(): Illegal position %d", pos);
 
+	const int32 oldStackPtr = _stackPtr;
+
 	_stackPtr = (pos / -4) - 1;
 
+	// Empty the slots dropped off the top, releasing their values
+	for (int32 i = _stackPtr + 1; (i <= oldStackPtr) && (i < (int32)size()); i++)
+		at(i).setType(kTypeVoid);
+
 	if ((int32)size() < (_stackPtr + 1))
 		resize(_stackPtr + 1);
 }
@@ -274,13 +303,17 @@ void NCSFile::setupOpcodes() {
 
 #undef OPCODE
 
-NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _script(ncs), _owner(0), _triggerer(0) {
+NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _script(ncs), _owner(0), _triggerer(0),
+	_profile(false), _instructionCount(0) {
+
 	assert(_script);
 
 	load();
 }
 
-NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _owner(0), _triggerer(0) {
+NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _owner(0), _triggerer(0),
+	_profile(false), _instructionCount(0) {
+
 	_script.reset(ResMan.getResource(ncs, kFileTypeNCS));
 	if (!_script)
 		throw Common::Exception("No such NCS \"%s\"", ncs.c_str());
@@ -377,9 +410,23 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 	_owner     = owner;
 	_triggerer = triggerer;
 
+	_profile          = ScriptProf.isEnabled();
+	_instructionCount = 0;
+
+	const uint64 startTicks  = _profile ? ScriptProfiler::getTicks() : 0;
+	const size_t startOffset = _script->pos();
+
 	while (executeStep())
 		;
 
+	if (_profile) {
+		// Scripts read from a stream have no name, so tell them apart by their size and start
+		const Common::UString profileName = !_name.empty() ? _name :
+			Common::UString::format("<stream:%u@%u>", (uint) _script->size(), (uint) startOffset);
+
+		ScriptProf.addScriptRun(profileName, ScriptProfiler::getTicks() - startTicks, _instructionCount);
+	}
+
 	if (!_stack.empty())
 		_return = _stack.top();
 
@@ -390,6 +437,9 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 	_owner     = 0;
 	_triggerer = 0;
 
+	// Release what's left on the stack until the next run
+	_stack.reset();
+
 	return _return;
 }
 
@@ -408,6 +458,11 @@ bool NCSFile::executeStep() {
 
 	debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]", _opcodes[opcode].desc, opcode);
 
+	if (_profile) {
+		ScriptProf.addOpcode(opcode, _opcodes[opcode].desc);
+		_instructionCount++;
+	}
+
 	(this->*(_opcodes[opcode].proc))((InstructionType)type);
 
 	_stack.print();
@@ -532,7 +587,7 @@ void NCSFile::callEngine(Aurora::NWScript::FunctionContext &ctx,
 	// Pop parameters
 	ctx.setParamsSpecified(argCount);
 	for (uint8 i = 0; i < argCount; i++) {
-		Variable &param = ctx.getParams()[i];
+		Variable &param = ctx.getWritableParams()[i];
 
 		Type type = param.getType();
 		if (type == kTypeAny)
@@ -1112,8 +1167,8 @@ void NCSFile::o_add(InstructionType type) {
 		}
 
 		case kInstTypeStringString: {
-			Variable op2 = _stack.pop();
-			Variable op1 = _stack.pop();
+			const Variable op2 = _stack.pop();
+			const Variable op1 = _stack.pop();
 
 			_stack.push(op1.getString() + op2.getString());
 			break;
@@ -59,6 +59,8 @@ public:
 	Variable &top();
 	Variable pop();
 	void push(const Variable &obj);
+	/** Push a new, default-initialized variable of this type. */
+	void push(Type type);
 
 	Variable &getRelSP(int32 pos);
 	void setRelSP(int32 pos, const Variable &obj);
@@ -174,6 +176,9 @@ private:
 
 	Variable _storedState;
 
+	bool   _profile;          ///< Record this run in the script profiler?
+	uint64 _instructionCount; ///< Number of instructions executed in this run.
+
 	typedef void (NCSFile::*OpcodeProc)(InstructionType type);
 	struct Opcode {
 		OpcodeProc proc;
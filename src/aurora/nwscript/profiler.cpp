@@ -0,0 +1,204 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** @file
+ *  A profiler for NWScript execution.
+ */
+
+#include <algorithm>
+
+#include <SDL_timer.h>
+
+#include "src/common/util.h"
+#include "src/common/configman.h"
+#include "src/common/writefile.h"
+
+#include "src/aurora/nwscript/profiler.h"
+
+DECLARE_SINGLETON(Aurora::NWScript::ScriptProfiler)
+
+namespace Aurora {
+
+namespace NWScript {
+
+ScriptProfiler::ScriptEntry::ScriptEntry() : runs(0), instructions(0), ticks(0) {
+}
+
+ScriptProfiler::OpcodeEntry::OpcodeEntry() : name(0), count(0) {
+}
+
+ScriptProfiler::FunctionEntry::FunctionEntry() : id(0), calls(0), ticks(0) {
+}
+
+
+ScriptProfiler::ScriptProfiler() {
+	_enabled = ConfigMan.getBool("scriptprofile", false);
+}
+
+ScriptProfiler::~ScriptProfiler() {
+}
+
+bool ScriptProfiler::isEnabled() const {
+	return _enabled;
+}
+
+void ScriptProfiler::setEnabled(bool enabled) {
+	_enabled = enabled;
+}
+
+void ScriptProfiler::clear() {
+	_scripts.clear();
+	_functions.clear();
+
+	for (size_t i = 0; i < ARRAYSIZE(_opcodes); i++)
+		_opcodes[i] = OpcodeEntry();
+}
+
+uint64 ScriptProfiler::getTicks() {
+	return SDL_GetPerformanceCounter();
+}
+
+void ScriptProfiler::addScriptRun(const Common::UString &script, uint64 ticks, uint64 instructions) {
+	ScriptEntry &entry = _scripts[script];
+
+	entry.name          = script;
+	entry.runs         += 1;
+	entry.instructions += instructions;
+	entry.ticks        += ticks;
+}
+
+void ScriptProfiler::addOpcode(uint8 opcode, const char *name) {
+	_opcodes[opcode].name = name;
+	_opcodes[opcode].count++;
+}
+
+void ScriptProfiler::addFunctionCall(uint32 id, const Common::UString &name, uint64 ticks) {
+	if (_functions.size() <= id)
+		_functions.resize(id + 1);
+
+	FunctionEntry &entry = _functions[id];
+
+	if (entry.calls == 0) {
+		entry.name = name;
+		entry.id   = id;
+	}
+
+	entry.calls += 1;
+	entry.ticks += ticks;
+}
+
+bool ScriptProfiler::compareScripts(const ScriptEntry *a, const ScriptEntry *b) {
+	return a->ticks > b->ticks;
+}
+
+bool ScriptProfiler::compareOpcodes(const OpcodeEntry *a, const OpcodeEntry *b) {
+	return a->count > b->count;
+}
+
+bool ScriptProfiler::compareFunctions(const FunctionEntry *a, const FunctionEntry *b) {
+	return a->ticks > b->ticks;
+}
+
+void ScriptProfiler::getReport(std::vector<Common::UString> &lines, size_t maxEntries) const {
+	const double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+
+	// Scripts, by inclusive time
+
+	std::vector<const ScriptEntry *> scripts;
+	for (ScriptMap::const_iterator s = _scripts.begin(); s != _scripts.end(); ++s)
+		scripts.push_back(&s->second);
+
+	std::sort(scripts.begin(), scripts.end(), &compareScripts);
+	if ((maxEntries > 0) && (scripts.size() > maxEntries))
+		scripts.resize(maxEntries);
+
+	lines.push_back("Scripts (inclusive time):");
+	lines.push_back(Common::UString::format("%-16s %8s %12s %10s %10s",
+	                "Name", "Runs", "Instructions", "Total ms", "Avg ms"));
+
+	for (std::vector<const ScriptEntry *>::const_iterator s = scripts.begin(); s != scripts.end(); ++s)
+		lines.push_back(Common::UString::format("%-16s %8u %12llu %10.3f %10.3f",
+		                (*s)->name.c_str(), (*s)->runs, (unsigned long long) (*s)->instructions,
+		                (*s)->ticks * msPerTick, ((*s)->ticks * msPerTick) / (*s)->runs));
+
+	// Engine functions, by time
+
+	std::vector<const FunctionEntry *> functions;
+	for (FunctionArray::const_iterator f = _functions.begin(); f != _functions.end(); ++f)
+		if (f->calls > 0)
+			functions.push_back(&*f);
+
+	std::sort(functions.begin(), functions.end(), &compareFunctions);
+	if ((maxEntries > 0) && (functions.size() > maxEntries))
+		functions.resize(maxEntries);
+
+	lines.push_back("");
+	lines.push_back("Engine functions:");
+	lines.push_back(Common::UString::format("%5s %-32s %10s %10s %10s",
+	                "ID", "Name", "Calls", "Total ms", "Avg ms"));
+
+	for (std::vector<const FunctionEntry *>::const_iterator f = functions.begin(); f != functions.end(); ++f)
+		lines.push_back(Common::UString::format("%5u %-32s %10llu %10.3f %10.4f",
+		                (*f)->id, (*f)->name.c_str(), (unsigned long long) (*f)->calls,
+		                (*f)->ticks * msPerTick, ((*f)->ticks * msPerTick) / (*f)->calls));
+
+	// Opcodes, by execution count
+
+	std::vector<const OpcodeEntry *> opcodes;
+	for (size_t i = 0; i < ARRAYSIZE(_opcodes); i++)
+		if (_opcodes[i].count > 0)
+			opcodes.push_back(&_opcodes[i]);
+
+	std::sort(opcodes.begin(), opcodes.end(), &compareOpcodes);
+	if ((maxEntries > 0) && (opcodes.size() > maxEntries))
+		opcodes.resize(maxEntries);
+
+	lines.push_back("");
+	lines.push_back("Opcodes:");
+	lines.push_back(Common::UString::format("%-4s %-16s %12s", "ID", "Name", "Count"));
+
+	for (std::vector<const OpcodeEntry *>::const_iterator o = opcodes.begin(); o != opcodes.end(); ++o)
+		lines.push_back(Common::UString::format("0x%02X %-16s %12llu", (uint)(*o - _opcodes),
+		                (*o)->name ? (*o)->name : "", (unsigned long long) (*o)->count));
+}
+
+bool ScriptProfiler::dump(const Common::UString &fileName) const {
+	Common::WriteFile file;
+	if (!file.open(fileName))
+		return false;
+
+	std::vector<Common::UString> lines;
+	getReport(lines);
+
+	for (std::vector<Common::UString>::const_iterator l = lines.begin(); l != lines.end(); ++l) {
+		file.writeString(*l);
+		file.writeByte('\n');
+	}
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+} // End of namespace NWScript
+
+} // End of namespace Aurora
@@ -0,0 +1,134 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/** @file
+ *  A profiler for NWScript execution.
+ */
+
+#ifndef AURORA_NWSCRIPT_PROFILER_H
+#define AURORA_NWSCRIPT_PROFILER_H
+
+#include <vector>
+#include <map>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/singleton.h"
+
+namespace Aurora {
+
+namespace NWScript {
+
+/** Records where NWScript execution spends its time.
+ *
+ *  When enabled, it collects the number of runs, the number of executed
+ *  instructions and the wall time of every script, how often each opcode
+ *  was executed, and the number of calls and wall time of every engine
+ *  function.
+ *
+ *  Script times are inclusive: they contain the time spent in the engine
+ *  functions the script called, and in any scripts those ran in turn.
+ *
+ *  The profiler is disabled by default and can be enabled with the config
+ *  option "scriptprofile". It is meant to be used from the game thread only.
+ */
+class ScriptProfiler : public Common::Singleton<ScriptProfiler> {
+public:
+	ScriptProfiler();
+	~ScriptProfiler();
+
+	bool isEnabled() const;
+	void setEnabled(bool enabled);
+
+	/** Forget all recorded data. */
+	void clear();
+
+	/** Return the current value of the high-resolution timer. */
+	static uint64 getTicks();
+
+	/** Record one run of a script. */
+	void addScriptRun(const Common::UString &script, uint64 ticks, uint64 instructions);
+	/** Record the execution of an opcode. */
+	void addOpcode(uint8 opcode, const char *name);
+	/** Record one call of an engine function. */
+	void addFunctionCall(uint32 id, const Common::UString &name, uint64 ticks);
+
+	/** Create a human-readable report of the recorded data.
+	 *
+	 *  @param lines The lines of the report are appended here.
+	 *  @param maxEntries Only list this many entries per section. 0 means all.
+	 */
+	void getReport(std::vector<Common::UString> &lines, size_t maxEntries = 0) const;
+
+	/** Write the full report into a file. */
+	bool dump(const Common::UString &fileName) const;
+
+private:
+	struct ScriptEntry {
+		Common::UString name;
+
+		uint32 runs;
+		uint64 instructions;
+		uint64 ticks;
+
+		ScriptEntry();
+	};
+
+	struct OpcodeEntry {
+		const char *name;
+
+		uint64 count;
+
+		OpcodeEntry();
+	};
+
+	struct FunctionEntry {
+		Common::UString name;
+		uint32 id;
+
+		uint64 calls;
+		uint64 ticks;
+
+		FunctionEntry();
+	};
+
+	typedef std::map<Common::UString, ScriptEntry> ScriptMap;
+	typedef std::vector<FunctionEntry> FunctionArray;
+
+	bool _enabled;
+
+	ScriptMap _scripts;
+	OpcodeEntry _opcodes[256];
+	FunctionArray _functions;
+
+	static bool compareScripts  (const ScriptEntry   *a, const ScriptEntry   *b);
+	static bool compareOpcodes  (const OpcodeEntry   *a, const OpcodeEntry   *b);
+	static bool compareFunctions(const FunctionEntry *a, const FunctionEntry *b);
+};
+
+} // End of namespace NWScript
+
+} // End of namespace Aurora
+
+/** Shortcut for accessing the script profiler. */
+#define ScriptProf ::Aurora::NWScript::ScriptProfiler::instance()
+
+#endif // AURORA_NWSCRIPT_PROFILER_H
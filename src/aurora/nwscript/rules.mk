@@ -33,6 +33,7 @@ src_aurora_nwscript_libnwscript_la_SOURCES += \
     src/aurora/nwscript/objectcontainer.h \
     src/aurora/nwscript/functionman.h \
     src/aurora/nwscript/ncsfile.h \
+    src/aurora/nwscript/profiler.h \
     $(EMPTY)
 
 src_aurora_nwscript_libnwscript_la_SOURCES += \
@@ -43,4 +44,5 @@ src_aurora_nwscript_libnwscript_la_SOURCES += \
     src/aurora/nwscript/objectcontainer.cpp \
     src/aurora/nwscript/functionman.cpp \
     src/aurora/nwscript/ncsfile.cpp \
+    src/aurora/nwscript/profiler.cpp \
     $(EMPTY)
@@ -22,8 +22,12 @@
  *  NWScript variable.
  */
 
+#include "src/common/atomic.h"
+
 #include <boost/make_shared.hpp>
 
+#include <SDL_thread.h>
+
 #include "src/common/error.h"
 #include "src/common/ustring.h"
 
@@ -34,6 +38,132 @@ namespace Aurora {
 
 namespace NWScript {
 
+/** Maximum number of unused value holders kept around for reuse. */
+static const size_t kMaxPooledValues = 1024;
+
+static const Common::UString kEmptyString;
+
+/** A pooled, reference-counted string value. */
+struct Variable::SharedString {
+	Common::UString value;
+
+	boost::atomic<uint32> refCount;
+	SharedString *nextFree;
+
+	SharedString() : refCount(0), nextFree(0) {
+	}
+
+	void clear() {
+		value.clear();
+	}
+};
+
+/** A pooled, reference-counted engine-type value. */
+struct Variable::SharedEngineType {
+	EngineType *value;
+
+	boost::atomic<uint32> refCount;
+	SharedEngineType *nextFree;
+
+	SharedEngineType() : value(0), refCount(0), nextFree(0) {
+	}
+
+	~SharedEngineType() {
+		delete value;
+	}
+
+	void clear() {
+		delete value;
+		value = 0;
+	}
+};
+
+/** A free list recycling the holders of shared variable values.
+ *
+ *  Released holders are cleared and kept for reuse, so that steady-state
+ *  script execution doesn't need to go to the heap for them. Every thread
+ *  has its own pool, so that neither acquiring nor releasing needs a lock.
+ *  A holder released by another thread than the one that acquired it simply
+ *  goes into the releasing thread's pool.
+ */
+template<typename T>
+class SharedValuePool {
+public:
+	/** Return the calling thread's pool. */
+	static SharedValuePool &get() {
+		static const SDL_TLSID tls = SDL_TLSCreate();
+
+		SharedValuePool *pool = static_cast<SharedValuePool *>(SDL_TLSGet(tls));
+		if (!pool) {
+			pool = new SharedValuePool;
+
+			SDL_TLSSet(tls, pool, &destroy);
+		}
+
+		return *pool;
+	}
+
+	/** Return a holder with a reference count of 1. */
+	T *acquire() {
+		T *value = _free;
+
+		if (value) {
+			_free = value->nextFree;
+			_freeCount--;
+		} else
+			value = new T;
+
+		value->nextFree = 0;
+		value->refCount.store(1, boost::memory_order_relaxed);
+
+		return value;
+	}
+
+	static void ref(T *value) {
+		value->refCount.fetch_add(1, boost::memory_order_relaxed);
+	}
+
+	/** Drop a reference, recycling the holder if it was the last one. */
+	void unref(T *value) {
+		if (value->refCount.fetch_sub(1, boost::memory_order_acq_rel) != 1)
+			return;
+
+		value->clear();
+
+		if (_freeCount < kMaxPooledValues) {
+			value->nextFree = _free;
+			_free = value;
+			_freeCount++;
+
+			return;
+		}
+
+		delete value;
+	}
+
+private:
+	T *_free;
+	size_t _freeCount;
+
+	SharedValuePool() : _free(0), _freeCount(0) {
+	}
+
+	~SharedValuePool() {
+		while (_free) {
+			T *value = _free;
+			_free = value->nextFree;
+
+			delete value;
+		}
+	}
+
+	/** Delete a thread's pool when the thread ends. */
+	static void destroy(void *pool) {
+		delete static_cast<SharedValuePool *>(pool);
+	}
+};
+
+
 Variable::Variable(Type type) : _type(kTypeVoid) {
 	setType(type);
 }
@@ -85,18 +215,24 @@ Variable::Variable(const Variable &var) : _type(kTypeVoid) {
 }
 
 Variable::~Variable() {
-	setType(kTypeVoid);
+	release();
 }
 
-void Variable::setType(Type type) {
-	_array.reset();
-
-	if      (_type == kTypeString)
-		delete _value._string;
-	else if (_type == kTypeEngineType)
-		delete _value._engineType;
-	else if (_type == kTypeScriptState)
+void Variable::release() {
+	if      (_type == kTypeString) {
+		if (_value._string)
+			SharedValuePool<SharedString>::get().unref(_value._string);
+	} else if (_type == kTypeEngineType) {
+		if (_value._engineType)
+			SharedValuePool<SharedEngineType>::get().unref(_value._engineType);
+	} else if (_type == kTypeScriptState)
 		delete _value._scriptState;
+	else if (_type == kTypeArray)
+		_array.reset();
+}
+
+void Variable::setType(Type type) {
+	release();
 
 	_type = type;
 
@@ -118,7 +254,7 @@ void Variable::setType(Type type) {
 			break;
 
 		case kTypeString:
-			_value._string = new Common::UString;
+			_value._string = 0;
 			break;
 
 		case kTypeObject:
@@ -144,6 +280,7 @@ void Variable::setType(Type type) {
 			break;
 
 		default:
+			_type = kTypeVoid;
 			throw Common::Exception("Variable::setType(): Invalid type %d", type);
 			break;
 	}
@@ -153,18 +290,44 @@ Variable &Variable::operator=(const Variable &var) {
 	if (&var == this)
 		return *this;
 
-	setType(var._type);
+	switch (var._type) {
+		case kTypeString:
+			// Share the string, taking the reference before dropping our own value
+			if (var._value._string)
+				SharedValuePool<SharedString>::ref(var._value._string);
 
-	if      (_type == kTypeString)
-		*_value._string = *var._value._string;
-	else if (_type == kTypeEngineType)
-		*this = var._value._engineType;
-	else if (_type == kTypeScriptState)
-		*_value._scriptState = *var._value._scriptState;
-	else if (_type == kTypeArray)
-		_array = var._array;
-	else
-		_value = var._value;
+			release();
+			_type = kTypeString;
+			_value._string = var._value._string;
+			break;
+
+		case kTypeEngineType:
+			// Share the engine type, taking the reference before dropping our own value
+			if (var._value._engineType)
+				SharedValuePool<SharedEngineType>::ref(var._value._engineType);
+
+			release();
+			_type = kTypeEngineType;
+			_value._engineType = var._value._engineType;
+			break;
+
+		case kTypeScriptState:
+			setType(kTypeScriptState);
+			*_value._scriptState = *var._value._scriptState;
+			break;
+
+		case kTypeArray:
+			release();
+			_type  = kTypeArray;
+			_array = var._array;
+			break;
+
+		default:
+			release();
+			_type  = var._type;
+			_value = var._value;
+			break;
+	}
 
 	return *this;
 }
@@ -191,7 +354,10 @@ Variable &Variable::operator=(const Common::UString &value) {
 	if (_type != kTypeString)
 		throw Common::Exception("Can't assign a string value to a non-string variable");
 
-	*_value._string = value;
+	if (value.empty() && !_value._string)
+		return *this;
+
+	detachString() = value;
 
 	return *this;
 }
@@ -211,9 +377,17 @@ Variable &Variable::operator=(const EngineType *value) {
 
 	EngineType *engineType = value ? value->clone() : 0;
 
-	delete _value._engineType;
+	SharedValuePool<SharedEngineType> &pool = SharedValuePool<SharedEngineType>::get();
 
-	_value._engineType = engineType;
+	if (_value._engineType)
+		pool.unref(_value._engineType);
+
+	_value._engineType = 0;
+
+	if (engineType) {
+		_value._engineType = pool.acquire();
+		_value._engineType->value = engineType;
+	}
 
 	return *this;
 }
@@ -224,6 +398,22 @@ Variable &Variable::operator=(const EngineType &value) {
 	return *this;
 }
 
+Common::UString &Variable::detachString() {
+	SharedValuePool<SharedString> &pool = SharedValuePool<SharedString>::get();
+
+	if (!_value._string) {
+		_value._string = pool.acquire();
+	} else if (_value._string->refCount.load(boost::memory_order_acquire) > 1) {
+		SharedString *string = pool.acquire();
+		string->value = _value._string->value;
+
+		pool.unref(_value._string);
+		_value._string = string;
+	}
+
+	return _value._string->value;
+}
+
 bool Variable::operator==(const Variable &var) const {
 	if (this == &var)
 		return true;
@@ -242,7 +432,7 @@ bool Variable::operator==(const Variable &var) const {
 			return _value._float == var._value._float;
 
 		case kTypeString:
-			return *_value._string == *var._value._string;
+			return getString() == var.getString();
 
 		case kTypeObject:
 			return _value._object == var._value._object;
@@ -288,14 +478,11 @@ const Common::UString &Variable::getString() const {
 	if (_type != kTypeString)
 		throw Common::Exception("Can't get a string value from a non-string variable");
 
-	return *_value._string;
+	return _value._string ? _value._string->value : kEmptyString;
 }
 
-Common::UString &Variable::getString() {
-	if (_type != kTypeString)
-		throw Common::Exception("Can't get a string value from a non-string variable");
-
-	return *_value._string;
+void Variable::setString(const Common::UString &value) {
+	*this = value;
 }
 
 Object *Variable::getObject() const {
@@ -305,11 +492,25 @@ Object *Variable::getObject() const {
 	return _value._object;
 }
 
-EngineType *Variable::getEngineType() const {
+EngineType *Variable::getEngineType() {
+	if (_type != kTypeEngineType)
+		throw Common::Exception("Can't get an engine-type value from a non-engine-type variable");
+
+	if (!_value._engineType)
+		return 0;
+
+	// Writable access: make sure we don't modify an engine type shared with another variable
+	if (_value._engineType->refCount.load(boost::memory_order_acquire) > 1)
+		*this = static_cast<const EngineType *>(_value._engineType->value);
+
+	return _value._engineType->value;
+}
+
+const EngineType *Variable::getEngineType() const {
 	if (_type != kTypeEngineType)
 		throw Common::Exception("Can't get an engine-type value from a non-engine-type variable");
 
-	return _value._engineType;
+	return _value._engineType ? _value._engineType->value : 0;
 }
 
 void Variable::setVector(float x, float y, float z) {
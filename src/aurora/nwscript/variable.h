@@ -52,6 +52,13 @@ struct ScriptState {
 	std::vector<class Variable> locals;
 };
 
+/** An NWScript variable.
+ *
+ *  Ints, floats, objects, vectors and references are held inline. Strings and
+ *  engine types are held in pooled, reference-counted holders that are shared
+ *  between copies and only duplicated when written to (copy-on-write), so
+ *  copying variables around the script stack doesn't allocate.
+ */
 class Variable {
 public:
 	typedef std::vector< boost::shared_ptr<Variable> > Array;
@@ -85,10 +92,13 @@ public:
 
 	int32 getInt() const;
 	float getFloat() const;
-	Common::UString &getString();
 	const Common::UString &getString() const;
+	/** Change the string, without touching the other variables that share it. */
+	void setString(const Common::UString &value);
 	Object *getObject() const;
-	EngineType *getEngineType() const;
+	/** Return the engine type for writing, unsharing it first. Read through a const Variable. */
+	EngineType *getEngineType();
+	const EngineType *getEngineType() const;
 
 	void setVector(float  x, float  y, float  z);
 	void getVector(float &x, float &y, float &z) const;
@@ -107,20 +117,29 @@ public:
 	void setReference(Variable *reference);
 
 private:
+	struct SharedString;
+	struct SharedEngineType;
+
 	Type _type;
 
 	union {
 		int32 _int;
 		float _float;
-		Common::UString *_string;
+		SharedString *_string;         ///< 0 for an empty string.
 		Object *_object;
 		float _vector[3];
 		ScriptState *_scriptState;
-		EngineType *_engineType;
+		SharedEngineType *_engineType; ///< 0 for no engine type.
 		Variable *_reference;
 	} _value;
 
 	boost::shared_ptr<Array> _array;
+
+	/** Release the value currently held, leaving the variable in an undefined state. */
+	void release();
+
+	/** Make sure we hold an unshared string, copying it if necessary. */
+	Common::UString &detachString();
 };
 
 } // End of namespace NWScript
@@ -23,16 +23,22 @@
  */
 
 #include <cassert>
+#include <iterator>
 
 #include <boost/scope_exit.hpp>
 
 #include "src/common/util.h"
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/streamview.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
 #include "src/common/writefile.h"
+#include "src/common/frameprofiler.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/util.h"
@@ -93,6 +99,52 @@ void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
 }
 
 
+/** Default maximum size of the cache of unpacked resources: 32MB. */
+static const size_t kDefaultCacheSize = 32 * 1024 * 1024;
+
+/** Default size up to which archives within archives are copied into memory: 64KB. */
+static const size_t kDefaultArchiveCopySize = 64 * 1024;
+
+/** A read-only view of an unpacked resource held in the cache.
+ *
+ *  The view shares ownership of the data, so it stays valid even when
+ *  the resource is evicted from the cache while the view is still in use.
+ */
+class CachedResourceStream : public Common::MemoryReadStream {
+public:
+	CachedResourceStream(const boost::shared_array<byte> &data, size_t size) :
+		Common::MemoryReadStream(data.get(), size, false), _data(data) {
+
+	}
+
+	~CachedResourceStream() {
+	}
+
+private:
+	boost::shared_array<byte> _data;
+};
+
+
+ResourceManager::CacheStatistics::CacheStatistics() : hits(0), misses(0), evictions(0),
+	entries(0), size(0), capacity(0) {
+
+}
+
+
+ResourceManager::ResourceOrigin::ResourceOrigin() : inArchive(false), archiveIndex(0xFFFFFFFF),
+	priority(0), size(0xFFFFFFFF) {
+
+}
+
+bool ResourceManager::ResourceOrigin::operator==(const ResourceOrigin &right) const {
+	return (inArchive == right.inArchive) && (container == right.container) &&
+	       (archiveIndex == right.archiveIndex) && (priority == right.priority) && (size == right.size);
+}
+
+bool ResourceManager::ResourceOrigin::operator!=(const ResourceOrigin &right) const {
+	return !(*this == right);
+}
+
 ResourceManager::Resource::Resource() : type(kFileTypeNone), isSmall(false), priority(0),
 		source(kSourceNone), archive(0), archiveIndex(0xFFFFFFFF) {
 
@@ -105,7 +157,7 @@ bool ResourceManager::Resource::operator<(const Resource &right) const {
 
 
 ResourceManager::ResourceManager() : _hasSmall(false),
-	_hashAlgo(Common::kHashFNV64) {
+	_hashAlgo(Common::kHashFNV64), _archiveCopySize(kDefaultArchiveCopySize) {
 
 	// These file types are archives
 
@@ -165,6 +217,8 @@ ResourceManager::ResourceManager() : _hasSmall(false),
 	_resourceTypeTypes[kResourceCursor].push_back(kFileTypeCURS);
 	_resourceTypeTypes[kResourceCursor].push_back(kFileTypeDDS);
 	_resourceTypeTypes[kResourceCursor].push_back(kFileTypeTGA);
+
+	setCacheSize(kDefaultCacheSize);
 }
 
 ResourceManager::~ResourceManager() {
@@ -197,6 +251,8 @@ void ResourceManager::clearResources() {
 	_resources.clear();
 
 	_changes.clear();
+
+	clearCache();
 }
 
 void ResourceManager::setRIMsAreERFs(bool rimsAreERFs) {
@@ -288,7 +344,22 @@ Common::SeekableReadStream *ResourceManager::openArchiveStream(const KnownArchiv
 	if (!archive.resource)
 		throw Common::Exception("Archive without resource reference");
 
-	return getResource(*archive.resource, true);
+	/* Archives within archives are read through a view into the storage of
+	 * their parent, which might itself be a view into an archive, down to
+	 * the outermost file. Packed archives are already unpacked into memory
+	 * at this point, and small archives are cheap enough to copy, so that
+	 * reading them doesn't contend with all other users of their parent. */
+	Common::ScopedPtr<Common::SeekableReadStream> stream(getResource(*archive.resource, true));
+
+	Common::SeekableStreamView *view = dynamic_cast<Common::SeekableStreamView *>(stream.get());
+	if (view && (view->size() <= _archiveCopySize))
+		return view->copyRange(0, view->size());
+
+	return stream.release();
+}
+
+void ResourceManager::setArchiveCopySize(size_t size) {
+	_archiveCopySize = size;
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
@@ -579,6 +650,7 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 		}
 
 		// Remove the resource, and the name list too if it's empty
+		uncacheResource(*resChange->resIt);
 		resChange->hashIt->second.erase(resChange->resIt);
 
 		if (resChange->hashIt->second.empty())
@@ -687,6 +759,31 @@ Common::UString ResourceManager::findResourceFile(const Common::UString &name,
 	return "";
 }
 
+bool ResourceManager::getResourceOrigin(const Common::UString &name, FileType type,
+                                        ResourceOrigin &origin) const {
+
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return false;
+
+	origin = ResourceOrigin();
+
+	if        (res->source == kSourceFile) {
+		origin.container = res->path;
+	} else if (res->source == kSourceArchive) {
+		origin.inArchive    = true;
+		origin.archiveIndex = res->archiveIndex;
+
+		if (res->archive && res->archive->known)
+			origin.container = res->archive->known->name;
+	}
+
+	origin.priority = res->priority;
+	origin.size     = getResourceSize(*res);
+
+	return true;
+}
+
 uint32 ResourceManager::getResourceSize(const Resource &res) const {
 	if (res.source == kSourceArchive) {
 		if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
@@ -747,6 +844,17 @@ Common::SeekableReadStream *ResourceManager::getResource(uint64 hash, FileType *
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bool tryNoCopy) const {
+	Common::ProfileZone profile("getResource");
+
+	/* Packed resources are expensive to read, so we might have already cached them.
+	 * Archives within archives are read without copying and kept open anyway. */
+	const bool packed = !tryNoCopy && isResourcePacked(res);
+	if (packed) {
+		Common::SeekableReadStream *cached = getCachedResource(res);
+		if (cached)
+			return cached;
+	}
+
 	Common::SeekableReadStream *stream = 0;
 
 	switch (res.source) {
@@ -767,9 +875,139 @@ Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bo
 	if (res.isSmall)
 		stream = Small::decompress(stream);
 
+	if (packed)
+		stream = cacheResource(res, stream);
+
 	return stream;
 }
 
+bool ResourceManager::isResourcePacked(const Resource &res) const {
+	if (res.isSmall)
+		return true;
+
+	if ((res.source != kSourceArchive) || (res.archive == 0) || (res.archive->archive == 0) ||
+	    (res.archiveIndex == 0xFFFFFFFF))
+		return false;
+
+	return res.archive->archive->isResourcePacked(res.archiveIndex);
+}
+
+Common::SeekableReadStream *ResourceManager::getCachedResource(const Resource &res) const {
+	Common::StackLock lock(_cacheMutex);
+
+	if (_cacheStats.capacity == 0)
+		return 0;
+
+	ResourceCache::iterator cached = _cache.find(&res);
+	if (cached == _cache.end()) {
+		_cacheStats.misses++;
+		return 0;
+	}
+
+	// Mark the resource as the most recently used
+	_cacheLRU.splice(_cacheLRU.begin(), _cacheLRU, cached->second.lru);
+
+	_cacheStats.hits++;
+
+	return new CachedResourceStream(cached->second.data, cached->second.size);
+}
+
+Common::SeekableReadStream *ResourceManager::cacheResource(const Resource &res,
+                                                           Common::SeekableReadStream *stream) const {
+
+	Common::ScopedPtr<Common::SeekableReadStream> unpacked(stream);
+
+	const size_t size = unpacked->size();
+
+	{
+		Common::StackLock lock(_cacheMutex);
+
+		// Don't let a single resource push out more than a quarter of the cache
+		if ((size == 0) || (size > (_cacheStats.capacity / 4)))
+			return unpacked.release();
+	}
+
+	boost::shared_array<byte> data(new byte[size]);
+
+	unpacked->seek(0);
+	if (unpacked->read(data.get(), size) != size)
+		throw Common::Exception(Common::kReadError);
+
+	Common::StackLock lock(_cacheMutex);
+
+	// Only add it if the cache didn't shrink and nobody added the resource in the meantime
+	if ((size <= (_cacheStats.capacity / 4)) && (_cache.find(&res) == _cache.end())) {
+		shrinkCache(_cacheStats.capacity - size);
+
+		CachedResource &cached = _cache[&res];
+
+		cached.data = data;
+		cached.size = size;
+
+		_cacheLRU.push_front(&res);
+		cached.lru = _cacheLRU.begin();
+
+		_cacheStats.size   += size;
+		_cacheStats.entries = _cache.size();
+	}
+
+	return new CachedResourceStream(data, size);
+}
+
+void ResourceManager::uncacheResource(const Resource &res) {
+	Common::StackLock lock(_cacheMutex);
+
+	ResourceCache::iterator cached = _cache.find(&res);
+	if (cached == _cache.end())
+		return;
+
+	_cacheStats.size -= cached->second.size;
+
+	_cacheLRU.erase(cached->second.lru);
+	_cache.erase(cached);
+
+	_cacheStats.entries = _cache.size();
+}
+
+void ResourceManager::shrinkCache(size_t size) const {
+	while ((_cacheStats.size > size) && !_cacheLRU.empty()) {
+		ResourceCache::iterator cached = _cache.find(_cacheLRU.back());
+		assert(cached != _cache.end());
+
+		_cacheStats.size -= cached->second.size;
+		_cacheStats.evictions++;
+
+		_cache.erase(cached);
+		_cacheLRU.pop_back();
+	}
+
+	_cacheStats.entries = _cache.size();
+}
+
+void ResourceManager::setCacheSize(size_t size) {
+	Common::StackLock lock(_cacheMutex);
+
+	_cacheStats.capacity = size;
+
+	shrinkCache(size);
+}
+
+void ResourceManager::clearCache() {
+	Common::StackLock lock(_cacheMutex);
+
+	_cache.clear();
+	_cacheLRU.clear();
+
+	_cacheStats.size    = 0;
+	_cacheStats.entries = 0;
+}
+
+ResourceManager::CacheStatistics ResourceManager::getCacheStatistics() const {
+	Common::StackLock lock(_cacheMutex);
+
+	return _cacheStats;
+}
+
 Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 		const Common::UString &name, FileType *foundType) const {
 
@@ -850,7 +1088,7 @@ Common::UString ResourceManager::getArchiveName(const Resource &resource) const
 	                        resource.source);
 }
 
-bool ResourceManager::normalizeType(Resource &resource) {
+bool ResourceManager::normalizeType(Resource &resource) const {
 	// Resolve the type aliases
 	std::map<FileType, FileType>::const_iterator alias = _typeAliases.find(resource.type);
 	if (alias != _typeAliases.end()) {
@@ -970,34 +1208,111 @@ void ResourceManager::addResource(Resource &resource, uint64 hash, Change *chang
 	resList->second.sort();
 }
 
-void ResourceManager::addResource(const Common::UString &path, Change *change, uint32 priority) {
-	Resource res;
-	res.priority = priority;
-	res.source   = kSourceFile;
-	res.path     = path;
-	res.name     = Common::FilePath::getStem(path);
-	res.type     = TypeMan.getFileType(path);
+void ResourceManager::createFileResource(const Common::UString &path, uint32 priority,
+                                         Resource &resource, uint64 &hash) const {
+
+	resource.priority = priority;
+	resource.source   = kSourceFile;
+	resource.path     = path;
+	resource.name     = Common::FilePath::getStem(path);
+	resource.type     = TypeMan.getFileType(path);
 
 	// Handle "small" files
-	if (_hasSmall && (res.type == kFileTypeSMALL)) {
-		const Common::UString name = res.name;
+	if (_hasSmall && (resource.type == kFileTypeSMALL)) {
+		const Common::UString name = resource.name;
 
-		res.isSmall = true;
+		resource.isSmall = true;
 
-		res.name = Common::FilePath::getStem(name);
-		res.type = TypeMan.getFileType(name);
+		resource.name = Common::FilePath::getStem(name);
+		resource.type = TypeMan.getFileType(name);
 	}
 
-	uint64 hash = getHash(res.name, res.type);
-	if (normalizeType(res))
-		hash = getHash(res.name, res.type);
+	normalizeType(resource);
+
+	hash = getHash(resource.name, resource.type);
+}
+
+void ResourceManager::addResource(const Common::UString &path, Change *change, uint32 priority) {
+	Resource res;
+	uint64 hash;
+
+	createFileResource(path, priority, res, hash);
 
 	addResource(res, hash, change);
 }
 
+/** Creates the resources for a range of files. */
+class ResourceManager::FileResourceJob : public Common::Job {
+public:
+	FileResourceJob(const ResourceManager &resMan, uint32 priority,
+	                Common::FileList::const_iterator begin, Common::FileList::const_iterator end,
+	                Resource *resources, uint64 *hashes) :
+		_resMan(&resMan), _priority(priority), _begin(begin), _end(end), _resources(resources), _hashes(hashes) {
+
+	}
+
+	void run() {
+		size_t i = 0;
+		for (Common::FileList::const_iterator file = _begin; file != _end; ++file, i++)
+			_resMan->createFileResource(*file, _priority, _resources[i], _hashes[i]);
+	}
+
+private:
+	const ResourceManager *_resMan;
+	uint32 _priority;
+
+	Common::FileList::const_iterator _begin;
+	Common::FileList::const_iterator _end;
+
+	Resource *_resources;
+	uint64   *_hashes;
+};
+
 void ResourceManager::addResources(const Common::FileList &files, Change *change, uint32 priority) {
-	for (Common::FileList::const_iterator file = files.begin(); file != files.end(); ++file)
-		addResource(*file, change, priority);
+	/** The number of files each indexing job works on. */
+	static const size_t kFilesPerJob = 1024;
+
+	if (files.size() <= kFilesPerJob) {
+		for (Common::FileList::const_iterator file = files.begin(); file != files.end(); ++file)
+			addResource(*file, change, priority);
+
+		return;
+	}
+
+	/* Working out the names, types and hashes of many files takes a while,
+	 * so that is done in parallel. Only adding them to the resource map is
+	 * done one by one, in the original order, so that the same resources
+	 * win out as before. */
+
+	std::vector<Resource> resources(files.size());
+	std::vector<uint64>   hashes   (files.size());
+
+	// Singletons aren't created thread-safely, so make sure the file type manager exists first
+	TypeMan;
+
+	{
+		Common::PtrVector<FileResourceJob> jobs;
+
+		Common::JobGroup group;
+
+		Common::FileList::const_iterator file = files.begin();
+		for (size_t i = 0; i < files.size(); i += kFilesPerJob) {
+			const size_t count = MIN(kFilesPerJob, files.size() - i);
+
+			Common::FileList::const_iterator end = file;
+			std::advance(end, count);
+
+			jobs.push_back(new FileResourceJob(*this, priority, file, end, &resources[i], &hashes[i]));
+			ThreadPoolMan.addJob(*jobs.back(), group);
+
+			file = end;
+		}
+
+		ThreadPoolMan.wait(group);
+	}
+
+	for (size_t i = 0; i < resources.size(); i++)
+		addResource(resources[i], hashes[i], change);
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(uint64 hash) const {
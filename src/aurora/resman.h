@@ -30,12 +30,15 @@
 #include <map>
 #include <set>
 
+#include <boost/shared_array.hpp>
+
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
 #include "src/common/changeid.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 
@@ -60,6 +63,35 @@ public:
 		uint64 hash;
 	};
 
+	/** Where a resource is found, to notice when a different one would be used instead. */
+	struct ResourceOrigin {
+		bool inArchive; ///< Is the resource found within an archive?
+
+		Common::UString container; ///< The file's path, or the name of the archive it's in.
+		uint32 archiveIndex;       ///< Index into the archive.
+
+		uint32 priority; ///< The resource's priority over others with the same name and type.
+		uint32 size;     ///< The resource's size.
+
+		ResourceOrigin();
+
+		bool operator==(const ResourceOrigin &right) const;
+		bool operator!=(const ResourceOrigin &right) const;
+	};
+
+	/** Statistics of the cache of unpacked resources. */
+	struct CacheStatistics {
+		uint64 hits;      ///< Number of requests served from the cache.
+		uint64 misses;    ///< Number of requests that had to unpack the resource.
+		uint64 evictions; ///< Number of resources dropped to make room for others.
+
+		size_t entries;  ///< Number of resources currently in the cache.
+		size_t size;     ///< Combined size of all cached resources, in bytes.
+		size_t capacity; ///< Maximum combined size of all cached resources, in bytes.
+
+		CacheStatistics();
+	};
+
 	ResourceManager();
 	~ResourceManager();
 
@@ -281,6 +313,15 @@ public:
 	 */
 	Common::UString findResourceFile(const Common::UString &name, const std::vector<FileType> &types) const;
 
+	/** Find where a resource is found, without reading it.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @param  origin Where the origin of the resource is stored.
+	 *  @return true if the resource exists, false otherwise.
+	 */
+	bool getResourceOrigin(const Common::UString &name, FileType type, ResourceOrigin &origin) const;
+
 	/** Return a resource.
 	 *
 	 *  @param  hash The hash of the name and extension of the resource.
@@ -338,6 +379,34 @@ public:
 	/** Dump a list of all resources into a file. */
 	void dumpResourcesList(const Common::UString &fileName) const;
 
+	// .--- Cache of unpacked resources
+	/** Set the maximum combined size of all cached unpacked resources, in bytes.
+	 *
+	 *  Compressed or encrypted resources are kept in the cache after they have
+	 *  been unpacked, so that later requests for the same resource can be served
+	 *  without unpacking it again. A size of 0 disables the cache.
+	 */
+	void setCacheSize(size_t size);
+
+	/** Drop all resources from the cache. */
+	void clearCache();
+
+	/** Return statistics about the cache. */
+	CacheStatistics getCacheStatistics() const;
+	// '---
+
+	// .--- Archives within archives
+	/** Set the size, in bytes, up to which archives within archives are copied into memory.
+	 *
+	 *  Bigger archives are read through a view into their parent archive,
+	 *  sharing the parent's file or memory instead of duplicating it.
+	 *  Archives that are compressed or encrypted within their parent are
+	 *  always unpacked into memory, and archives within those then view
+	 *  that memory in turn. A size of 0 never copies any other archives.
+	 */
+	void setArchiveCopySize(size_t size);
+	// '---
+
 
 private:
 	typedef std::vector<FileType> FileTypeList;
@@ -493,6 +562,32 @@ private:
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
+	// .--- Cache of unpacked resources
+	/** Least recently used resources at the back. */
+	typedef std::list<const Resource *> CacheLRUList;
+
+	/** An unpacked resource in the cache. */
+	struct CachedResource {
+		boost::shared_array<byte> data;
+		size_t size;
+
+		/** Our position in the LRU list. */
+		CacheLRUList::iterator lru;
+	};
+
+	typedef std::map<const Resource *, CachedResource> ResourceCache;
+
+	/** Protects the cache, which is used from the const resource getters. */
+	mutable Common::Mutex _cacheMutex;
+
+	mutable ResourceCache   _cache;      ///< All cached resources.
+	mutable CacheLRUList    _cacheLRU;   ///< Cached resources, in order of their last use.
+	mutable CacheStatistics _cacheStats; ///< Statistics about the cache.
+	// '---
+
+	/** Archives within archives up to this size are copied into memory. */
+	size_t _archiveCopySize;
+
 
 	void clearResources();
 
@@ -514,8 +609,13 @@ private:
 
 	// .--- Adding resources
 
+	class FileResourceJob;
+
 	bool checkResourceIsArchive(Resource &resource, Change *change);
 
+	/** Create the resource for a file, without adding it. Safe to call from several threads at once. */
+	void createFileResource(const Common::UString &path, uint32 priority, Resource &resource, uint64 &hash) const;
+
 	void addResource(Resource &resource, uint64 hash, Change *change);
 	void addResource(const Common::UString &path, Change *change, uint32 priority);
 
@@ -534,8 +634,23 @@ private:
 	uint32 getResourceSize(const Resource &res) const;
 	// '---
 
+	// .--- Cache of unpacked resources
+	/** Is this resource expensive enough to unpack that we want to cache it? */
+	bool isResourcePacked(const Resource &res) const;
+
+	/** Return a view of a cached resource, or 0 if it's not in the cache. */
+	Common::SeekableReadStream *getCachedResource(const Resource &res) const;
+	/** Put an unpacked resource into the cache, returning a view of it. */
+	Common::SeekableReadStream *cacheResource(const Resource &res, Common::SeekableReadStream *stream) const;
+
+	/** Remove a resource from the cache. */
+	void uncacheResource(const Resource &res);
+	/** Drop the least recently used resources until the cache isn't bigger than this. */
+	void shrinkCache(size_t size) const;
+	// '---
+
 	// .--- Resource utility methods
-	bool normalizeType(Resource &resource);
+	bool normalizeType(Resource &resource) const;
 
 	ArchiveType     getArchiveType(FileType type) const;
 	ArchiveType     getArchiveType(const Common::UString &name) const;
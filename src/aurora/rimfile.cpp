@@ -37,7 +37,7 @@ static const uint32 kVersion1  = MKTAG('V', '1', '.', '0');
 
 namespace Aurora {
 
-RIMFile::RIMFile(Common::SeekableReadStream *rim) : _rim(rim) {
+RIMFile::RIMFile(Common::SeekableReadStream *rim) : _rim(Common::SeekableStreamView::wrap(rim)) {
 	assert(_rim);
 
 	load(*_rim);
@@ -109,11 +109,9 @@ Common::SeekableReadStream *RIMFile::getResource(uint32 index, bool tryNoCopy) c
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_rim.get(), res.offset, res.offset + res.size);
+		return _rim->createView(res.offset, res.offset + res.size);
 
-	_rim->seek(res.offset);
-
-	return _rim->readStream(res.size);
+	return _rim->copyRange(res.offset, res.offset + res.size);
 }
 
 } // End of namespace Aurora
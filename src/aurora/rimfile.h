@@ -29,6 +29,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/streamview.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/archive.h"
@@ -82,7 +83,7 @@ private:
 
 	typedef std::vector<IResource> IResourceList;
 
-	Common::ScopedPtr<Common::SeekableReadStream> _rim;
+	Common::ScopedPtr<Common::SeekableStreamView> _rim;
 
 	/** External list of resource names and types. */
 	ResourceList _resources;
@@ -339,6 +339,9 @@ const FileTypeManager::Type FileTypeManager::types[] = {
 
 
 FileTypeManager::FileTypeManager() {
+	// Build these right away, so that looking up types is safe from several threads
+	buildExtensionLookup();
+	buildTypeLookup();
 }
 
 FileTypeManager::~FileTypeManager() {
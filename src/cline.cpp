@@ -61,6 +61,9 @@ static void displayUsage(const Common::UString &name) {
 	std::printf("          --nologfile=BOOL    Don't write a log file.\n");
 	std::printf("          --consolelog=FILE   Write all debug console output into this file too.\n");
 	std::printf("          --noconsolelog=BOOL Don't write a debug console log file.\n");
+	std::printf("          --nullsound=BOOL    Decode all sounds without playing them.\n");
+	std::printf("          --benchmark=FILE    Benchmark a scene and write the frame times to FILE.\n");
+	std::printf("                              See the man page for the other benchmark options.\n");
 	std::printf("\n");
 	std::printf("FILE: Absolute or relative path to a file.\n");
 	std::printf("DIR:  Absolute or relative path to a directory.\n");
@@ -23,6 +23,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -378,4 +379,107 @@ MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vecto
 	return blowfishEBC(input, key, kModeDecrypt);
 }
 
+
+BlowfishEBCReadStream::BlowfishEBCReadStream(SeekableReadStream *input, const std::vector<byte> &key,
+                                             bool disposeInput) :
+	_input(input, disposeInput), _context(new BlowfishContext), _size(0), _pos(0), _eos(false),
+	_blockPos(kSizeInvalid) {
+
+	assert(_input);
+
+	_size = _input->size();
+	if ((_size % kBlockSize) != 0)
+		throw Exception("Blowfish operates on blocks of 8 bytes (%u)", (uint) _size);
+
+	if (key.empty())
+		throw Exception("Invalid Blowfish key length 0");
+
+	blowfishSetKey(*_context, &key[0], key.size());
+}
+
+BlowfishEBCReadStream::~BlowfishEBCReadStream() {
+}
+
+void BlowfishEBCReadStream::readBlocks(size_t position, byte *data, size_t dataSize) {
+	assert(((position % kBlockSize) == 0) && ((dataSize % kBlockSize) == 0));
+
+	_input->seek(position);
+	if (_input->read(data, dataSize) != dataSize)
+		throw Exception(kReadError);
+
+	for (size_t i = 0; i < dataSize; i += kBlockSize)
+		blowfishECB(*_context, kModeDecrypt, data + i, data + i);
+}
+
+bool BlowfishEBCReadStream::eos() const {
+	return _eos;
+}
+
+size_t BlowfishEBCReadStream::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	if (dataSize > (_size - _pos)) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *data = reinterpret_cast<byte *>(dataPtr);
+
+	size_t left = dataSize;
+	while (left > 0) {
+		const size_t offset = _pos % kBlockSize;
+
+		if ((offset == 0) && (left >= kBlockSize)) {
+			// Aligned to whole blocks: decrypt straight into the output
+
+			const size_t blocksSize = left - (left % kBlockSize);
+
+			readBlocks(_pos, data, blocksSize);
+
+			data  += blocksSize;
+			_pos  += blocksSize;
+			left  -= blocksSize;
+			continue;
+		}
+
+		// Partial block: decrypt it once and copy what we need
+
+		const size_t blockPos = _pos - offset;
+		if (_blockPos != blockPos) {
+			_blockPos = kSizeInvalid;
+			readBlocks(blockPos, _block, kBlockSize);
+			_blockPos = blockPos;
+		}
+
+		const size_t n = MIN<size_t>(left, kBlockSize - offset);
+		std::memcpy(data, _block + offset, n);
+
+		data += n;
+		_pos += n;
+		left -= n;
+	}
+
+	return dataSize;
+}
+
+size_t BlowfishEBCReadStream::pos() const {
+	return _pos;
+}
+
+size_t BlowfishEBCReadStream::size() const {
+	return _size;
+}
+
+size_t BlowfishEBCReadStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false; // reset eos on successful seek
+
+	return oldPos;
+}
+
 } // End of namespace Common
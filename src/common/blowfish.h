@@ -27,18 +27,65 @@
 
 #include <vector>
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/disposableptr.h"
+#include "src/common/readstream.h"
 
 namespace Common {
 
-class SeekableReadStream;
 class MemoryReadStream;
 
+struct BlowfishContext;
+
 /** Encrypt the stream with the Blowfish algorithm in EBC mode. */
 MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
 /** Decrypt the stream with the Blowfish algorithm in EBC mode. */
 MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
 
+/** A stream decrypting Blowfish EBC encrypted data on the fly.
+ *
+ *  Only the 8-byte blocks touched by a read are decrypted, so parts of
+ *  a big encrypted file can be read without decrypting all of it first.
+ *  The size of the encrypted stream has to be a multiple of 8 bytes.
+ *
+ *  Manipulating the input stream directly /will/ mess up this stream.
+ */
+class BlowfishEBCReadStream : boost::noncopyable, public SeekableReadStream {
+public:
+	BlowfishEBCReadStream(SeekableReadStream *input, const std::vector<byte> &key,
+	                      bool disposeInput = true);
+	~BlowfishEBCReadStream();
+
+	bool eos() const;
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+private:
+	DisposablePtr<SeekableReadStream> _input;
+	ScopedPtr<BlowfishContext> _context;
+
+	size_t _size;
+	size_t _pos;
+
+	bool _eos;
+
+	/** The last decrypted block, for reads not aligned to whole blocks. */
+	byte _block[8];
+	/** Position of the last decrypted block within the stream. */
+	size_t _blockPos;
+
+	/** Read and decrypt these whole blocks directly into the output. */
+	void readBlocks(size_t position, byte *data, size_t dataSize);
+};
+
 } // End of namespace Common
 
 #endif // COMMON_BLOWFISH_H
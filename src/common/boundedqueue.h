@@ -0,0 +1,173 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A bounded, lock-free multi-producer multi-consumer queue.
+ */
+
+#ifndef COMMON_BOUNDEDQUEUE_H
+#define COMMON_BOUNDEDQUEUE_H
+
+#include "src/common/atomic.h"
+
+#include <cstddef>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+
+namespace Common {
+
+/** A bounded, lock-free queue, for any number of producer and consumer threads.
+ *
+ *  The queue is a ring buffer of kSize slots, where kSize needs to be a power
+ *  of 2. Each slot carries a sequence number, telling whether the slot is free
+ *  for the position a producer wants to write to, or holds a value for the
+ *  position a consumer wants to read from. Producers claim a position by
+ *  atomically advancing the head, and publish their value by updating the
+ *  slot's sequence. Consumers do the same with the tail.
+ *
+ *  Positions only ever increase. The position a value was pushed to can be
+ *  used as a fence: once the tail moved past it, the value was popped.
+ */
+template<typename T, size_t kSize>
+class BoundedQueue : boost::noncopyable {
+public:
+	BoundedQueue() : _slots(new Slot[kSize]), _head(0), _tail(0) {
+		for (size_t i = 0; i < kSize; i++)
+			_slots[i].sequence.store(i, boost::memory_order_relaxed);
+	}
+
+	/** Try to add a value to the end of the queue.
+	 *
+	 *  @param  value    The value to add.
+	 *  @param  position If not 0, set to the position the value was added at.
+	 *  @return false if the queue is full.
+	 */
+	bool tryPush(const T &value, size_t *position = 0) {
+		Slot *slot = 0;
+
+		size_t pos = _head.load(boost::memory_order_relaxed);
+		while (true) {
+			slot = &_slots[pos & (kSize - 1)];
+
+			const size_t sequence = slot->sequence.load(boost::memory_order_acquire);
+			if (sequence == pos) {
+				if (_head.compare_exchange_weak(pos, pos + 1, boost::memory_order_relaxed))
+					break;
+
+			} else if ((ptrdiff_t) (sequence - pos) < 0) {
+				// The slot still holds a value from one round earlier: the queue is full
+				return false;
+
+			} else
+				pos = _head.load(boost::memory_order_relaxed);
+		}
+
+		slot->value = value;
+		slot->sequence.store(pos + 1, boost::memory_order_release);
+
+		if (position)
+			*position = pos;
+
+		return true;
+	}
+
+	/** Try to remove the value at the front of the queue.
+	 *
+	 *  @param  value    Set to the removed value.
+	 *  @param  position If not 0, set to the position the value was at.
+	 *  @return false if the queue is empty.
+	 */
+	bool tryPop(T &value, size_t *position = 0) {
+		Slot *slot = 0;
+
+		size_t pos = _tail.load(boost::memory_order_relaxed);
+		while (true) {
+			slot = &_slots[pos & (kSize - 1)];
+
+			const size_t sequence = slot->sequence.load(boost::memory_order_acquire);
+			if (sequence == (pos + 1)) {
+				if (_tail.compare_exchange_weak(pos, pos + 1, boost::memory_order_relaxed))
+					break;
+
+			} else if ((ptrdiff_t) (sequence - (pos + 1)) < 0) {
+				// The slot hasn't been written to in this round yet: the queue is empty
+				return false;
+
+			} else
+				pos = _tail.load(boost::memory_order_relaxed);
+		}
+
+		value = slot->value;
+
+		// Mark the slot as free for the next round
+		slot->sequence.store(pos + kSize, boost::memory_order_release);
+
+		if (position)
+			*position = pos;
+
+		return true;
+	}
+
+	/** Return the position the next value will be pushed to. */
+	size_t getHead() const {
+		return _head.load(boost::memory_order_acquire);
+	}
+
+	/** Return the position the next value will be popped from. */
+	size_t getTail() const {
+		return _tail.load(boost::memory_order_acquire);
+	}
+
+	/** Return the number of values in the queue. Only a snapshot while other threads use the queue. */
+	size_t size() const {
+		const size_t tail = _tail.load(boost::memory_order_relaxed);
+		const size_t head = _head.load(boost::memory_order_relaxed);
+
+		return ((ptrdiff_t) (head - tail) > 0) ? (head - tail) : 0;
+	}
+
+	/** Is the queue empty? Only a snapshot while other threads use the queue. */
+	bool empty() const {
+		const size_t pos = _tail.load(boost::memory_order_relaxed);
+
+		return _slots[pos & (kSize - 1)].sequence.load(boost::memory_order_acquire) != (pos + 1);
+	}
+
+private:
+	/** A slot in the ring buffer. */
+	struct Slot {
+		/** The position this slot was last written to or read from. */
+		boost::atomic<size_t> sequence;
+
+		T value;
+	};
+
+	ScopedArray<Slot> _slots;
+
+	boost::atomic<size_t> _head; ///< The position the next value will be pushed to.
+	boost::atomic<size_t> _tail; ///< The position the next value will be popped from.
+};
+
+} // End of namespace Common
+
+#endif // COMMON_BOUNDEDQUEUE_H
@@ -22,12 +22,15 @@
  *  Utility functions for manipulating date and time.
  */
 
+#include <ctime>
+
 #include "src/common/datetime.h"
 #include "src/common/error.h"
 
 using boost::posix_time::ptime;
 using boost::posix_time::second_clock;
 using boost::posix_time::from_iso_string;
+using boost::posix_time::from_time_t;
 using boost::posix_time::not_a_date_time;
 
 namespace Common {
@@ -58,6 +61,9 @@ DateTime::DateTime(const UString &value) : ptime(not_a_date_time) {
 	}
 }
 
+DateTime::DateTime(uint64 timestamp) : ptime(from_time_t((std::time_t) timestamp)) {
+}
+
 UString DateTime::formatDateISO(uint32 sep) const {
 	const UString sepStr(sep, sep ? 1 : 0);
 
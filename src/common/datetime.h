@@ -58,6 +58,12 @@ public:
 	 *               parts of the date and time not separated at all.
 	 */
 	DateTime(const UString &value);
+	/** Create a DateTime object from a timestamp.
+	 *
+	 *  @param timestamp The number of seconds since the Unix epoch, as returned
+	 *                   by std::time(). The point in time is expressed in UTC.
+	 */
+	explicit DateTime(uint64 timestamp);
 
 	/** Return the year in the Gregorian calendar. */
 	uint16 getYear () const { return date().year(); }
@@ -42,13 +42,7 @@ void debugC(Common::DebugChannel channel, uint32 level, const char *s, ...) {
 	vsnprintf(buf, STRINGBUFLEN, s, va);
 	va_end(va);
 
-#ifndef DISABLE_TEXT_CONSOLE
-	std::fputs(buf, stderr);
-	std::fputs("\n", stderr);
-#endif
-
-	DebugMan.logString(buf);
-	DebugMan.logString("\n");
+	DebugMan.logMessage(Common::kLogConsoleStdErr, true, "", buf, "\n");
 }
 
 void debugCN(Common::DebugChannel channel, uint32 level, const char *s, ...) {
@@ -62,9 +56,5 @@ void debugCN(Common::DebugChannel channel, uint32 level, const char *s, ...) {
 	vsnprintf(buf, STRINGBUFLEN, s, va);
 	va_end(va);
 
-#ifndef DISABLE_TEXT_CONSOLE
-	std::fputs(buf, stderr);
-#endif
-
-	DebugMan.logString(buf);
+	DebugMan.logMessage(Common::kLogConsoleStdErr, true, "", buf, "");
 }
@@ -24,6 +24,12 @@
  *  The debug manager, managing debug channels.
  */
 
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <SDL_timer.h>
+
 #include "src/version/version.h"
 
 #include "src/common/maths.h"
@@ -68,7 +74,12 @@ static const char * const kDebugGLTypes[kDebugGLTypeMAX] = {
 	"Error", "Deprecated", "Undefined", "Portability", "Performance", "Other"
 };
 
-DebugManager::DebugManager() : _logFileStartLine(false), _changedConfig(false) {
+/** The maximum time the log writer thread sleeps before looking for new messages, in ms. */
+static const uint32 kLogWriterInterval = 20;
+
+DebugManager::DebugManager() : _logFileStartLine(false), _logTimestampTime(0),
+	_logWriterRunning(false), _logProducers(0), _logDropped(0), _changedConfig(false) {
+
 	for (size_t i = 0; i < kDebugChannelCount; i++) {
 		_channels[i].name        = kDebugNames[i];
 		_channels[i].description = kDebugDescriptions[i];
@@ -84,6 +95,7 @@ DebugManager::DebugManager() : _logFileStartLine(false), _changedConfig(false) {
 }
 
 DebugManager::~DebugManager() {
+	stopLogWriter();
 	closeLogFile();
 }
 
@@ -219,8 +231,6 @@ void DebugManager::logDebugGL(DebugChannel channel, uint32 level, DebugGLType ty
 bool DebugManager::openLogFile(const UString &file) {
 	closeLogFile();
 
-	_logFileStartLine = true;
-
 	// Create the directories in the path, if necessary
 	UString path = FilePath::canonicalize(file);
 
@@ -230,8 +240,14 @@ bool DebugManager::openLogFile(const UString &file) {
 		return false;
 	}
 
-	if (!_logFile.open(path))
-		return false;
+	{
+		StackLock lock(_logMutex);
+
+		_logFileStartLine = true;
+
+		if (!_logFile.open(path))
+			return false;
+	}
 
 	logString(Version::getProjectNameVersionFull());
 	logString("\n");
@@ -240,38 +256,202 @@ bool DebugManager::openLogFile(const UString &file) {
 }
 
 void DebugManager::closeLogFile() {
+	flushLogQueue();
+
+	StackLock lock(_logMutex);
+
 	_logFile.close();
 }
 
+void DebugManager::startLogWriter() {
+	if (_logWriterRunning.exchange(true))
+		return;
+
+	if (!createThread()) {
+		_logWriterRunning.store(false);
+
+		warning("Failed to create the log writer thread: %s", SDL_GetError());
+	}
+}
+
+void DebugManager::stopLogWriter() {
+	if (!_logWriterRunning.exchange(false))
+		return;
+
+	_logCondition.signal();
+	destroyThread();
+
+	/* A producer might have seen the writer still running and be about to
+	 * queue a message. Wait for it, so that the message isn't lost. */
+	while (_logProducers.load() > 0)
+		SDL_Delay(1);
+
+	// Write what's left over in the queue
+	flushLogQueue();
+}
+
+void DebugManager::logMessage(LogConsole console, bool droppable, const char *prefix, const char *msg,
+                              const char *suffix) {
+
+	// Take the time now, so that a message waiting in the queue still gets the correct timestamp
+	const uint64 time = std::time(0);
+
+	const size_t prefixLength = std::strlen(prefix);
+	const size_t msgLength    = std::strlen(msg);
+	const size_t suffixLength = std::strlen(suffix);
+
+	const size_t length = prefixLength + msgLength + suffixLength;
+
+	if (length < kLogMessageLength) {
+		char text[kLogMessageLength];
+
+		std::memcpy(text                           , prefix, prefixLength);
+		std::memcpy(text + prefixLength            , msg   , msgLength);
+		std::memcpy(text + prefixLength + msgLength, suffix, suffixLength);
+
+		logText(console, droppable, time, text, length);
+		return;
+	}
+
+	// Too long to fit into one message. Split it up
+
+	logText(console, droppable, time, prefix, MIN<size_t>(prefixLength, kLogMessageLength));
+
+	for (size_t i = 0; i < msgLength; i += kLogMessageLength)
+		logText(console, droppable, time, msg + i, MIN<size_t>(msgLength - i, kLogMessageLength));
+
+	logText(console, droppable, time, suffix, MIN<size_t>(suffixLength, kLogMessageLength));
+}
+
 void DebugManager::logString(const UString &str) {
-	if (!_logFile.isOpen())
+	logMessage(kLogConsoleNone, false, "", str.c_str(), "");
+}
+
+void DebugManager::logText(LogConsole console, bool droppable, uint64 time, const char *text, size_t length) {
+	if (length == 0)
 		return;
 
-	// If we're at the start of a new line, write the timestamp
-	if (_logFileStartLine) {
-		UString tstamp;
+	/* Announce ourselves before looking at whether the writer is running.
+	 * Both are sequentially consistent, so stopLogWriter() either makes us
+	 * see the writer stopped, or waits for us to finish queueing. */
+	_logProducers.fetch_add(1);
+
+	bool handled = false;
+	while (_logWriterRunning.load()) {
+		if (queueLogMessage(console, time, text, length)) {
+			/* Only wake up the writer thread for important messages, or when the
+			 * queue is filling up. Otherwise, it'll get to them soon enough. */
+			if (!droppable || (_logQueue.size() >= (kLogQueueSize / 4)))
+				_logCondition.signal();
+
+			handled = true;
+			break;
+		}
 
-		try {
-			tstamp = "[" + DateTime(DateTime::kUTC).formatDateTimeISO('T', '-', ':') + "] ";
-		} catch (...) {
-			tstamp = "[0000-00-00T00:00:00] ";
+		// The queue is full. Debug messages are simply dropped, everything else waits
+		if (droppable) {
+			_logDropped.fetch_add(1, boost::memory_order_relaxed);
+
+			handled = true;
+			break;
 		}
 
-		_logFile.writeString(tstamp);
+		_logCondition.signal();
+		SDL_Delay(1);
 	}
 
-	_logFile.writeString(str);
+	_logProducers.fetch_sub(1);
+
+	if (handled)
+		return;
+
+	// No log writer thread, write the message directly
+	StackLock lock(_logMutex);
+
+	writeLogMessage(console, time, text, length);
 
-	// Find out whether we just started a new line. If this fails, force one
 	try {
-		_logFileStartLine = !str.empty() && (*--str.end() == '\n');
+		if (_logFileStartLine)
+			_logFile.flush();
 	} catch (...) {
-		_logFile.writeString("\n");
-		_logFileStartLine = true;
 	}
+}
 
-	if (_logFileStartLine)
+bool DebugManager::queueLogMessage(LogConsole console, uint64 time, const char *text, size_t length) {
+	LogMessage message;
+
+	message.time    = time;
+	message.console = console;
+	message.length  = length;
+
+	std::memcpy(message.text, text, length);
+
+	return _logQueue.tryPush(message);
+}
+
+void DebugManager::flushLogQueue() {
+	StackLock lock(_logMutex);
+
+	LogMessage message;
+	while (_logQueue.tryPop(message))
+		writeLogMessage(message.console, message.time, message.text, message.length);
+
+	const uint32 dropped = _logDropped.exchange(0);
+	if (dropped > 0) {
+		char text[64];
+		const int length = std::snprintf(text, sizeof(text), "[%u debug messages dropped]\n", dropped);
+
+		writeLogMessage(kLogConsoleStdErr, std::time(0), text, length);
+	}
+
+	try {
 		_logFile.flush();
+	} catch (...) {
+	}
+}
+
+void DebugManager::writeLogMessage(LogConsole console, uint64 time, const char *text, size_t length) {
+#ifndef DISABLE_TEXT_CONSOLE
+	if      (console == kLogConsoleStdOut)
+		std::fwrite(text, 1, length, stdout);
+	else if (console == kLogConsoleStdErr)
+		std::fwrite(text, 1, length, stderr);
+#endif
+
+	if (!_logFile.isOpen())
+		return;
+
+	// If we're at the start of a new line, write the timestamp
+	if (_logFileStartLine)
+		_logFile.writeString(getLogTimestamp(time));
+
+	_logFile.write(text, length);
+
+	_logFileStartLine = text[length - 1] == '\n';
+}
+
+const UString &DebugManager::getLogTimestamp(uint64 time) {
+	// The timestamp only has a resolution of seconds, so we can reuse it for most lines
+	if (!_logTimestamp.empty() && (time == _logTimestampTime))
+		return _logTimestamp;
+
+	try {
+		_logTimestamp = "[" + DateTime(time).formatDateTimeISO('T', '-', ':') + "] ";
+	} catch (...) {
+		_logTimestamp = "[0000-00-00T00:00:00] ";
+	}
+
+	_logTimestampTime = time;
+
+	return _logTimestamp;
+}
+
+void DebugManager::threadMethod() {
+	while (!_killThread) {
+		flushLogQueue();
+
+		_logCondition.wait(kLogWriterInterval);
+	}
 }
 
 void DebugManager::logCommandLine(const std::vector<UString> &argv) {
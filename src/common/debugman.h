@@ -27,13 +27,19 @@
 #ifndef COMMON_DEBUGMAN_H
 #define COMMON_DEBUGMAN_H
 
+#include "src/common/atomic.h"
+
 #include <vector>
 #include <map>
 
 #include "src/common/types.h"
+#include "src/common/system.h"
 #include "src/common/ustring.h"
 #include "src/common/singleton.h"
 #include "src/common/writefile.h"
+#include "src/common/mutex.h"
+#include "src/common/thread.h"
+#include "src/common/boundedqueue.h"
 
 namespace Common {
 
@@ -75,6 +81,13 @@ enum DebugGLType {
 	kDebugGLTypeMAX ///< For range checks.
 };
 
+/** Where a log message should be printed to, in addition to the log file. */
+enum LogConsole {
+	kLogConsoleNone,   ///< Only write the message into the log file.
+	kLogConsoleStdOut, ///< Also print the message to stdout.
+	kLogConsoleStdErr  ///< Also print the message to stderr.
+};
+
 /** The debug manager, managing debug channels.
  *
  *  A debug channel separates debug messages into groups, so debug output
@@ -102,8 +115,16 @@ enum DebugGLType {
  *  exceeds the current level of C1, which is 3. Likewise, the level of
  *  message 3, 1, exceeds the current level of C2. In fact, with a
  *  current level of 0, no messages will be shown for C2 at all, ever.
+ *
+ *  The debug manager also owns the log. While the log writer thread is
+ *  running, log messages are not written by the thread that produced them.
+ *  Instead, they are put into a fixed-size lock-free queue, together with
+ *  the time they were produced at, and the log writer thread then prints
+ *  them and writes them into the log file. Should the queue fill up, debug
+ *  channel messages are dropped (and the number of dropped messages noted
+ *  in the log), while all other messages wait for room in the queue.
  */
-class DebugManager : public Singleton<DebugManager> {
+class DebugManager : public Singleton<DebugManager>, public Thread {
 public:
 	static const uint32 kMaxVerbosityLevel = 9;
 
@@ -155,6 +176,25 @@ public:
 	/** Close the current log file. */
 	void closeLogFile();
 
+	/** Start the thread writing the log in the background. */
+	void startLogWriter();
+	/** Stop the log writer thread, after writing all queued log messages. */
+	void stopLogWriter();
+
+	/** Log (and print) a message.
+	 *
+	 *  The message written is the concatenation of the prefix, the message
+	 *  itself and the suffix.
+	 *
+	 *  @param console   Where to print the message to, apart from the log file.
+	 *  @param droppable May this message be dropped when the log queue is full?
+	 *  @param prefix    The string to write in front of the message.
+	 *  @param msg       The message to write.
+	 *  @param suffix    The string to write after the message.
+	 */
+	void logMessage(LogConsole console, bool droppable, const char *prefix, const char *msg,
+	                const char *suffix);
+
 	/** Log that string to the current log file. */
 	void logString(const UString &str);
 
@@ -165,6 +205,11 @@ public:
 	static UString getDefaultLogFile();
 
 private:
+	/** The maximum length of a single log message in the log queue. Longer messages are split. */
+	static const size_t kLogMessageLength = STRINGBUFLEN + 64;
+	/** The number of messages the log queue can hold. Needs to be a power of 2. */
+	static const size_t kLogQueueSize = 1024;
+
 	/** A debug channel. */
 	struct Channel {
 		UString name;        ///< The channel's name.
@@ -181,10 +226,51 @@ private:
 	Channel    _channels[kDebugChannelCount]; ///< All debug channels.
 	ChannelMap _channelMap;                   ///< Debug channels indexed by name.
 
+	/** A message in the log queue. */
+	struct LogMessage {
+		uint64 time; ///< The time this message was produced at, in seconds since the Unix epoch.
+
+		LogConsole console; ///< Where to print this message to.
+
+		size_t length;                ///< The length of the message text.
+		char text[kLogMessageLength]; ///< The message text.
+	};
+
 	WriteFile _logFile;
 	bool _logFileStartLine;
 
+	/** The time of the last timestamp written into the log file. */
+	uint64 _logTimestampTime;
+	/** The last timestamp written into the log file, already formatted. */
+	UString _logTimestamp;
+
+	/** Protects the log file and the reading end of the log queue. */
+	Mutex _logMutex;
+	/** Wakes up the log writer thread. */
+	Condition _logCondition;
+
+	BoundedQueue<LogMessage, kLogQueueSize> _logQueue; ///< The messages waiting to be written.
+
+	boost::atomic<bool>   _logWriterRunning; ///< Is the log writer thread running?
+	boost::atomic<uint32> _logProducers;     ///< Number of threads currently trying to queue a message.
+	boost::atomic<uint32> _logDropped;       ///< Number of messages dropped since last writing.
+
 	bool _changedConfig;
+
+	/** Log a single piece of text, no longer than kLogMessageLength. */
+	void logText(LogConsole console, bool droppable, uint64 time, const char *text, size_t length);
+
+	/** Try to put a message into the log queue. Returns false if the queue is full. */
+	bool queueLogMessage(LogConsole console, uint64 time, const char *text, size_t length);
+	/** Write all messages currently in the log queue. */
+	void flushLogQueue();
+
+	/** Print a message and write it into the log file. Needs the log mutex to be held. */
+	void writeLogMessage(LogConsole console, uint64 time, const char *text, size_t length);
+	/** Return a formatted timestamp for a log file line. Needs the log mutex to be held. */
+	const UString &getLogTimestamp(uint64 time);
+
+	void threadMethod();
 };
 
 } // End of namespace Common
@@ -27,12 +27,87 @@
 
 #include "src/common/filelist.h"
 #include "src/common/filepath.h"
+#include "src/common/ptrvector.h"
+#include "src/common/threadpool.h"
 
 // boost-filesystem stuff
 using boost::filesystem::directory_iterator;
 
 namespace Common {
 
+/** Reads the contents of a directory, starting new jobs for its subdirectories. */
+class FileList::DirectoryJob : public Job {
+public:
+	DirectoryJob(JobGroup *group, const UString &directory, int recurseDepth) :
+		_group(group), _directory(directory), _recurseDepth(recurseDepth), _success(true) {
+
+	}
+
+	void run() {
+		try {
+			// Iterator over the directory's contents
+			for (directory_iterator itEnd, itDir(_directory.c_str()); itDir != itEnd; ++itDir) {
+				const UString path = itDir->path().generic_string();
+
+				if (FilePath::isDirectory(path)) {
+					// It's a directory. Recurse into it if the depth limit wasn't yet reached
+
+					if ((_recurseDepth != 0) && _group) {
+						const int depth = (_recurseDepth == -1) ? -1 : (_recurseDepth - 1);
+
+						_subDirectories.push_back(new DirectoryJob(_group, path, depth));
+						_entries.push_back(Entry(_subDirectories.back()));
+
+						ThreadPoolMan.addJob(*_subDirectories.back(), *_group);
+					}
+
+				} else
+					// It's a path, add it to the list
+					_entries.push_back(Entry(FilePath::canonicalize(path, false)));
+
+			}
+		} catch (...) {
+			_success = false;
+		}
+	}
+
+	/** Add the files found to the list, stopping at the first directory that failed to be read. */
+	bool collect(Files &files) const {
+		for (std::list<Entry>::const_iterator e = _entries.begin(); e != _entries.end(); ++e) {
+			if (!e->subDirectory)
+				files.push_back(e->file);
+			else if (!e->subDirectory->collect(files))
+				return false;
+		}
+
+		return _success;
+	}
+
+private:
+	/** A file or a subdirectory, in the order they were found in. */
+	struct Entry {
+		UString file;
+		DirectoryJob *subDirectory;
+
+		Entry(const UString &f) : file(f), subDirectory(0) {
+		}
+
+		Entry(DirectoryJob *d) : subDirectory(d) {
+		}
+	};
+
+	JobGroup *_group;
+
+	UString _directory;
+	int _recurseDepth;
+
+	std::list<Entry> _entries;
+	PtrVector<DirectoryJob> _subDirectories;
+
+	bool _success;
+};
+
+
 FileList::FileList() {
 }
 
@@ -104,28 +179,20 @@ bool FileList::addDirectory(const UString &directory, int recurseDepth) {
 	if (!FilePath::isDirectory(directory))
 		return false;
 
-	try {
-		// Iterator over the directory's contents
-		for (directory_iterator itEnd, itDir(directory.c_str()); itDir != itEnd; ++itDir) {
-			const UString path = itDir->path().generic_string();
-
-			if (FilePath::isDirectory(path)) {
-				// It's a directory. Recurse into it if the depth limit wasn't yet reached
+	/* Reading directories mostly means waiting for the file system, so
+	 * all subdirectories are read in parallel, each in its own job on
+	 * the shared thread pool. The top directory is read right here, and
+	 * only if it has subdirectories do we need the pool at all. */
 
-				if (recurseDepth != 0)
-					if (!addDirectory(path, (recurseDepth == -1) ? -1 : (recurseDepth - 1)))
-						return false;
+	JobGroup group;
 
-			} else
-				// It's a path, add it to the list
-				_files.push_back(FilePath::canonicalize(path, false));
+	DirectoryJob job((recurseDepth != 0) ? &group : 0, directory, recurseDepth);
+	job.run();
 
-		}
-	} catch (...) {
-		return false;
-	}
+	if (!group.isDone())
+		ThreadPoolMan.wait(group);
 
-	return true;
+	return job.collect(_files);
 }
 
 bool FileList::getSubList(const UString &str, bool caseInsensitive, FileList &subList) const {
@@ -68,6 +68,9 @@ public:
 	const_iterator end() const;
 
 	/** Add a directory to the list
+	 *
+	 *  When recursing, the subdirectories are read in parallel. The files
+	 *  are still added in the same order as if they were read one by one.
 	 *
 	 *  @param  directory The directory to add.
 	 *  @param  recurseDepth The number of levels to recurse into subdirectories. 0
@@ -132,6 +135,8 @@ public:
 private:
 	typedef std::list<UString> Files;
 
+	class DirectoryJob;
+
 	Files _files;
 };
 
@@ -0,0 +1,400 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A lightweight profiler for the time spent in the parts of a frame.
+ */
+
+#include <map>
+#include <utility>
+#include <algorithm>
+
+#include <SDL_timer.h>
+
+#include "src/common/frameprofiler.h"
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/writefile.h"
+
+DECLARE_SINGLETON(Common::FrameProfiler)
+
+namespace Common {
+
+/** Number of events each thread remembers. */
+static const size_t kEventCount = 16384;
+
+/** Number of frames the zone statistics are calculated over. */
+static const size_t kFrameHistory = 120;
+
+static double ticksToMS(uint64 ticks) {
+	return (ticks * 1000.0) / SDL_GetPerformanceFrequency();
+}
+
+static UString escapeJSON(const UString &str) {
+	UString escaped;
+
+	for (UString::iterator c = str.begin(); c != str.end(); ++c) {
+		if ((*c == '"') || (*c == '\\'))
+			escaped += '\\';
+
+		escaped += *c;
+	}
+
+	return escaped;
+}
+
+
+FrameProfiler::ZoneStatistics::ZoneStatistics() : calls(0), min(0.0), avg(0.0), max(0.0) {
+}
+
+
+FrameProfiler::FrameTimes::FrameTimes() : time(0.0) {
+}
+
+
+FrameProfiler::ThreadBuffer::ThreadBuffer(uint32 i) : id(i), next(0), count(0) {
+	name = "Thread " + composeString(id);
+}
+
+
+FrameProfiler::FrameProfiler() : _enabled(false), _frameThread(0), _recording(false), _recordStart(0) {
+	_threadBuffer = SDL_TLSCreate();
+}
+
+FrameProfiler::~FrameProfiler() {
+}
+
+bool FrameProfiler::isEnabled() const {
+	return _enabled.load(boost::memory_order_relaxed);
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+	_enabled.store(enabled, boost::memory_order_relaxed);
+}
+
+void FrameProfiler::clear() {
+	StackLock lock(_mutex);
+
+	for (PtrVector<ThreadBuffer>::iterator t = _threads.begin(); t != _threads.end(); ++t) {
+		StackLock threadLock((*t)->mutex);
+
+		(*t)->next  = 0;
+		(*t)->count = 0;
+	}
+
+	_frames.clear();
+}
+
+uint64 FrameProfiler::getTicks() {
+	return SDL_GetPerformanceCounter();
+}
+
+FrameProfiler::ThreadBuffer &FrameProfiler::getThreadBuffer() {
+	ThreadBuffer *buffer = static_cast<ThreadBuffer *>(SDL_TLSGet(_threadBuffer));
+	if (buffer)
+		return *buffer;
+
+	StackLock lock(_mutex);
+
+	buffer = new ThreadBuffer(_threads.size());
+	_threads.push_back(buffer);
+
+	SDL_TLSSet(_threadBuffer, buffer, 0);
+
+	return *buffer;
+}
+
+void FrameProfiler::setThreadName(const UString &name) {
+	ThreadBuffer &buffer = getThreadBuffer();
+
+	StackLock lock(buffer.mutex);
+	buffer.name = name;
+}
+
+void FrameProfiler::addZone(const char *zone, uint64 start, uint64 end) {
+	ThreadBuffer &buffer = getThreadBuffer();
+
+	StackLock lock(buffer.mutex);
+
+	// Only threads that actually record zones get a ring buffer
+	if (buffer.events.empty())
+		buffer.events.resize(kEventCount);
+
+	Event &event = buffer.events[buffer.next];
+
+	event.zone  = zone;
+	event.start = start;
+	event.end   = end;
+
+	buffer.next  = (buffer.next + 1) % buffer.events.size();
+	buffer.count = MIN(buffer.count + 1, buffer.events.size());
+}
+
+void FrameProfiler::endFrame() {
+	if (!isEnabled())
+		return;
+
+	const uint64 now = getTicks();
+
+	StackLock lock(_mutex);
+
+	_frameThread = getThreadBuffer().id;
+
+	_frames.push_back(now);
+	while (_frames.size() > (kFrameHistory + 1))
+		_frames.pop_front();
+
+	// Only record whole frames
+	if (_recording && (_frames.size() >= 2) && (_frames[_frames.size() - 2] >= _recordStart))
+		recordFrame(_frames[_frames.size() - 2], now);
+}
+
+void FrameProfiler::startRecording() {
+	StackLock lock(_mutex);
+
+	_recording   = true;
+	_recordStart = getTicks();
+
+	_recordedFrames.clear();
+}
+
+void FrameProfiler::stopRecording() {
+	StackLock lock(_mutex);
+
+	_recording = false;
+}
+
+size_t FrameProfiler::getRecordedFrameCount() const {
+	StackLock lock(_mutex);
+
+	return _recordedFrames.size();
+}
+
+void FrameProfiler::getRecordedFrames(std::vector<FrameTimes> &frames) const {
+	StackLock lock(_mutex);
+
+	frames = _recordedFrames;
+}
+
+void FrameProfiler::recordFrame(uint64 start, uint64 end) {
+	_recordedFrames.push_back(FrameTimes());
+
+	FrameTimes &frame = _recordedFrames.back();
+	frame.time = ticksToMS(end - start);
+
+	for (PtrVector<ThreadBuffer>::const_iterator t = _threads.begin(); t != _threads.end(); ++t) {
+		const ThreadBuffer &buffer = **t;
+
+		StackLock threadLock(buffer.mutex);
+
+		/* Go backwards through the events. Since they're added when a zone ends,
+		 * they're sorted by their end, so we can stop at the first one that ended
+		 * before this frame started. */
+		for (size_t i = 0; i < buffer.count; i++) {
+			const Event &event = buffer.events[(buffer.next + buffer.events.size() - 1 - i) % buffer.events.size()];
+			if (event.end < start)
+				break;
+
+			if (event.end < end)
+				frame.zones[event.zone] += ticksToMS(event.end - event.start);
+		}
+	}
+}
+
+size_t FrameProfiler::getFrameCount() const {
+	StackLock lock(_mutex);
+
+	return _frames.empty() ? 0 : (_frames.size() - 1);
+}
+
+void FrameProfiler::getStatistics(std::vector<ZoneStatistics> &statistics) const {
+	StackLock lock(_mutex);
+
+	if (_frames.size() < 2)
+		return;
+
+	const std::vector<uint64> frames(_frames.begin(), _frames.end());
+	const size_t frameCount = frames.size() - 1;
+
+	// The time spent in each zone of each thread, per frame
+	typedef std::pair<uint32, UString> ZoneKey;
+	typedef std::map<ZoneKey, std::pair<uint64, std::vector<uint64> > > ZoneMap;
+
+	ZoneMap zones;
+	std::vector<UString> threadNames;
+
+	for (PtrVector<ThreadBuffer>::const_iterator t = _threads.begin(); t != _threads.end(); ++t) {
+		const ThreadBuffer &buffer = **t;
+
+		StackLock threadLock(buffer.mutex);
+
+		threadNames.push_back(buffer.name);
+		if (buffer.count == 0)
+			continue;
+
+		const size_t first = (buffer.next + buffer.events.size() - buffer.count) % buffer.events.size();
+		for (size_t i = 0; i < buffer.count; i++) {
+			const Event &event = buffer.events[(first + i) % buffer.events.size()];
+
+			if ((event.start < frames.front()) || (event.start >= frames.back()))
+				continue;
+
+			// Find the frame the zone was entered in
+			const size_t frame = (std::upper_bound(frames.begin(), frames.end(), event.start) - frames.begin()) - 1;
+
+			std::pair<uint64, std::vector<uint64> > &zone = zones[ZoneKey(buffer.id, event.zone)];
+			if (zone.second.empty())
+				zone.second.resize(frameCount, 0);
+
+			zone.first++;
+			zone.second[frame] += event.end - event.start;
+		}
+	}
+
+	// The frame time itself
+	ZoneStatistics frame;
+	frame.thread = (_frameThread < threadNames.size()) ? threadNames[_frameThread] : "";
+	frame.zone   = "Frame";
+	frame.calls  = frameCount;
+	frame.min    = ticksToMS(frames[1] - frames[0]);
+
+	for (size_t i = 0; i < frameCount; i++) {
+		const double time = ticksToMS(frames[i + 1] - frames[i]);
+
+		frame.min  = MIN(frame.min, time);
+		frame.max  = MAX(frame.max, time);
+		frame.avg += time / frameCount;
+	}
+
+	statistics.push_back(frame);
+
+	for (ZoneMap::const_iterator z = zones.begin(); z != zones.end(); ++z) {
+		ZoneStatistics zone;
+
+		zone.thread = threadNames[z->first.first];
+		zone.zone   = z->first.second;
+		zone.calls  = z->second.first;
+		zone.min    = ticksToMS(z->second.second[0]);
+
+		for (size_t i = 0; i < frameCount; i++) {
+			const double time = ticksToMS(z->second.second[i]);
+
+			zone.min  = MIN(zone.min, time);
+			zone.max  = MAX(zone.max, time);
+			zone.avg += time / frameCount;
+		}
+
+		statistics.push_back(zone);
+	}
+}
+
+void FrameProfiler::getReport(std::vector<UString> &lines) const {
+	std::vector<ZoneStatistics> statistics;
+	getStatistics(statistics);
+
+	if (statistics.empty()) {
+		lines.push_back("No frames profiled");
+		return;
+	}
+
+	lines.push_back(UString::format("%-10s %-18s %7s %7s %7s  (ms per frame, %u frames)",
+	                                "Thread", "Zone", "Min", "Avg", "Max", (uint) getFrameCount()));
+
+	for (std::vector<ZoneStatistics>::const_iterator s = statistics.begin(); s != statistics.end(); ++s)
+		lines.push_back(UString::format("%-10s %-18s %7.2f %7.2f %7.2f", s->thread.c_str(), s->zone.c_str(),
+		                                s->min, s->avg, s->max));
+}
+
+bool FrameProfiler::dumpTrace(const UString &fileName) const {
+	WriteFile file;
+	if (!file.open(fileName))
+		return false;
+
+	StackLock lock(_mutex);
+
+	// Find the earliest event, to make the timestamps relative to that
+	uint64 base = _frames.empty() ? getTicks() : _frames.front();
+	for (PtrVector<ThreadBuffer>::const_iterator t = _threads.begin(); t != _threads.end(); ++t) {
+		StackLock threadLock((*t)->mutex);
+		if ((*t)->count == 0)
+			continue;
+
+		const size_t first = ((*t)->next + (*t)->events.size() - (*t)->count) % (*t)->events.size();
+		base = MIN(base, (*t)->events[first].start);
+	}
+
+	const double frequency = SDL_GetPerformanceFrequency() / 1000000.0;
+
+	file.writeString("{\"traceEvents\":[\n");
+
+	bool firstEvent = true;
+	for (PtrVector<ThreadBuffer>::const_iterator t = _threads.begin(); t != _threads.end(); ++t) {
+		const ThreadBuffer &buffer = **t;
+
+		StackLock threadLock(buffer.mutex);
+
+		file.writeString(UString::format("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+		                                 "\"args\":{\"name\":\"%s\"}}", firstEvent ? "" : ",\n", buffer.id,
+		                                 escapeJSON(buffer.name).c_str()));
+		firstEvent = false;
+
+		if (buffer.count == 0)
+			continue;
+
+		const size_t first = (buffer.next + buffer.events.size() - buffer.count) % buffer.events.size();
+		for (size_t i = 0; i < buffer.count; i++) {
+			const Event &event = buffer.events[(first + i) % buffer.events.size()];
+
+			file.writeString(UString::format(",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+			                                 "\"pid\":1,\"tid\":%u}", escapeJSON(event.zone).c_str(),
+			                                 (event.start - base) / frequency,
+			                                 (event.end - event.start) / frequency, buffer.id));
+		}
+	}
+
+	// Mark the frame ends as instant events in the main thread
+	for (std::deque<uint64>::const_iterator f = _frames.begin(); f != _frames.end(); ++f)
+		file.writeString(UString::format("%s{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,"
+		                                 "\"pid\":1,\"tid\":%u}", firstEvent ? "" : ",\n", (*f - base) / frequency,
+		                                 _frameThread));
+
+	file.writeString("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	file.flush();
+	file.close();
+
+	return true;
+}
+
+
+ProfileZone::ProfileZone(const char *zone) : _zone(0), _start(0) {
+	if (!FrameProf.isEnabled())
+		return;
+
+	_zone  = zone;
+	_start = FrameProfiler::getTicks();
+}
+
+ProfileZone::~ProfileZone() {
+	if (_zone)
+		FrameProf.addZone(_zone, _start, FrameProfiler::getTicks());
+}
+
+} // End of namespace Common
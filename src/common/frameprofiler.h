@@ -0,0 +1,199 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A lightweight profiler for the time spent in the parts of a frame.
+ */
+
+#ifndef COMMON_FRAMEPROFILER_H
+#define COMMON_FRAMEPROFILER_H
+
+#include <vector>
+#include <deque>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+
+#include <SDL_thread.h>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/singleton.h"
+#include "src/common/mutex.h"
+#include "src/common/ptrvector.h"
+
+namespace Common {
+
+/** Records how long named zones of code take, in all threads.
+ *
+ *  Zones are measured with ProfileZone objects. Every thread records its
+ *  zones into its own ring buffer, which only holds the most recent events.
+ *  The main thread marks the end of every frame, so that the events of
+ *  all threads can be matched up with the frames they happened in.
+ *
+ *  From that, the profiler calculates the minimum, average and maximum
+ *  time spent in each zone per frame, over the last frames. The raw
+ *  events can also be written in the Chrome trace event format, to be
+ *  viewed in chrome://tracing or a compatible viewer.
+ *
+ *  Additionally, the profiler can record the time spent in each zone for
+ *  every single frame over a longer run, for example for benchmarking.
+ *  Zones are then counted towards the frame they ended in.
+ *
+ *  The profiler is disabled by default and can be enabled with the config
+ *  option "profile".
+ */
+class FrameProfiler : public Singleton<FrameProfiler> {
+public:
+	/** Statistics of one zone in one thread, over the last frames. */
+	struct ZoneStatistics {
+		UString thread; ///< Name of the thread the zone ran in.
+		UString zone;   ///< Name of the zone.
+
+		uint64 calls; ///< Number of times the zone was entered.
+
+		double min; ///< Minimum time spent in the zone per frame, in milliseconds.
+		double avg; ///< Average time spent in the zone per frame, in milliseconds.
+		double max; ///< Maximum time spent in the zone per frame, in milliseconds.
+
+		ZoneStatistics();
+	};
+
+	/** The times recorded for one frame. */
+	struct FrameTimes {
+		double time; ///< Duration of the whole frame, in milliseconds.
+
+		/** Time spent in each zone during the frame, summed over all threads, in milliseconds. */
+		std::map<UString, double> zones;
+
+		FrameTimes();
+	};
+
+	FrameProfiler();
+	~FrameProfiler();
+
+	bool isEnabled() const;
+	void setEnabled(bool enabled);
+
+	/** Forget all recorded events and frames. */
+	void clear();
+
+	/** Set the name the current thread is shown with. */
+	void setThreadName(const UString &name);
+
+	/** Record a zone the current thread spent time in.
+	 *
+	 *  @param zone  The name of the zone. Must stay valid forever, i.e.
+	 *               it should be a string literal.
+	 *  @param start Tick count when the zone was entered.
+	 *  @param end   Tick count when the zone was left.
+	 */
+	void addZone(const char *zone, uint64 start, uint64 end);
+
+	/** Mark the end of a frame. Should be called by the main thread only. */
+	void endFrame();
+
+	/** Return the number of frames the statistics are calculated over. */
+	size_t getFrameCount() const;
+
+	/** Calculate the statistics of all zones over the last frames. */
+	void getStatistics(std::vector<ZoneStatistics> &statistics) const;
+
+	/** Start recording the times of every frame, until stopRecording() is called. */
+	void startRecording();
+	/** Stop recording the times of every frame. */
+	void stopRecording();
+
+	/** Return the number of frames recorded so far. */
+	size_t getRecordedFrameCount() const;
+	/** Return the times of all frames recorded so far. */
+	void getRecordedFrames(std::vector<FrameTimes> &frames) const;
+
+	/** Create a human-readable report of the zone statistics. */
+	void getReport(std::vector<UString> &lines) const;
+
+	/** Write all recorded events into a file, in the Chrome trace event format. */
+	bool dumpTrace(const UString &fileName) const;
+
+	/** Return the current value of the high-resolution timer. */
+	static uint64 getTicks();
+
+private:
+	struct Event {
+		const char *zone;
+
+		uint64 start;
+		uint64 end;
+	};
+
+	struct ThreadBuffer {
+		UString name;
+		uint32 id;
+
+		mutable Mutex mutex;
+
+		std::vector<Event> events; ///< Ring buffer of the most recent events, allocated by the first event.
+		size_t next;               ///< Index the next event is written to.
+		size_t count;              ///< Number of valid events in the ring buffer.
+
+		ThreadBuffer(uint32 i);
+	};
+
+	boost::atomic<bool> _enabled;
+
+	SDL_TLSID _threadBuffer; ///< The current thread's ThreadBuffer.
+
+	mutable Mutex _mutex;
+
+	PtrVector<ThreadBuffer> _threads;
+	std::deque<uint64> _frames; ///< Tick counts of the most recent frame ends.
+
+	uint32 _frameThread; ///< ID of the thread that ends the frames.
+
+	bool   _recording;   ///< Are we recording the times of every frame?
+	uint64 _recordStart; ///< Tick count when the recording was started.
+
+	std::vector<FrameTimes> _recordedFrames;
+
+	ThreadBuffer &getThreadBuffer();
+
+	/** Record the times of the frame between these two tick counts. Needs _mutex to be held. */
+	void recordFrame(uint64 start, uint64 end);
+};
+
+/** Measures the time spent in the scope it lives in, as a profiler zone. */
+class ProfileZone : boost::noncopyable {
+public:
+	/** Enter a zone. The name must stay valid forever, i.e. it should be a string literal. */
+	ProfileZone(const char *zone);
+	~ProfileZone();
+
+private:
+	const char *_zone;
+	uint64 _start;
+};
+
+} // End of namespace Common
+
+/** Shortcut for accessing the frame profiler. */
+#define FrameProf Common::FrameProfiler::instance()
+
+#endif // COMMON_FRAMEPROFILER_H
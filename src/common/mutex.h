@@ -85,6 +85,8 @@ public:
 
 	bool wait(uint32 timeout = 0);
 	void signal();
+	/** Wake up all threads currently waiting on this condition. */
+	void broadcast();
 
 private:
 	bool _ownMutex;
@@ -0,0 +1,103 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Stable LSD radix sort over 64-bit sort keys.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "src/common/radixsort.h"
+
+namespace Common {
+
+static const size_t kDigitCount = 8;
+static const size_t kDigitSize  = 256;
+
+void radixSort(std::vector<SortKey> &keys, std::vector<SortKey> &scratch) {
+	const size_t count = keys.size();
+	if (count < 2)
+		return;
+
+	// Build the histograms of all digits in one pass
+	uint32 histogram[kDigitCount][kDigitSize];
+	std::memset(histogram, 0, sizeof(histogram));
+
+	for (size_t i = 0; i < count; i++) {
+		uint64 key = keys[i].key;
+
+		for (size_t d = 0; d < kDigitCount; d++, key >>= 8)
+			histogram[d][key & 0xFF]++;
+	}
+
+	scratch.resize(count);
+
+	SortKey *src = &keys[0];
+	SortKey *dst = &scratch[0];
+
+	for (size_t d = 0; d < kDigitCount; d++) {
+		uint32 *digit = histogram[d];
+
+		// All keys share this digit, so this pass wouldn't change anything
+		const size_t shift = d * 8;
+		if (digit[(src[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		uint32 offset = 0;
+		for (size_t i = 0; i < kDigitSize; i++) {
+			const uint32 n = digit[i];
+
+			digit[i] = offset;
+			offset  += n;
+		}
+
+		for (size_t i = 0; i < count; i++)
+			dst[digit[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if (src != &keys[0])
+		keys.swap(scratch);
+}
+
+void radixSort(std::vector<SortKey> &keys) {
+	std::vector<SortKey> scratch;
+
+	radixSort(keys, scratch);
+}
+
+uint32 floatToSortKey(float f) {
+	uint32 bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+
+	// Negative numbers have all bits flipped, positive ones only the sign bit
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+uint64 doubleToSortKey(double d) {
+	uint64 bits;
+	std::memcpy(&bits, &d, sizeof(bits));
+
+	return (bits & UINT64_C(0x8000000000000000)) ? ~bits : (bits | UINT64_C(0x8000000000000000));
+}
+
+} // End of namespace Common
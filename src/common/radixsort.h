@@ -0,0 +1,65 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Stable LSD radix sort over 64-bit sort keys.
+ */
+
+#ifndef COMMON_RADIXSORT_H
+#define COMMON_RADIXSORT_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A 64-bit sort key, referencing an element in another array. */
+struct SortKey {
+	uint64 key;   ///< The key to sort by, lowest first.
+	uint32 index; ///< Index of the element this key belongs to.
+
+	SortKey(uint64 k = 0, uint32 i = 0) : key(k), index(i) { }
+};
+
+/** Sort these keys by their key value, lowest first.
+ *
+ *  The sort is stable, so elements with equal keys keep their relative
+ *  order. It works on 8-bit digits and skips over all digits that are
+ *  the same in every key, so keys that only use a few bits are cheap.
+ *
+ *  @param keys    The keys to sort.
+ *  @param scratch Temporary storage, which will be resized as needed.
+ *                 Reusing it between calls avoids allocations.
+ */
+void radixSort(std::vector<SortKey> &keys, std::vector<SortKey> &scratch);
+
+/** Sort these keys by their key value, lowest first. */
+void radixSort(std::vector<SortKey> &keys);
+
+/** Map a float onto an unsigned integer with the same ordering. */
+uint32 floatToSortKey(float f);
+
+/** Map a double onto an unsigned integer with the same ordering. */
+uint64 doubleToSortKey(double d);
+
+} // End of namespace Common
+
+#endif // COMMON_RADIXSORT_H
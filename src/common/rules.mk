@@ -33,6 +33,8 @@ src_common_libcommon_la_SOURCES += \
     src/common/ptrlist.h \
     src/common/ptrvector.h \
     src/common/ptrmap.h \
+    src/common/timerwheel.h \
+    src/common/boundedqueue.h \
     src/common/singleton.h \
     src/common/maths.h \
     src/common/sinetables.h \
@@ -45,6 +47,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/threads.h \
     src/common/thread.h \
     src/common/mutex.h \
+    src/common/threadpool.h \
     src/common/ustring.h \
     src/common/hash.h \
     src/common/md5.h \
@@ -63,6 +66,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/datetime.h \
     src/common/readstream.h \
     src/common/memreadstream.h \
+    src/common/streamview.h \
     src/common/writestream.h \
     src/common/memwritestream.h \
     src/common/streamtokenizer.h \
@@ -73,6 +77,8 @@ src_common_libcommon_la_SOURCES += \
     src/common/filepath.h \
     src/common/filelist.h \
     src/common/binsearch.h \
+    src/common/radixsort.h \
+    src/common/frameprofiler.h \
     src/common/bitstream.h \
     src/common/huffman.h \
     src/common/vector3.h \
@@ -100,6 +106,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/threads.cpp \
     src/common/thread.cpp \
     src/common/mutex.cpp \
+    src/common/threadpool.cpp \
     src/common/ustring.cpp \
     src/common/md5.cpp \
     src/common/blowfish.cpp \
@@ -116,6 +123,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/datetime.cpp \
     src/common/readstream.cpp \
     src/common/memreadstream.cpp \
+    src/common/streamview.cpp \
     src/common/writestream.cpp \
     src/common/memwritestream.cpp \
     src/common/streamtokenizer.cpp \
@@ -125,6 +133,8 @@ src_common_libcommon_la_SOURCES += \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
     src/common/filelist.cpp \
+    src/common/radixsort.cpp \
+    src/common/frameprofiler.cpp \
     src/common/huffman.cpp \
     src/common/matrix4x4.cpp \
     src/common/boundingbox.cpp \
@@ -0,0 +1,165 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bounded, reference-counted views into a shared stream.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "src/common/streamview.h"
+#include "src/common/memreadstream.h"
+#include "src/common/scopedptr.h"
+#include "src/common/mutex.h"
+#include "src/common/error.h"
+
+namespace Common {
+
+/** The stream shared by all views. */
+struct SeekableStreamView::Storage {
+	ScopedPtr<SeekableReadStream> stream;
+
+	/** The memory behind the stream, if the stream is a MemoryReadStream. */
+	const byte *data;
+
+	/** Serializes the seek and read pairs on the stream. */
+	Mutex mutex;
+
+	Storage(SeekableReadStream *s) : stream(s), data(0) {
+		MemoryReadStream *memStream = dynamic_cast<MemoryReadStream *>(s);
+		if (memStream)
+			data = memStream->getData();
+	}
+};
+
+
+SeekableStreamView::SeekableStreamView(const boost::shared_ptr<Storage> &storage,
+                                       size_t begin, size_t end) :
+	_storage(storage), _begin(begin), _end(end), _pos(begin), _eos(false) {
+
+	assert(_begin <= _end);
+	assert(_end <= _storage->stream->size());
+}
+
+SeekableStreamView::~SeekableStreamView() {
+}
+
+SeekableStreamView *SeekableStreamView::wrap(SeekableReadStream *stream) {
+	assert(stream);
+
+	SeekableStreamView *view = dynamic_cast<SeekableStreamView *>(stream);
+	if (view)
+		return view;
+
+	ScopedPtr<SeekableReadStream> owned(stream);
+
+	const size_t size = owned->size();
+	if (size == kSizeInvalid)
+		throw Exception("Can't create a view of a stream with unknown size");
+
+	boost::shared_ptr<Storage> storage(new Storage(owned.get()));
+	owned.release();
+
+	return new SeekableStreamView(storage, 0, size);
+}
+
+SeekableStreamView *SeekableStreamView::createView(size_t begin, size_t end) const {
+	if ((begin > end) || (end > size()))
+		throw Exception("Invalid stream view range (%u - %u/%u)", (uint)begin, (uint)end, (uint)size());
+
+	return new SeekableStreamView(_storage, _begin + begin, _begin + end);
+}
+
+MemoryReadStream *SeekableStreamView::copyRange(size_t begin, size_t end) const {
+	if ((begin > end) || (end > size()))
+		throw Exception("Invalid stream view range (%u - %u/%u)", (uint)begin, (uint)end, (uint)size());
+
+	const size_t dataSize = end - begin;
+
+	ScopedArray<byte> buf(new byte[dataSize]);
+	if (readAt(_begin + begin, buf.get(), dataSize) != dataSize)
+		throw Exception(kReadError);
+
+	return new MemoryReadStream(buf.release(), dataSize, true);
+}
+
+long SeekableStreamView::getViewCount() const {
+	return _storage.use_count();
+}
+
+size_t SeekableStreamView::readAt(size_t position, void *dataPtr, size_t dataSize) const {
+	if (dataSize == 0)
+		return 0;
+
+	if (_storage->data) {
+		std::memcpy(dataPtr, _storage->data + position, dataSize);
+		return dataSize;
+	}
+
+	StackLock lock(_storage->mutex);
+
+	_storage->stream->seek(position);
+
+	return _storage->stream->read(dataPtr, dataSize);
+}
+
+bool SeekableStreamView::eos() const {
+	return _eos;
+}
+
+size_t SeekableStreamView::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	if (dataSize > (_end - _pos)) {
+		dataSize = _end - _pos;
+		_eos = true;
+	}
+
+	dataSize = readAt(_pos, dataPtr, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+size_t SeekableStreamView::pos() const {
+	return _pos - _begin;
+}
+
+size_t SeekableStreamView::size() const {
+	return _end - _begin;
+}
+
+size_t SeekableStreamView::seek(ptrdiff_t offset, Origin whence) {
+	assert(_pos >= _begin);
+	assert(_pos <= _end);
+
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, _begin, size());
+	if ((newPos < _begin) || (newPos > _end))
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false; // reset eos on successful seek
+
+	return oldPos - _begin;
+}
+
+} // End of namespace Common
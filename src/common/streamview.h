@@ -0,0 +1,105 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Bounded, reference-counted views into a shared stream.
+ */
+
+#ifndef COMMON_STREAMVIEW_H
+#define COMMON_STREAMVIEW_H
+
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/readstream.h"
+
+namespace Common {
+
+class MemoryReadStream;
+
+/** A view into the range [begin, end) of a shared SeekableReadStream.
+ *
+ *  All views created from one stream reference the same stream, which
+ *  is only destroyed when the last view goes away. Unlike with a
+ *  SeekableSubReadStream, every view has its own position, and reads
+ *  through different views don't step on each others toes, even when
+ *  they happen in different threads.
+ *
+ *  A view created from a view references the original stream directly.
+ *  An archive found within an archive within another archive therefore
+ *  still reads straight from the outermost file, without any copying.
+ *
+ *  If the shared stream is a MemoryReadStream, reads are served directly
+ *  from its memory, without locking.
+ */
+class SeekableStreamView : public SeekableReadStream {
+public:
+	/** Create a view of the whole stream, taking over ownership of the stream.
+	 *
+	 *  If the stream already is a SeekableStreamView, it is returned as is.
+	 */
+	static SeekableStreamView *wrap(SeekableReadStream *stream);
+
+	~SeekableStreamView();
+
+	/** Create a new view of the range [begin, end) of this view.
+	 *
+	 *  The new view is independent of this one, and can outlive it.
+	 */
+	SeekableStreamView *createView(size_t begin, size_t end) const;
+
+	/** Copy the range [begin, end) of this view into memory.
+	 *
+	 *  This does not change the position of this view.
+	 */
+	MemoryReadStream *copyRange(size_t begin, size_t end) const;
+
+	/** Return the number of views currently referencing the shared stream. */
+	long getViewCount() const;
+
+	bool eos() const;
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+private:
+	struct Storage;
+
+	boost::shared_ptr<Storage> _storage;
+
+	size_t _begin; ///< Start of the view within the shared stream.
+	size_t _end;   ///< End of the view within the shared stream.
+	size_t _pos;   ///< Current position within the shared stream.
+
+	bool _eos;
+
+	SeekableStreamView(const boost::shared_ptr<Storage> &storage, size_t begin, size_t end);
+
+	/** Read from an absolute position of the shared stream. */
+	size_t readAt(size_t position, void *dataPtr, size_t dataSize) const;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_STREAMVIEW_H
@@ -0,0 +1,254 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads running queued jobs.
+ */
+
+#include "src/common/atomic.h"
+
+#include <cassert>
+#include <exception>
+
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
+
+#include "src/common/threadpool.h"
+#include "src/common/thread.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+DECLARE_SINGLETON(Common::ThreadPoolManager)
+
+namespace Common {
+
+Job::Job() : _group(0) {
+}
+
+Job::~Job() {
+}
+
+
+JobGroup::JobGroup() : _finished(_mutex), _pending(0) {
+}
+
+JobGroup::~JobGroup() {
+	assert(_pending == 0);
+}
+
+size_t JobGroup::getPendingCount() {
+	StackLock lock(_mutex);
+
+	return _pending;
+}
+
+bool JobGroup::isDone() {
+	return getPendingCount() == 0;
+}
+
+
+class ThreadPool::Worker : public Thread {
+public:
+	Worker(ThreadPool &pool) : _pool(&pool), _threadID(0) {
+	}
+
+	~Worker() {
+		destroyThread();
+	}
+
+	bool isCurrentThread() const {
+		return _threadID.load() == SDL_ThreadID();
+	}
+
+private:
+	ThreadPool *_pool;
+
+	boost::atomic<SDL_threadID> _threadID;
+
+	void threadMethod() {
+		_threadID.store(SDL_ThreadID());
+
+		while (!_killThread && !_pool->_shutdown.load()) {
+			Job *job = _pool->takeJob(true);
+			if (job)
+				_pool->runJob(*job);
+		}
+	}
+};
+
+
+ThreadPool::ThreadPool(size_t threadCount) : _idle(_queueMutex), _running(0), _shutdown(false) {
+	if (threadCount == 0)
+		threadCount = MAX<size_t>(getCPUCount(), 2) - 1;
+
+	_workers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++) {
+		_workers.push_back(new Worker(*this));
+
+		if (!_workers.back()->createThread())
+			throw Exception("Failed to create worker thread: %s", SDL_GetError());
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	/* Run whatever is still queued, then wait for the workers to finish
+	 * their current jobs. Only then can we safely kill the threads. */
+
+	Job *job;
+	while ((job = takeJob(false)))
+		runJob(*job);
+
+	_queueMutex.lock();
+	while (!_queue.empty() || (_running > 0))
+		_idle.wait(10);
+	_queueMutex.unlock();
+
+	// Wake up all idle workers, so they notice they should quit right away
+	_shutdown.store(true);
+	for (size_t i = 0; i < _workers.size(); i++)
+		_jobsAvailable.unlock();
+
+	_workers.clear();
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return _workers.size();
+}
+
+bool ThreadPool::isWorkerThread() const {
+	for (PtrVector<Worker>::const_iterator w = _workers.begin(); w != _workers.end(); ++w)
+		if ((*w)->isCurrentThread())
+			return true;
+
+	return false;
+}
+
+size_t ThreadPool::getCPUCount() {
+	const int count = SDL_GetCPUCount();
+
+	return (count > 0) ? count : 1;
+}
+
+void ThreadPool::addJob(Job &job, JobGroup &group) {
+	{
+		StackLock lock(group._mutex);
+
+		group._pending++;
+	}
+
+	job._group = &group;
+
+	{
+		StackLock lock(_queueMutex);
+
+		_queue.push_back(&job);
+	}
+
+	_jobsAvailable.unlock();
+}
+
+void ThreadPool::wait(JobGroup &group) {
+	while (!group.isDone()) {
+		Job *job = takeJob(false, &group);
+		if (job) {
+			runJob(*job);
+			continue;
+		}
+
+		// Nothing left to help out with, wait for the workers to finish the rest
+		group._mutex.lock();
+		if (group._pending > 0)
+			group._finished.wait(10);
+		group._mutex.unlock();
+	}
+}
+
+Job *ThreadPool::takeJob(bool block, const JobGroup *group) {
+	const bool available = block ? _jobsAvailable.lock(100) : _jobsAvailable.lockTry();
+	if (!available)
+		return 0;
+
+	StackLock lock(_queueMutex);
+
+	std::deque<Job *>::iterator j = _queue.begin();
+	if (group)
+		while ((j != _queue.end()) && ((*j)->_group != group))
+			++j;
+
+	if (j == _queue.end()) {
+		// Nothing of this group is queued, so leave the job we took to someone else
+		if (group)
+			_jobsAvailable.unlock();
+
+		// Without a group, this only happens when woken up to quit
+		return 0;
+	}
+
+	Job *job = *j;
+	_queue.erase(j);
+
+	_running++;
+
+	return job;
+}
+
+void ThreadPool::runJob(Job &job) {
+	JobGroup *group = job._group;
+
+	try {
+		job.run();
+	} catch (Exception &e) {
+		printException(e, "WARNING: ");
+	} catch (std::exception &e) {
+		Exception se(e);
+
+		printException(se, "WARNING: ");
+	} catch (...) {
+		Exception se("Unknown exception in thread pool job");
+
+		printException(se, "WARNING: ");
+	}
+
+	// The job might be gone as soon as we notify its group, so don't touch it afterwards
+
+	{
+		StackLock lock(group->_mutex);
+
+		assert(group->_pending > 0);
+		if (--group->_pending == 0)
+			group->_finished.broadcast();
+	}
+
+	{
+		StackLock lock(_queueMutex);
+
+		_running--;
+		_idle.broadcast();
+	}
+}
+
+
+ThreadPoolManager::ThreadPoolManager() {
+}
+
+ThreadPoolManager::~ThreadPoolManager() {
+}
+
+} // End of namespace Common
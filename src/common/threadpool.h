@@ -0,0 +1,158 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads running queued jobs.
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "src/common/atomic.h"
+
+#include <deque>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/mutex.h"
+#include "src/common/ptrvector.h"
+#include "src/common/singleton.h"
+
+namespace Common {
+
+class JobGroup;
+
+/** A unit of work that can be run by a ThreadPool.
+ *
+ *  The job is not owned by the pool, and needs to stay valid until
+ *  it has finished running.
+ */
+class Job : boost::noncopyable {
+public:
+	Job();
+	virtual ~Job();
+
+	/** Do the actual work. Called from within one of the pool's threads. */
+	virtual void run() = 0;
+
+private:
+	JobGroup *_group;
+
+	friend class ThreadPool;
+};
+
+/** A collection of jobs that can be waited upon as a whole. */
+class JobGroup : boost::noncopyable {
+public:
+	JobGroup();
+	~JobGroup();
+
+	/** Return the number of jobs in this group that haven't finished yet. */
+	size_t getPendingCount();
+
+	/** Have all the jobs in this group finished? */
+	bool isDone();
+
+private:
+	Mutex     _mutex;
+	Condition _finished;
+
+	size_t _pending;
+
+	friend class ThreadPool;
+};
+
+/** A pool of worker threads.
+ *
+ *  Jobs are queued into the pool and run in the order they were added,
+ *  by whichever worker thread is free first. A thread waiting for a
+ *  group of jobs to finish will help out by running queued jobs of that
+ *  group itself in the meantime, so waiting on a pool never wastes a core.
+ *
+ *  Jobs must not throw. Exceptions that leak out of a job are caught
+ *  and printed as warnings.
+ */
+class ThreadPool : boost::noncopyable {
+public:
+	/** Create a thread pool.
+	 *
+	 *  @param threadCount The number of worker threads to start. 0 means
+	 *                     one thread less than there are CPU cores, since
+	 *                     the thread waiting on a job group helps out.
+	 */
+	ThreadPool(size_t threadCount = 0);
+	~ThreadPool();
+
+	/** Return the number of worker threads in this pool. */
+	size_t getThreadCount() const;
+
+	/** Is the calling thread one of this pool's worker threads? */
+	bool isWorkerThread() const;
+
+	/** Queue a job, as part of a job group. */
+	void addJob(Job &job, JobGroup &group);
+
+	/** Wait until all jobs of this group have finished. */
+	void wait(JobGroup &group);
+
+	/** Return the number of CPU cores in this system. */
+	static size_t getCPUCount();
+
+private:
+	class Worker;
+
+	PtrVector<Worker> _workers;
+
+	Mutex     _queueMutex;
+	Condition _idle;
+	Semaphore _jobsAvailable;
+
+	std::deque<Job *> _queue;
+	size_t _running;
+
+	boost::atomic<bool> _shutdown; ///< Are the workers supposed to quit?
+
+	/** Take the next queued job, optionally only one of a certain group. */
+	Job *takeJob(bool block, const JobGroup *group = 0);
+	void runJob(Job &job);
+};
+
+/** The thread pool shared by all of xoreos' subsystems.
+ *
+ *  Everything that wants to run jobs in parallel should queue them here,
+ *  instead of starting its own pool, so that we don't oversubscribe the
+ *  CPU with several pools of threads all competing for the same cores.
+ *
+ *  The pool has to be created from the main thread, before any of the
+ *  other threads that use it exist.
+ */
+class ThreadPoolManager : public ThreadPool, public Singleton<ThreadPoolManager> {
+public:
+	ThreadPoolManager();
+	~ThreadPoolManager();
+};
+
+} // End of namespace Common
+
+/** Shortcut for accessing the shared thread pool. */
+#define ThreadPoolMan ::Common::ThreadPoolManager::instance()
+
+#endif // COMMON_THREADPOOL_H
@@ -0,0 +1,250 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A hierarchical timing wheel.
+ */
+
+#ifndef COMMON_TIMERWHEEL_H
+#define COMMON_TIMERWHEEL_H
+
+#include <list>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A hierarchical timing wheel, holding values that are due at a certain time.
+ *
+ *  Times are measured in ticks, usually milliseconds. The wheel consists of
+ *  several levels of slots. The first level has a slot for each of the next
+ *  256 ticks, the second level a slot for each of the next 256 blocks of 256
+ *  ticks, and so on. A value is put into the slot of the lowest level that
+ *  covers its time. Whenever the wheel advances to the start of a block, the
+ *  values in that block's slot cascade down into the level below.
+ *
+ *  This makes adding and removing a value O(1), no matter how many values the
+ *  wheel holds. Advancing the wheel only needs to look at the slots of the
+ *  ticks that passed, and skips over empty stretches quickly.
+ */
+template<typename T>
+class TimerWheel : boost::noncopyable {
+private:
+	/** A value in the wheel. */
+	struct Entry {
+		T value;     ///< The value itself.
+		uint64 time; ///< The tick the value is due at.
+
+		size_t level; ///< The level of the slot the value is in.
+		size_t slot;  ///< The slot the value is in.
+
+		Entry(const T &v, uint64 t) : value(v), time(t), level(0), slot(0) {
+		}
+	};
+
+	typedef std::list<Entry> Slot;
+
+public:
+	/** Identifies a value in the wheel. Becomes invalid once the value is due. */
+	typedef typename Slot::iterator ID;
+
+	TimerWheel() : _current(0), _pending(0), _fired(0) {
+		for (size_t i = 0; i <= kLevels; i++)
+			_levelCount[i] = 0;
+	}
+
+	/** Add a value that is due at this tick. Values already due are returned by the next advance(). */
+	ID add(uint64 time, const T &value) {
+		Slot entry;
+		entry.push_back(Entry(value, time));
+
+		ID id = entry.begin();
+		place(entry, id);
+
+		_pending++;
+		return id;
+	}
+
+	/** Remove a value that isn't due yet. */
+	void remove(ID id) {
+		_levelCount[id->level]--;
+		_pending--;
+
+		getSlot(id->level, id->slot).erase(id);
+	}
+
+	/** Remove all values. */
+	void clear() {
+		_due.clear();
+		for (size_t i = 0; i < kLevels; i++)
+			for (size_t j = 0; j < kSlots; j++)
+				_slots[i][j].clear();
+
+		for (size_t i = 0; i <= kLevels; i++)
+			_levelCount[i] = 0;
+
+		_pending = 0;
+	}
+
+	/** Remove all values, appending them to the list, in no particular order. */
+	void clear(std::list<T> &values) {
+		for (size_t i = 0; i < kLevels; i++)
+			for (size_t j = 0; j < kSlots; j++)
+				for (typename Slot::const_iterator e = _slots[i][j].begin(); e != _slots[i][j].end(); ++e)
+					values.push_back(e->value);
+
+		for (typename Slot::const_iterator e = _due.begin(); e != _due.end(); ++e)
+			values.push_back(e->value);
+
+		clear();
+	}
+
+	/** Advance the wheel up to and including this tick.
+	 *
+	 *  All values that became due are removed from the wheel and appended to
+	 *  the list, ordered by the tick they were due at.
+	 */
+	void advance(uint64 now, std::list<T> &expired) {
+		fire(_due, kLevels, expired);
+
+		while ((_pending > 0) && (_current <= now)) {
+			// At the start of a block, move the values of its slot down one level
+			for (size_t level = kLevels - 1; level > 0; level--)
+				if ((_current & (getLevelSize(level) - 1)) == 0)
+					cascade(level, (_current >> (kSlotBits * level)) & (kSlots - 1));
+
+			fire(_slots[0][_current & (kSlots - 1)], 0, expired);
+
+			// Skip the ticks of blocks that are completely empty
+			uint64 next = _current + 1;
+			for (size_t level = 0; (level < (kLevels - 1)) && (_levelCount[level] == 0); level++) {
+				const uint64 size = getLevelSize(level + 1);
+
+				next = (_current + size) & ~(size - 1);
+			}
+
+			_current = (next <= now) ? next : (now + 1);
+		}
+
+		if (_current <= now)
+			_current = now + 1;
+	}
+
+	/** Are there no values in the wheel? */
+	bool empty() const {
+		return _pending == 0;
+	}
+
+	/** Return the number of values not yet due. */
+	size_t getPending() const {
+		return _pending;
+	}
+
+	/** Return the number of values that became due so far. */
+	uint64 getFired() const {
+		return _fired;
+	}
+
+private:
+	static const size_t kLevels   = 4;
+	static const size_t kSlotBits = 8;
+	static const size_t kSlots    = 1 << kSlotBits;
+
+	Slot _slots[kLevels][kSlots]; ///< The slots of all levels.
+	Slot _due;                    ///< Values that were already due when added.
+
+	/** The number of values in each level, with the already due values last. */
+	size_t _levelCount[kLevels + 1];
+
+	uint64 _current; ///< The next tick to advance to.
+
+	size_t _pending; ///< The number of values in the wheel.
+	uint64 _fired;   ///< The number of values that became due so far.
+
+
+	static uint64 getLevelSize(size_t level) {
+		return ((uint64) 1) << (kSlotBits * level);
+	}
+
+	Slot &getSlot(size_t level, size_t slot) {
+		if (level == kLevels)
+			return _due;
+
+		return _slots[level][slot];
+	}
+
+	/** Move an entry from a list into the slot covering its time. */
+	void place(Slot &from, ID id) {
+		size_t level = kLevels;
+		size_t slot  = 0;
+
+		if (id->time >= _current) {
+			// Find the lowest level where the time is within the current block
+			for (level = 0; level < (kLevels - 1); level++)
+				if ((id->time >> (kSlotBits * (level + 1))) == (_current >> (kSlotBits * (level + 1))))
+					break;
+
+			slot = (id->time >> (kSlotBits * level)) & (kSlots - 1);
+		}
+
+		id->level = level;
+		id->slot  = slot;
+
+		_levelCount[level]++;
+
+		// Splicing keeps the ID valid
+		Slot &to = getSlot(level, slot);
+		to.splice(to.end(), from, id);
+	}
+
+	/** Move the values of a slot into the slots of the levels below. */
+	void cascade(size_t level, size_t slot) {
+		Slot entries;
+		entries.splice(entries.end(), _slots[level][slot]);
+
+		_levelCount[level] -= entries.size();
+
+		while (!entries.empty())
+			place(entries, entries.begin());
+	}
+
+	/** Remove all values of a slot, as they are due. */
+	void fire(Slot &slot, size_t level, std::list<T> &expired) {
+		if (slot.empty())
+			return;
+
+		const size_t count = slot.size();
+
+		for (typename Slot::iterator e = slot.begin(); e != slot.end(); ++e)
+			expired.push_back(e->value);
+
+		slot.clear();
+
+		_levelCount[level] -= count;
+		_pending           -= count;
+		_fired             += count;
+	}
+};
+
+} // End of namespace Common
+
+#endif // COMMON_TIMERWHEEL_H
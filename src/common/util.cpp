@@ -38,15 +38,7 @@ void warning(const char *s, ...) {
 	vsnprintf(buf, STRINGBUFLEN, s, va);
 	va_end(va);
 
-#ifndef DISABLE_TEXT_CONSOLE
-	std::fputs("WARNING: ", stderr);
-	std::fputs(buf, stderr);
-	std::fputs("!\n", stderr);
-#endif
-
-	DebugMan.logString("WARNING: ");
-	DebugMan.logString(buf);
-	DebugMan.logString("!\n");
+	DebugMan.logMessage(Common::kLogConsoleStdErr, false, "WARNING: ", buf, "!\n");
 }
 
 void status(const char *s, ...) {
@@ -57,13 +49,7 @@ void status(const char *s, ...) {
 	vsnprintf(buf, STRINGBUFLEN, s, va);
 	va_end(va);
 
-#ifndef DISABLE_TEXT_CONSOLE
-	std::fputs(buf, stderr);
-	std::fputs("\n", stderr);
-#endif
-
-	DebugMan.logString(buf);
-	DebugMan.logString("\n");
+	DebugMan.logMessage(Common::kLogConsoleStdErr, false, "", buf, "\n");
 }
 
 void info(const char *s, ...) {
@@ -74,13 +60,7 @@ void info(const char *s, ...) {
 	vsnprintf(buf, STRINGBUFLEN, s, va);
 	va_end(va);
 
-#ifndef DISABLE_TEXT_CONSOLE
-	std::fputs(buf, stdout);
-	std::fputs("\n", stdout);
-#endif
-
-	DebugMan.logString(buf);
-	DebugMan.logString("\n");
+	DebugMan.logMessage(Common::kLogConsoleStdOut, false, "", buf, "\n");
 }
 
 void NORETURN_PRE error(const char *s, ...) {
@@ -91,15 +71,10 @@ void NORETURN_PRE error(const char *s, ...) {
 	vsnprintf(buf, STRINGBUFLEN, s, va);
 	va_end(va);
 
-#ifndef DISABLE_TEXT_CONSOLE
-	std::fputs("ERROR: ", stderr);
-	std::fputs(buf, stderr);
-	std::fputs("!\n", stderr);
-#endif
+	DebugMan.logMessage(Common::kLogConsoleStdErr, false, "ERROR: ", buf, "!\n");
 
-	DebugMan.logString("ERROR: ");
-	DebugMan.logString(buf);
-	DebugMan.logString("!\n");
+	// Make sure everything has been written before we exit
+	DebugMan.stopLogWriter();
 
 	std::exit(1);
 }
@@ -33,7 +33,7 @@
 
 namespace Common {
 
-ZipFile::ZipFile(SeekableReadStream *zip) : _zip(zip) {
+ZipFile::ZipFile(SeekableReadStream *zip) : _zip(SeekableStreamView::wrap(zip)) {
 	assert(_zip);
 
 	load(*_zip);
@@ -74,7 +74,11 @@ void ZipFile::load(SeekableReadStream &zip) {
 		 File  file;
 		IFile iFile;
 
-		zip.skip(20);
+		zip.skip(6); // Versions and flags
+
+		iFile.method = zip.readUint16LE();
+
+		zip.skip(12); // Time, date, CRC and compressed size
 
 		iFile.size = zip.readUint32LE();
 
@@ -155,6 +159,10 @@ size_t ZipFile::getFileSize(uint32 index) const {
 	return getIFile(index).size;
 }
 
+bool ZipFile::isFileCompressed(uint32 index) const {
+	return getIFile(index).method != 0;
+}
+
 SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	const IFile &file = getIFile(index);
 
@@ -165,7 +173,7 @@ SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	getFileProperties(*_zip, file, compMethod, compSize, realSize);
 
 	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+		return _zip->createView(_zip->pos(), _zip->pos() + compSize);
 
 	return decompressFile(*_zip, compMethod, compSize, realSize);
 }
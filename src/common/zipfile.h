@@ -32,6 +32,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/streamview.h"
 #include "src/common/ustring.h"
 
 namespace Common {
@@ -58,6 +59,9 @@ public:
 	/** Return the size of a file. */
 	size_t getFileSize(uint32 index) const;
 
+	/** Is this file stored compressed? */
+	bool isFileCompressed(uint32 index) const;
+
 	/** Return a stream of the file's contents. */
 	SeekableReadStream *getFile(uint32 index, bool tryNoCopy = false) const;
 
@@ -66,11 +70,12 @@ private:
 	struct IFile {
 		uint32 offset; ///< The offset of the file within the ZIP.
 		uint32 size;   ///< The file's size.
+		uint16 method; ///< The file's compression method.
 	};
 
 	typedef std::vector<IFile> IFileList;
 
-	ScopedPtr<SeekableReadStream> _zip;
+	ScopedPtr<SeekableStreamView> _zip;
 
 	/** External list of file names and types. */
 	FileList _files;
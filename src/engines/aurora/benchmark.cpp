@@ -0,0 +1,287 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Running a scene benchmark, recording per-frame timings.
+ */
+
+#include <cstdio>
+#include <cmath>
+
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/error.h"
+#include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/encoding.h"
+
+#include "src/graphics/camera.h"
+
+#include "src/engines/aurora/benchmark.h"
+
+namespace Engines {
+
+/** The number of frames benchmarked if not specified otherwise. */
+static const int kDefaultFrameCount = 1000;
+
+/** The number of waypoints the default camera orbit is made of. */
+static const size_t kOrbitWaypoints = 64;
+
+/** The profiler zones that make up each of the timing categories. */
+static const struct {
+	const char *category;
+	const char *zones[4];
+} kCategories[] = {
+	{ "logic"    , { "processEventQueue", 0, 0, 0 } },
+	{ "animation", { "advanceTime", 0, 0, 0 } },
+	{ "render"   , { "renderGUIBack", "renderWorld", "renderGUIFront", "renderCursor" } },
+	{ "loading"  , { "getResource", "buildNewTextures", 0, 0 } }
+};
+
+static double getCategoryTime(const Common::FrameProfiler::FrameTimes &frame, size_t category) {
+	double time = 0.0;
+
+	for (size_t i = 0; i < ARRAYSIZE(kCategories[category].zones); i++) {
+		if (!kCategories[category].zones[i])
+			continue;
+
+		std::map<Common::UString, double>::const_iterator zone = frame.zones.find(kCategories[category].zones[i]);
+		if (zone != frame.zones.end())
+			time += zone->second;
+	}
+
+	return time;
+}
+
+static Common::UString formatStatistics(const char *name, std::vector<double> &times) {
+	if (times.empty())
+		return Common::UString::format("\"%s\":{}", name);
+
+	std::sort(times.begin(), times.end());
+
+	double sum = 0.0;
+	for (std::vector<double>::const_iterator t = times.begin(); t != times.end(); ++t)
+		sum += *t;
+
+	const double p95 = times[MIN<size_t>(times.size() - 1, (size_t) (times.size() * 0.95))];
+
+	return Common::UString::format("\"%s\":{\"min\":%.3f,\"avg\":%.3f,\"p95\":%.3f,\"max\":%.3f}",
+	                               name, times.front(), sum / times.size(), p95, times.back());
+}
+
+
+Benchmark::Benchmark() : _frameCount(kDefaultFrameCount), _hasPathFile(false),
+	_profileEnabled(false), _running(false) {
+
+	_file       = ConfigMan.getString("benchmark");
+	_frameCount = MAX(ConfigMan.getInt("benchmarkframes", kDefaultFrameCount), 1);
+
+	const Common::UString path = ConfigMan.getString("benchmarkpath");
+	if (!path.empty())
+		loadPath(path);
+}
+
+Benchmark::~Benchmark() {
+	if (_running) {
+		FrameProf.stopRecording();
+		FrameProf.setEnabled(_profileEnabled);
+	}
+}
+
+bool Benchmark::isRequested() {
+	return !ConfigMan.getString("benchmark").empty();
+}
+
+void Benchmark::loadPath(const Common::UString &file) {
+	Common::ReadFile stream(file);
+
+	while (!stream.eos()) {
+		const Common::UString line = Common::readStringLine(stream, Common::kEncodingUTF8);
+		if (line.empty() || (*line.begin() == '#'))
+			continue;
+
+		Waypoint waypoint;
+		if (std::sscanf(line.c_str(), "%f %f %f %f %f %f",
+		                &waypoint.position[0], &waypoint.position[1], &waypoint.position[2],
+		                &waypoint.orientation[0], &waypoint.orientation[1], &waypoint.orientation[2]) != 6)
+			throw Common::Exception("Invalid benchmark camera path line \"%s\"", line.c_str());
+
+		_path.push_back(waypoint);
+	}
+
+	if (_path.empty())
+		throw Common::Exception("Benchmark camera path \"%s\" is empty", file.c_str());
+
+	_hasPathFile = true;
+}
+
+void Benchmark::setDefaultPath(float x, float y, float z, float radius, float height) {
+	if (_hasPathFile)
+		return;
+
+	_path.resize(kOrbitWaypoints + 1);
+
+	// Look down at the point from the side
+	const float pitch = 90.0f - Common::rad2deg(atan2(height, radius));
+
+	for (size_t i = 0; i <= kOrbitWaypoints; i++) {
+		const float angle = (2.0f * M_PI * i) / kOrbitWaypoints;
+
+		_path[i].position[0] = x + radius * cos(angle);
+		_path[i].position[1] = y + radius * sin(angle);
+		_path[i].position[2] = z + height;
+
+		_path[i].orientation[0] = pitch;
+		_path[i].orientation[1] = 0.0f;
+		_path[i].orientation[2] = 90.0f + Common::rad2deg(angle);
+	}
+}
+
+void Benchmark::start() {
+	status("Benchmarking %u frames", (uint) _frameCount);
+
+	_profileEnabled = FrameProf.isEnabled();
+
+	FrameProf.setEnabled(true);
+	FrameProf.startRecording();
+
+	_running = true;
+}
+
+bool Benchmark::update() {
+	if (!_running)
+		return false;
+
+	const size_t frame = FrameProf.getRecordedFrameCount();
+	if (frame >= _frameCount)
+		return false;
+
+	if (_path.empty())
+		return true;
+
+	Waypoint waypoint;
+	getWaypoint(frame / (double) MAX<size_t>(_frameCount - 1, 1), waypoint);
+
+	CameraMan.setPosition   (waypoint.position   [0], waypoint.position   [1], waypoint.position   [2]);
+	CameraMan.setOrientation(waypoint.orientation[0], waypoint.orientation[1], waypoint.orientation[2]);
+	CameraMan.update();
+
+	return true;
+}
+
+void Benchmark::getWaypoint(double t, Waypoint &waypoint) const {
+	const double pos = CLIP(t, 0.0, 1.0) * (_path.size() - 1);
+
+	const size_t index1 = MIN<size_t>(floor(pos), _path.size() - 1);
+	const size_t index2 = MIN<size_t>(index1 + 1, _path.size() - 1);
+
+	const float f = pos - index1;
+
+	for (size_t i = 0; i < 3; i++) {
+		waypoint.position[i]    = _path[index1].position[i]    +
+		                          (_path[index2].position[i]    - _path[index1].position[i]) * f;
+		waypoint.orientation[i] = _path[index1].orientation[i] +
+		                          (_path[index2].orientation[i] - _path[index1].orientation[i]) * f;
+	}
+}
+
+bool Benchmark::finish() {
+	if (!_running)
+		return false;
+
+	FrameProf.stopRecording();
+	FrameProf.setEnabled(_profileEnabled);
+
+	_running = false;
+
+	if (!writeResults(_file)) {
+		warning("Failed to write the benchmark results to \"%s\"", _file.c_str());
+		return false;
+	}
+
+	status("Wrote the benchmark results to \"%s\"", _file.c_str());
+	return true;
+}
+
+bool Benchmark::writeResults(const Common::UString &fileName) const {
+	std::vector<Common::FrameProfiler::FrameTimes> frames;
+	FrameProf.getRecordedFrames(frames);
+
+	Common::WriteFile file;
+	if (!file.open(fileName))
+		return false;
+
+	try {
+		file.writeString(Common::UString::format("{\n\"frameCount\":%u,\n\"summary\":{", (uint) frames.size()));
+
+		// Statistics over all frames, for the whole frame and each category
+		std::vector<double> times;
+
+		for (size_t i = 0; i < frames.size(); i++)
+			times.push_back(frames[i].time);
+
+		file.writeString(formatStatistics("frame", times));
+
+		for (size_t c = 0; c < ARRAYSIZE(kCategories); c++) {
+			times.clear();
+			for (size_t i = 0; i < frames.size(); i++)
+				times.push_back(getCategoryTime(frames[i], c));
+
+			file.writeString(",");
+			file.writeString(formatStatistics(kCategories[c].category, times));
+		}
+
+		file.writeString("},\n\"frames\":[");
+
+		// The times of each single frame, including all profiler zones
+		for (size_t i = 0; i < frames.size(); i++) {
+			file.writeString(Common::UString::format("%s\n{\"frame\":%.3f", (i == 0) ? "" : ",", frames[i].time));
+
+			for (size_t c = 0; c < ARRAYSIZE(kCategories); c++)
+				file.writeString(Common::UString::format(",\"%s\":%.3f", kCategories[c].category,
+				                                         getCategoryTime(frames[i], c)));
+
+			file.writeString(",\"zones\":{");
+
+			for (std::map<Common::UString, double>::const_iterator z = frames[i].zones.begin();
+			     z != frames[i].zones.end(); ++z)
+				file.writeString(Common::UString::format("%s\"%s\":%.3f", (z == frames[i].zones.begin()) ? "" : ",",
+				                                         z->first.c_str(), z->second));
+
+			file.writeString("}}");
+		}
+
+		file.writeString("\n]\n}\n");
+
+		file.flush();
+
+	} catch (...) {
+		return false;
+	}
+
+	file.close();
+	return true;
+}
+
+} // End of namespace Engines
@@ -0,0 +1,113 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Running a scene benchmark, recording per-frame timings.
+ */
+
+#ifndef ENGINES_AURORA_BENCHMARK_H
+#define ENGINES_AURORA_BENCHMARK_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Engines {
+
+/** A benchmark run over a fixed number of frames.
+ *
+ *  A benchmark is requested on the command line, with the "benchmark"
+ *  option naming the JSON file the results should be written to. The
+ *  engine then loads the scene to benchmark and lets the Benchmark
+ *  object move the camera along a path, one step each frame, until the
+ *  number of frames given in "benchmarkframes" have been rendered.
+ *
+ *  The camera path is read from the file given in "benchmarkpath".
+ *  Each line contains one waypoint, as the camera position and the
+ *  camera orientation in degrees: "x y z rotX rotY rotZ". Empty lines
+ *  and lines starting with '#' are ignored. The camera moves linearly
+ *  between the waypoints, reaching the last waypoint on the last frame.
+ *  Without such a file, the engine provides a default path.
+ *
+ *  For each frame, the time spent in game logic, animation updates,
+ *  render submission and resource loading is recorded through the
+ *  frame profiler, alongside the times of all individual profiler zones.
+ */
+class Benchmark : boost::noncopyable {
+public:
+	Benchmark();
+	~Benchmark();
+
+	/** Was a benchmark requested? */
+	static bool isRequested();
+
+	/** Orbit the camera once around this point, unless a path file was given.
+	 *
+	 *  @param x      The point the camera looks at.
+	 *  @param y      The point the camera looks at.
+	 *  @param z      The point the camera looks at.
+	 *  @param radius The distance from the point, along the ground.
+	 *  @param height The height above the point.
+	 */
+	void setDefaultPath(float x, float y, float z, float radius, float height);
+
+	/** Start recording the frame times. */
+	void start();
+
+	/** Place the camera for the current frame.
+	 *
+	 *  @return false once all frames of the benchmark have been rendered.
+	 */
+	bool update();
+
+	/** Stop recording and write the frame times into the benchmark file. */
+	bool finish();
+
+private:
+	/** A point along the camera path. */
+	struct Waypoint {
+		float position[3];
+		float orientation[3];
+	};
+
+	Common::UString _file; ///< The file to write the results to.
+
+	size_t _frameCount; ///< The number of frames to benchmark.
+
+	std::vector<Waypoint> _path; ///< The camera path.
+	bool _hasPathFile;           ///< Was the camera path read from a file?
+
+	bool _profileEnabled; ///< Was the frame profiler already enabled before?
+	bool _running;        ///< Are we currently recording?
+
+	void loadPath(const Common::UString &file);
+
+	/** Return the camera placement at this point (0.0 - 1.0) of the path. */
+	void getWaypoint(double t, Waypoint &waypoint) const;
+
+	bool writeResults(const Common::UString &file) const;
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_BENCHMARK_H
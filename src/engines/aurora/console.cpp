@@ -33,10 +33,13 @@
 #include "src/common/filepath.h"
 #include "src/common/readline.h"
 #include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/talkman.h"
 
+#include "src/aurora/nwscript/profiler.h"
+
 #include "src/graphics/graphics.h"
 #include "src/graphics/font.h"
 #include "src/graphics/camera.h"
@@ -758,6 +761,14 @@ Console::Console(Engine &engine, const Common::UString &font, int fontHeight) :
 	registerCommand("setcamera"  , boost::bind(&Console::cmdSetCamera  , this, _1),
 			"Usage: setcamera <posX> <posY> <posZ> [<orientX> <orientY> <orientZ>]\n"
 			"Set the camera position (and orientation)");
+	registerCommand("scriptprof" , boost::bind(&Console::cmdScriptProf , this, _1),
+			"Usage: scriptprof [on|off|reset|dump [<file>]]\n"
+			"Show the hottest scripts and engine functions, or control the script profiler");
+	registerCommand("rescache"   , boost::bind(&Console::cmdResCache   , this, _1),
+			"Usage: rescache [clear]\nShow statistics of the cache of unpacked resources, or clear it");
+	registerCommand("profile"    , boost::bind(&Console::cmdProfile    , this, _1),
+			"Usage: profile [on|off|reset|show|hide|dump [<file>]]\n"
+			"Show the time spent in each part of a frame, or control the frame profiler");
 
 	_console->setPrompt(kPrompt);
 
@@ -1309,6 +1320,7 @@ void Console::cmdSetOption(const CommandLine &cl) {
 
 	ConfigMan.setCommandlineKey(args[0], args[1]);
 	_engine->showFPS();
+	_engine->showProfile();
 
 	printf("\"%s\" = \"%s\"", args[0].c_str(), ConfigMan.getString(args[0]).c_str());
 }
@@ -1461,6 +1473,107 @@ void Console::cmdSetCamera(const CommandLine &cl) {
 	CameraMan.update();
 }
 
+void Console::cmdScriptProf(const CommandLine &cl) {
+	std::vector<Common::UString> args;
+	splitArguments(cl.args, args);
+
+	if (args.empty()) {
+		if (!ScriptProf.isEnabled())
+			printf("The script profiler is disabled");
+
+		std::vector<Common::UString> lines;
+		ScriptProf.getReport(lines, 10);
+
+		for (std::vector<Common::UString>::const_iterator l = lines.begin(); l != lines.end(); ++l)
+			print(*l);
+
+		return;
+	}
+
+	if        (args[0] == "on") {
+		ScriptProf.setEnabled(true);
+		printf("Enabled the script profiler");
+	} else if (args[0] == "off") {
+		ScriptProf.setEnabled(false);
+		printf("Disabled the script profiler");
+	} else if (args[0] == "reset") {
+		ScriptProf.clear();
+		printf("Cleared the script profile");
+	} else if (args[0] == "dump") {
+		Common::UString file = Common::FilePath::getUserDataFile("scriptprofile.txt");
+		if (args.size() > 1)
+			file = args[1];
+
+		if (ScriptProf.dump(file))
+			printf("Dumped the script profile to \"%s\"", file.c_str());
+		else
+			printf("Failed dumping the script profile to \"%s\"", file.c_str());
+	} else
+		printCommandHelp(cl.cmd);
+}
+
+void Console::cmdResCache(const CommandLine &cl) {
+	if (cl.args == "clear") {
+		ResMan.clearCache();
+		printf("Cleared the resource cache");
+		return;
+	}
+
+	if (!cl.args.empty()) {
+		printCommandHelp(cl.cmd);
+		return;
+	}
+
+	const Aurora::ResourceManager::CacheStatistics stats = ResMan.getCacheStatistics();
+
+	printf("%u resources cached, %.2f of %.2f MB used",
+	       (uint) stats.entries, stats.size / (1024.0 * 1024.0), stats.capacity / (1024.0 * 1024.0));
+	printf("%llu hits, %llu misses, %llu evictions", (unsigned long long) stats.hits,
+	       (unsigned long long) stats.misses, (unsigned long long) stats.evictions);
+}
+
+void Console::cmdProfile(const CommandLine &cl) {
+	std::vector<Common::UString> args;
+	splitArguments(cl.args, args);
+
+	if (args.empty()) {
+		if (!FrameProf.isEnabled())
+			printf("The frame profiler is disabled");
+
+		std::vector<Common::UString> lines;
+		FrameProf.getReport(lines);
+
+		for (std::vector<Common::UString>::const_iterator l = lines.begin(); l != lines.end(); ++l)
+			print(*l);
+
+		return;
+	}
+
+	if        (args[0] == "on") {
+		FrameProf.setEnabled(true);
+		printf("Enabled the frame profiler");
+	} else if (args[0] == "off") {
+		FrameProf.setEnabled(false);
+		printf("Disabled the frame profiler");
+	} else if (args[0] == "reset") {
+		FrameProf.clear();
+		printf("Cleared the frame profile");
+	} else if ((args[0] == "show") || (args[0] == "hide")) {
+		ConfigMan.setCommandlineKey("showprofile", (args[0] == "show") ? "true" : "false");
+		_engine->showProfile();
+	} else if (args[0] == "dump") {
+		Common::UString file = Common::FilePath::getUserDataFile("frameprofile.json");
+		if (args.size() > 1)
+			file = args[1];
+
+		if (FrameProf.dumpTrace(file))
+			printf("Dumped the frame profile trace to \"%s\"", file.c_str());
+		else
+			printf("Failed dumping the frame profile trace to \"%s\"", file.c_str());
+	} else
+		printCommandHelp(cl.cmd);
+}
+
 void Console::printFullHelp() {
 	print("Available commands (help <command> for further help on each command):");
 
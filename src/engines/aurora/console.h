@@ -306,6 +306,9 @@ private:
 	void cmdGetString  (const CommandLine &cl);
 	void cmdGetCamera  (const CommandLine &cl);
 	void cmdSetCamera  (const CommandLine &cl);
+	void cmdScriptProf (const CommandLine &cl);
+	void cmdResCache   (const CommandLine &cl);
+	void cmdProfile    (const CommandLine &cl);
 
 	void updateHelpArguments();
 
@@ -0,0 +1,145 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Loading in small, time-budgeted steps.
+ */
+
+#include <SDL_timer.h>
+
+#include "src/common/util.h"
+#include "src/common/debug.h"
+#include "src/common/frameprofiler.h"
+
+#include "src/engines/aurora/loadscheduler.h"
+
+namespace Engines {
+
+static double ticksToMS(uint64 ticks) {
+	return (ticks * 1000.0) / SDL_GetPerformanceFrequency();
+}
+
+
+LoadTask::LoadTask(const Common::UString &name) : _name(name), _steps(0), _frames(0), _ticks(0) {
+}
+
+LoadTask::~LoadTask() {
+}
+
+const Common::UString &LoadTask::getName() const {
+	return _name;
+}
+
+float LoadTask::getProgress() const {
+	return 0.0f;
+}
+
+
+LoadScheduler::LoadScheduler() : _lastSteps(0), _lastTime(0.0) {
+}
+
+LoadScheduler::~LoadScheduler() {
+}
+
+void LoadScheduler::add(LoadTask *task) {
+	_tasks.push_back(task);
+}
+
+void LoadScheduler::clear() {
+	_tasks.clear();
+}
+
+bool LoadScheduler::isEmpty() const {
+	return _tasks.empty();
+}
+
+LoadTask *LoadScheduler::getCurrentTask() const {
+	return _tasks.empty() ? 0 : _tasks.front();
+}
+
+bool LoadScheduler::run(uint32 budget) {
+	Common::ProfileZone profile("runLoadTasks");
+
+	const uint64 start = Common::FrameProfiler::getTicks();
+	const uint64 end   = start + (((uint64) budget) * SDL_GetPerformanceFrequency()) / 1000;
+
+	_lastSteps = 0;
+
+	LoadTask *lastTask = 0;
+	uint64 now = start;
+
+	while (!_tasks.empty() && ((_lastSteps == 0) || (now < end))) {
+		LoadTask &task = *_tasks.front();
+
+		// Count the frames each task was worked on in
+		if (&task != lastTask)
+			task._frames++;
+
+		lastTask = &task;
+
+		bool more = false;
+		try {
+			more = task.step();
+		} catch (...) {
+			_tasks.pop_front();
+			throw;
+		}
+
+		const uint64 stepEnd = Common::FrameProfiler::getTicks();
+
+		task._steps++;
+		task._ticks += stepEnd - now;
+
+		_lastSteps++;
+		now = stepEnd;
+
+		if (!more)
+			finishTask();
+	}
+
+	_lastTime = ticksToMS(now - start);
+
+	debugC(Common::kDebugEngineLogic, 5, "Load tasks: %u steps in %.2fms, %u tasks left",
+	       (uint) _lastSteps, _lastTime, (uint) _tasks.size());
+
+	return _tasks.empty();
+}
+
+void LoadScheduler::finishTask() {
+	const LoadTask &task = *_tasks.front();
+
+	const double time = ticksToMS(task._ticks);
+
+	status("Loaded %s: %u steps in %u frames, %.2fms (%.1f steps and %.2fms per frame)",
+	       task._name.c_str(), (uint) task._steps, (uint) task._frames, time,
+	       ((double) task._steps) / MAX<size_t>(task._frames, 1), time / MAX<size_t>(task._frames, 1));
+
+	_tasks.pop_front();
+}
+
+size_t LoadScheduler::getLastSteps() const {
+	return _lastSteps;
+}
+
+double LoadScheduler::getLastTime() const {
+	return _lastTime;
+}
+
+} // End of namespace Engines
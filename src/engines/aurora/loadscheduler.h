@@ -0,0 +1,118 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Loading in small, time-budgeted steps.
+ */
+
+#ifndef ENGINES_AURORA_LOADSCHEDULER_H
+#define ENGINES_AURORA_LOADSCHEDULER_H
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/ptrlist.h"
+
+namespace Engines {
+
+/** A piece of loading work, split into small steps that can be resumed later. */
+class LoadTask : boost::noncopyable {
+public:
+	LoadTask(const Common::UString &name);
+	virtual ~LoadTask();
+
+	/** Return the name of the task, as shown in the load statistics. */
+	const Common::UString &getName() const;
+
+	/** Return how far along the task is, from 0.0 (not started) to 1.0 (finished). */
+	virtual float getProgress() const;
+
+	/** Do the next step of the work.
+	 *
+	 *  @return true if there's still work left.
+	 */
+	virtual bool step() = 0;
+
+private:
+	Common::UString _name;
+
+	size_t _steps;  ///< Number of steps done so far.
+	size_t _frames; ///< Number of frames the task was worked on in.
+	uint64 _ticks;  ///< Time spent on the task so far, in profiler ticks.
+
+	friend class LoadScheduler;
+};
+
+/** Works on a queue of load tasks, a bit each frame.
+ *
+ *  Instead of loading something in one go, stalling the game thread, the
+ *  work is put into load tasks. Each frame, the game thread then calls
+ *  run(), which works on the tasks for a limited amount of time. Between
+ *  the calls, the game can update a loading screen, react to input, and
+ *  so on.
+ *
+ *  When a task is finished, the number of steps and frames it took, and
+ *  the time spent on it per frame, is printed.
+ */
+class LoadScheduler : boost::noncopyable {
+public:
+	LoadScheduler();
+	~LoadScheduler();
+
+	/** Add a task to the end of the queue. The scheduler takes over ownership. */
+	void add(LoadTask *task);
+	/** Remove all tasks, finished or not. */
+	void clear();
+
+	/** Are there no tasks left? */
+	bool isEmpty() const;
+
+	/** Return the task currently being worked on, or 0 if there's none. */
+	LoadTask *getCurrentTask() const;
+
+	/** Work on the tasks, in the order they were added, for about this long.
+	 *
+	 *  At least one step is always done, so that the loading progresses
+	 *  even with a tiny budget. If a task throws, it is removed and the
+	 *  exception is passed on.
+	 *
+	 *  @param  budget The time to spend, in milliseconds.
+	 *  @return true if all tasks are finished.
+	 */
+	bool run(uint32 budget);
+
+	/** Return the number of steps done in the last run() call. */
+	size_t getLastSteps() const;
+	/** Return the time spent in the last run() call, in milliseconds. */
+	double getLastTime() const;
+
+private:
+	Common::PtrList<LoadTask> _tasks;
+
+	size_t _lastSteps;
+	double _lastTime;
+
+	void finishTask();
+};
+
+} // End of namespace Engines
+
+#endif // ENGINES_AURORA_LOADSCHEDULER_H
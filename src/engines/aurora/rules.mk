@@ -32,7 +32,9 @@ src_engines_aurora_libaurora_la_SOURCES += \
     src/engines/aurora/gui.h \
     src/engines/aurora/console.h \
     src/engines/aurora/loadprogress.h \
+    src/engines/aurora/loadscheduler.h \
     src/engines/aurora/camera.h \
+    src/engines/aurora/benchmark.h \
     $(EMPTY)
 
 src_engines_aurora_libaurora_la_SOURCES += \
@@ -45,5 +47,7 @@ src_engines_aurora_libaurora_la_SOURCES += \
     src/engines/aurora/gui.cpp \
     src/engines/aurora/console.cpp \
     src/engines/aurora/loadprogress.cpp \
+    src/engines/aurora/loadscheduler.cpp \
     src/engines/aurora/camera.cpp \
+    src/engines/aurora/benchmark.cpp \
     $(EMPTY)
@@ -27,6 +27,7 @@
 #include "src/common/error.h"
 #include "src/common/filelist.h"
 #include "src/common/filepath.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/aurora/resman.h"
 #include "src/aurora/talkman.h"
@@ -93,7 +94,10 @@ void Game::runCampaigns() {
 		while (EventMan.pollEvent(event))
 			_campaigns->addEvent(event);
 
-		_campaigns->processEventQueue();
+		{
+			Common::ProfileZone profile("processEventQueue");
+			_campaigns->processEventQueue();
+		}
 		EventMan.delay(10);
 	}
 
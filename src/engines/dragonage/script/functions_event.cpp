@@ -105,15 +105,14 @@ void Functions::setEventCreator(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::handleEvent(Aurora::NWScript::FunctionContext &ctx) {
-	Event invalidEvent;
+	const Event *event = DragonAge::ObjectContainer::toEvent(ctx.getParams()[0].getEngineType());
 
-	Event *event = DragonAge::ObjectContainer::toEvent(ctx.getParams()[0].getEngineType());
-	if (!event)
-		event = &invalidEvent;
+	// The event handler gets its own copy of the event to work on
+	Event handledEvent = event ? *event : Event();
 
 	// TODO: According to the Dragon Age wiki, "The maximum level of event rerouteing is 8".
 
-	DragonAge::ScriptContainer::runScript(ctx.getParams()[1].getString(), *event);
+	DragonAge::ScriptContainer::runScript(ctx.getParams()[1].getString(), handledEvent);
 }
 
 } // End of namespace DragonAge
@@ -143,6 +143,10 @@ Event *ObjectContainer::toEvent(Aurora::NWScript::EngineType *engineType) {
 	return dynamic_cast<Event *>(engineType);
 }
 
+const Event *ObjectContainer::toEvent(const Aurora::NWScript::EngineType *engineType) {
+	return dynamic_cast<const Event *>(engineType);
+}
+
 } // End of namespace DragonAge2
 
 } // End of namespace Engines
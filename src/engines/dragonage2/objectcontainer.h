@@ -91,6 +91,7 @@ public:
 	static Creature  *toCreature (Aurora::NWScript::Object *object);
 
 	static Event *toEvent(Aurora::NWScript::EngineType *engineType);
+	static const Event *toEvent(const Aurora::NWScript::EngineType *engineType);
 
 private:
 	typedef std::list<DragonAge2::Object *> ObjectList;
@@ -186,15 +186,14 @@ void Functions::setEventCreatorRef(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::handleEvent(Aurora::NWScript::FunctionContext &ctx) {
-	Event invalidEvent;
+	const Event *event = DragonAge2::ObjectContainer::toEvent(ctx.getParams()[0].getEngineType());
 
-	Event *event = DragonAge2::ObjectContainer::toEvent(ctx.getParams()[0].getEngineType());
-	if (!event)
-		event = &invalidEvent;
+	// The event handler gets its own copy of the event to work on
+	Event handledEvent = event ? *event : Event();
 
 	// TODO: According to the Dragon Age wiki, "The maximum level of event rerouteing is 8".
 
-	DragonAge2::ScriptContainer::runScript(ctx.getParams()[1].getString(), *event);
+	DragonAge2::ScriptContainer::runScript(ctx.getParams()[1].getString(), handledEvent);
 }
 
 void Functions::handleEventRef(Aurora::NWScript::FunctionContext &ctx) {
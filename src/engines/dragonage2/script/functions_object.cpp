@@ -240,7 +240,7 @@ void Functions::getObjectType(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getTag(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Aurora::NWScript::Object *object = getParamObject(ctx, 0);
 	if (object)
@@ -249,19 +249,19 @@ void Functions::getTag(Aurora::NWScript::FunctionContext &ctx) {
 
 void Functions::getResRef(Aurora::NWScript::FunctionContext &ctx) {
 	const DragonAge2::Object *object = DragonAge2::ObjectContainer::toObject(getParamObject(ctx, 0));
-	ctx.getReturn().getString() = object ? object->getResRef() : "";
+	ctx.getReturn().setString(object ? object->getResRef() : "");
 }
 
 void Functions::getName(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString() = "";
+	ctx.getReturn().setString("");
 
 	const DragonAge2::Object *object = DragonAge2::ObjectContainer::toObject(getParamObject(ctx, 0));
 	if (!object)
 		return;
 
-	ctx.getReturn().getString() = object->getNonLocalizedName();
+	ctx.getReturn().setString(object->getNonLocalizedName());
 	if (ctx.getReturn().getString().empty())
-		ctx.getReturn().getString() = object->getName().getString();
+		ctx.getReturn().setString(object->getName().getString());
 }
 
 void Functions::setName(Aurora::NWScript::FunctionContext &ctx) {
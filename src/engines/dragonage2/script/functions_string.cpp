@@ -262,7 +262,7 @@ void Functions::stringLowerCase(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::stringRight(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &str = ctx.getParams()[0].getString();
 
@@ -277,7 +277,7 @@ void Functions::stringRight(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::stringLeft(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &str = ctx.getParams()[0].getString();
 
@@ -292,7 +292,7 @@ void Functions::stringLeft(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::insertString(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 	if (ctx.getParams()[2].getInt() < 0) {
 		debugC(Common::kDebugEngineScripts, 1, "Functions::%s: %d",
 		       ctx.getName().c_str(), ctx.getParams()[2].getInt());
@@ -307,7 +307,7 @@ void Functions::insertString(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::subString(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &str = ctx.getParams()[0].getString();
 
@@ -28,11 +28,13 @@
 #include "src/common/configman.h"
 
 #include "src/graphics/aurora/fps.h"
+#include "src/graphics/aurora/profiledisplay.h"
 #include "src/graphics/aurora/fontman.h"
 
 #include "src/engines/engine.h"
 
 #include "src/engines/aurora/console.h"
+#include "src/engines/aurora/benchmark.h"
 
 namespace Engines {
 
@@ -78,8 +80,18 @@ bool Engine::changeLanguage() {
 	return false;
 }
 
+bool Engine::canBenchmark() const {
+	return false;
+}
+
 void Engine::start(Aurora::GameID game, const Common::UString &target, Aurora::Platform platform) {
+	if (Benchmark::isRequested() && !canBenchmark()) {
+		warning("Benchmarking is not supported for this game");
+		return;
+	}
+
 	showFPS();
+	showProfile();
 
 	_game     = game;
 	_platform = platform;
@@ -103,6 +115,21 @@ void Engine::showFPS() {
 	}
 }
 
+void Engine::showProfile() {
+	bool show = ConfigMan.getBool("showprofile", false);
+
+	if        ( show && !_profile) {
+
+		_profile.reset(new Graphics::Aurora::ProfileDisplay(FontMan.get(Graphics::Aurora::kSystemFontMono, 13)));
+		_profile->show();
+
+	} else if (!show &&  _profile) {
+
+		_profile.reset();
+
+	}
+}
+
 static bool hasLanguage(const std::vector<Aurora::Language> &langs, Aurora::Language lang) {
 	return std::find(langs.begin(), langs.end(), lang) != langs.end();
 }
@@ -38,6 +38,7 @@
 namespace Graphics {
 	namespace Aurora {
 		class FPS;
+		class ProfileDisplay;
 	}
 }
 
@@ -74,10 +75,15 @@ public:
 	/** Change the game's current language. */
 	virtual bool changeLanguage();
 
+	/** Can this engine run a benchmark? */
+	virtual bool canBenchmark() const;
+
 	void start(Aurora::GameID game, const Common::UString &target, Aurora::Platform platform);
 
 	/** Evaluate the FPS display setting and show/hide the FPS display. */
 	void showFPS();
+	/** Evaluate the profile display setting and show/hide the frame profiler statistics. */
+	void showProfile();
 
 protected:
 	Aurora::GameID   _game;
@@ -87,6 +93,7 @@ protected:
 	Common::ScopedPtr<Console> _console;
 
 	Common::ScopedPtr<Graphics::Aurora::FPS> _fps;
+	Common::ScopedPtr<Graphics::Aurora::ProfileDisplay> _profile;
 
 
 	/** Run the game. */
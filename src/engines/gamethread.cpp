@@ -30,6 +30,7 @@
 #include "src/common/error.h"
 #include "src/common/ustring.h"
 #include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/engines/gamethread.h"
 #include "src/engines/enginemanager.h"
@@ -83,6 +84,8 @@ void GameThread::run() {
 void GameThread::threadMethod() {
 	assert(_game);
 
+	FrameProf.setThreadName("Game");
+
 	try {
 		EngineMan.run(*_game);
 	} catch (...) {
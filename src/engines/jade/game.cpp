@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include "src/common/frameprofiler.h"
+
 #include "src/aurora/resman.h"
 
 #include "src/events/events.h"
@@ -90,7 +92,10 @@ void Game::runModule() {
 		while (EventMan.pollEvent(event))
 			_module->addEvent(event);
 
-		_module->processEventQueue();
+		{
+			Common::ProfileZone profile("processEventQueue");
+			_module->processEventQueue();
+		}
 		EventMan.delay(10);
 	}
 
@@ -158,6 +158,14 @@ Event *ObjectContainer::toEvent(Aurora::NWScript::EngineType *engineType) {
 	return dynamic_cast<Event *>(engineType);
 }
 
+const Location *ObjectContainer::toLocation(const Aurora::NWScript::EngineType *engineType) {
+	return dynamic_cast<const Location *>(engineType);
+}
+
+const Event *ObjectContainer::toEvent(const Aurora::NWScript::EngineType *engineType) {
+	return dynamic_cast<const Event *>(engineType);
+}
+
 } // End of namespace Jade
 
 } // End of namespace Engines
@@ -88,6 +88,9 @@ public:
 	static Location *toLocation(Aurora::NWScript::EngineType *engineType);
 	static Event    *toEvent   (Aurora::NWScript::EngineType *engineType);
 
+	static const Location *toLocation(const Aurora::NWScript::EngineType *engineType);
+	static const Event    *toEvent   (const Aurora::NWScript::EngineType *engineType);
+
 private:
 	typedef std::list<Jade::Object *> ObjectList;
 
@@ -64,7 +64,7 @@ void Functions::get2DANumColumn(Aurora::NWScript::FunctionContext &ctx) {
 void Functions::get2DAEntryIntByString(Aurora::NWScript::FunctionContext &ctx) {
 	int32 tableNr = ctx.getParams()[0].getInt();
 	int32 rowNr = ctx.getParams()[1].getInt();
-	Common::UString &columnName = ctx.getParams()[2].getString();
+	const Common::UString &columnName = ctx.getParams()[2].getString();
 
 	const Aurora::TwoDAFile &table = findTable(tableNr);
 
@@ -74,7 +74,7 @@ void Functions::get2DAEntryIntByString(Aurora::NWScript::FunctionContext &ctx) {
 void Functions::get2DAEntryFloatByString(Aurora::NWScript::FunctionContext &ctx) {
 	int32 tableNr = ctx.getParams()[0].getInt();
 	int32 rowNr = ctx.getParams()[1].getInt();
-	Common::UString &columnName = ctx.getParams()[2].getString();
+	const Common::UString &columnName = ctx.getParams()[2].getString();
 
 	const Aurora::TwoDAFile &table = findTable(tableNr);
 
@@ -84,7 +84,7 @@ void Functions::get2DAEntryFloatByString(Aurora::NWScript::FunctionContext &ctx)
 void Functions::get2DAEntryStringByString(Aurora::NWScript::FunctionContext &ctx) {
 	int32 tableNr = ctx.getParams()[0].getInt();
 	int32 rowNr = ctx.getParams()[1].getInt();
-	Common::UString &columnName = ctx.getParams()[2].getString();
+	const Common::UString &columnName = ctx.getParams()[2].getString();
 
 	const Aurora::TwoDAFile &table = findTable(tableNr);
 
@@ -174,8 +174,8 @@ void Functions::actionJumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 	// TODO: walkStraightLineToPoint
 	// bool walkStraightLineToPoint = ctx.getParams()[1].getInt() != 0;
 
-	Jade::Object   *object = Jade::ObjectContainer::toObject(ctx.getCaller());
-	Jade::Location *moveTo = Jade::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      Jade::Object   *object = Jade::ObjectContainer::toObject(ctx.getCaller());
+	const Jade::Location *moveTo = Jade::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
@@ -191,8 +191,8 @@ void Functions::actionMoveToLocation(Aurora::NWScript::FunctionContext &ctx) {
 	// int32 runType = ctx.getParams()[1].getInt();
 	// int32 moveAnim = ctx.getParams()[2].getInt();
 
-	Jade::Object   *object = Jade::ObjectContainer::toObject(ctx.getCaller());
-	Jade::Location *moveTo = Jade::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      Jade::Object   *object = Jade::ObjectContainer::toObject(ctx.getCaller());
+	const Jade::Location *moveTo = Jade::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
@@ -140,7 +140,7 @@ void Functions::getObjectType(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getTag(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	Aurora::NWScript::Object *object = getParamObject(ctx, 0);
 	if (object)
@@ -290,7 +290,7 @@ void Functions::playAnimation(Aurora::NWScript::FunctionContext &ctx) {
 
 void Functions::jumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 	Jade::Object *object = Jade::ObjectContainer::toObject(ctx.getCaller());
-	Jade::Location *moveTo = Jade::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	const Jade::Location *moveTo = Jade::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
@@ -54,10 +54,6 @@ namespace Engines {
 
 namespace KotOR {
 
-bool Module::Action::operator<(const Action &s) const {
-	return timestamp < s.timestamp;
-}
-
 
 Module::Module(::Engines::Console &console) : Object(kObjectTypeModule),
 	_console(&console), _hasModule(false), _running(false),
@@ -439,19 +435,23 @@ void Module::handleEvents() {
 }
 
 void Module::handleActions() {
-	uint32 now = EventMan.getTimestamp();
+	const uint32 now = EventMan.getTimestamp();
+
+	std::list<Action> actions;
+	_delayedActions.advance(now, actions);
 
-	while (!_delayedActions.empty()) {
-		ActionQueue::iterator action = _delayedActions.begin();
+	while (!actions.empty()) {
+		const Action &action = actions.front();
 
-		if (now < action->timestamp)
-			break;
+		if (action.type == kActionScript)
+			ScriptContainer::runScript(action.script, action.state,
+			                           action.owner, action.triggerer);
 
-		if (action->type == kActionScript)
-			ScriptContainer::runScript(action->script, action->state,
-			                           action->owner, action->triggerer);
+		actions.pop_front();
 
-		_delayedActions.erase(action);
+		// The scripts might have delayed more actions that are already due
+		if (actions.empty())
+			_delayedActions.advance(now, actions);
 	}
 }
 
@@ -512,7 +512,7 @@ void Module::delayScript(const Common::UString &script,
 	action.triggerer = triggerer;
 	action.timestamp = EventMan.getTimestamp() + delay;
 
-	_delayedActions.insert(action);
+	_delayedActions.add(action.timestamp, action);
 }
 
 Common::UString Module::getName(const Common::UString &module) {
@@ -26,11 +26,11 @@
 #define ENGINES_KOTOR_MODULE_H
 
 #include <list>
-#include <set>
 
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
 #include "src/common/changeid.h"
+#include "src/common/timerwheel.h"
 #include "src/common/configman.h"
 
 #include "src/aurora/ifofile.h"
@@ -138,12 +138,10 @@ private:
 		Aurora::NWScript::Object *triggerer;
 
 		uint32 timestamp;
-
-		bool operator<(const Action &s) const;
 	};
 
 	typedef std::list<Events::Event> EventQueue;
-	typedef std::multiset<Action> ActionQueue;
+	typedef Common::TimerWheel<Action> ActionQueue;
 
 
 	::Engines::Console *_console;
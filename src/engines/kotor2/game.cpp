@@ -29,6 +29,7 @@
 #include "src/common/filepath.h"
 #include "src/common/filelist.h"
 #include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/events/events.h"
 
@@ -96,7 +97,10 @@ void Game::runModule() {
 		while (EventMan.pollEvent(event))
 			_module->addEvent(event);
 
-		_module->processEventQueue();
+		{
+			Common::ProfileZone profile("processEventQueue");
+			_module->processEventQueue();
+		}
 		EventMan.delay(10);
 	}
 
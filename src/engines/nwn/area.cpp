@@ -53,7 +53,7 @@ namespace Engines {
 namespace NWN {
 
 Area::Area(Module &module, const Common::UString &resRef) : Object(kObjectTypeArea),
-	_module(&module), _resRef(resRef), _visible(false),
+	_module(&module), _resRef(resRef), _visible(false), _modelsLoaded(false), _modelLoadStep(0),
 	_activeObject(0), _highlightAll(false) {
 
 	try {
@@ -74,6 +74,8 @@ Area::~Area() {
 
 	removeFocus();
 
+	unloadModels();
+
 	clear();
 }
 
@@ -135,6 +137,11 @@ const Common::UString &Area::getEnvironmentMap() const {
 	return _tileset ? _tileset->getEnvironmentMap() : kEmptyString;
 }
 
+void Area::getSize(float &width, float &height) const {
+	width  = _width  * 10.0f;
+	height = _height * 10.0f;
+}
+
 uint32 Area::getMusicDayTrack() const {
 	return _musicDayTrack;
 }
@@ -263,8 +270,6 @@ void Area::hide() {
 
 	GfxMan.unlockFrame();
 
-	unloadModels();
-
 	_visible = false;
 }
 
@@ -387,40 +392,69 @@ void Area::loadTile(const Aurora::GFF3Struct &t, Tile &tile) {
 	tile.model = 0;
 }
 
+bool Area::hasModels() const {
+	return _modelsLoaded;
+}
+
+void Area::getLinkedTags(std::list<Common::UString> &tags) const {
+	for (ObjectList::const_iterator o = _objects.begin(); o != _objects.end(); ++o) {
+		const Door *door = dynamic_cast<const Door *>(*o);
+		if (door && !door->getLinkedTag().empty())
+			tags.push_back(door->getLinkedTag());
+	}
+}
+
 void Area::loadModels() {
-	loadTileModels();
+	while (loadModelsStep())
+		;
+}
 
-	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o) {
-		NWN::Object &object = **o;
+bool Area::loadModelsStep() {
+	if (_modelsLoaded)
+		return false;
 
-		object.loadModel();
+	try {
+		if      (_modelLoadStep == 0)
+			loadTileset();
+		else if (_modelLoadStep <= _tiles.size())
+			loadTileModel(_modelLoadStep - 1);
+		else if (_modelLoadObject != _objects.end())
+			loadObjectModel(**_modelLoadObject++);
 
-		if (!object.isStatic()) {
-			const std::list<uint32> &ids = object.getIDs();
+		if (_modelLoadStep++ == 0)
+			_modelLoadObject = _objects.begin();
 
-			for (std::list<uint32>::const_iterator id = ids.begin(); id != ids.end(); ++id)
-				_objectMap.insert(std::make_pair(*id, &object));
-		}
+	} catch (...) {
+		unloadModels();
+		throw;
 	}
+
+	_modelsLoaded = (_modelLoadStep > _tiles.size()) && (_modelLoadObject == _objects.end());
+
+	return !_modelsLoaded;
+}
+
+float Area::getModelLoadProgress() const {
+	if (_modelsLoaded)
+		return 1.0f;
+
+	return ((float) _modelLoadStep) / (1 + _tiles.size() + _objects.size());
 }
 
 void Area::unloadModels() {
+	if (_visible)
+		return;
+
 	_objectMap.clear();
 
 	for (ObjectList::iterator o = _objects.begin(); o != _objects.end(); ++o)
 		(*o)->unloadModel();
 
-	unloadTileModels();
-}
-
-void Area::loadTileModels() {
-	loadTileset();
-	loadTiles();
-}
-
-void Area::unloadTileModels() {
 	unloadTiles();
 	unloadTileset();
+
+	_modelsLoaded  = false;
+	_modelLoadStep = 0;
 }
 
 void Area::loadTileset() {
@@ -441,45 +475,47 @@ void Area::unloadTileset() {
 	_tileset.reset();
 }
 
-void Area::loadTiles() {
-	for (uint32 y = 0; y < _height; y++) {
-		for (uint32 x = 0; x < _width; x++) {
-			uint32 n = y * _width + x;
+void Area::loadTileModel(size_t n) {
+	const uint32 x = n % _width;
+	const uint32 y = n / _width;
 
-			Tile &t = _tiles[n];
+	Tile &t = _tiles[n];
 
-			t.tile = &_tileset->getTile(t.tileID);
+	t.tile = &_tileset->getTile(t.tileID);
 
-			t.model = loadModelObject(t.tile->model);
-			if (!t.model)
-				throw Common::Exception("Can't load tile model \"%s\"", t.tile->model.c_str());
+	t.model = loadModelObject(t.tile->model);
+	if (!t.model)
+		throw Common::Exception("Can't load tile model \"%s\"", t.tile->model.c_str());
 
-			// A tile is 10 units wide and deep.
-			// There's extra special 5x5 tiles at the edges.
-			const float tileX = x * 10.0f + 5.0f;
-			const float tileY = y * 10.0f + 5.0f;
+	// A tile is 10 units wide and deep.
+	// There's extra special 5x5 tiles at the edges.
+	const float tileX = x * 10.0f + 5.0f;
+	const float tileY = y * 10.0f + 5.0f;
 
-			// The actual height of a tile is dictated by the tileset.
-			const float tileZ = t.height * _tileset->getTilesHeight();
+	// The actual height of a tile is dictated by the tileset.
+	const float tileZ = t.height * _tileset->getTilesHeight();
 
-			t.model->setPosition(tileX, tileY, tileZ);
-			t.model->setOrientation(0.0f, 0.0f, 1.0f, ((int) t.orientation) * 90.0f);
-		}
-	}
+	t.model->setPosition(tileX, tileY, tileZ);
+	t.model->setOrientation(0.0f, 0.0f, 1.0f, ((int) t.orientation) * 90.0f);
 }
 
 void Area::unloadTiles() {
-	for (uint32 y = 0; y < _height; y++) {
-		for (uint32 x = 0; x < _width; x++) {
-			uint32 n = y * _width + x;
+	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t) {
+		t->tile = 0;
 
-			Tile &t = _tiles[n];
+		delete t->model;
+		t->model = 0;
+	}
+}
 
-			t.tile = 0;
+void Area::loadObjectModel(NWN::Object &object) {
+	object.loadModel();
 
-			delete t.model;
-			t.model = 0;
-		}
+	if (!object.isStatic()) {
+		const std::list<uint32> &ids = object.getIDs();
+
+		for (std::list<uint32>::const_iterator id = ids.begin(); id != ids.end(); ++id)
+			_objectMap.insert(std::make_pair(*id, &object));
 	}
 }
 
@@ -77,10 +77,36 @@ public:
 	/** Return the area's environment map. */
 	const Common::UString &getEnvironmentMap() const;
 
+	/** Return the size of the area in world units, as seen from top-down. */
+	void getSize(float &width, float &height) const;
+
 	// Visibility
 
-	void show(); ///< Show the area.
-	void hide(); ///< Hide the area.
+	void show(); ///< Show the area, loading its models if necessary.
+	void hide(); ///< Hide the area. Its models stay loaded.
+
+	// Models
+
+	/** Are the models of the area's tiles and objects loaded? */
+	bool hasModels() const;
+
+	/** Load the models of all tiles and objects, so that the area can be shown quickly. */
+	void loadModels();
+	/** Load the next model of the area's tileset, tiles and objects.
+	 *
+	 *  Together, the steps do the same work as loadModels(), but they can
+	 *  be spread over several frames.
+	 *
+	 *  @return true if there are still models left to load.
+	 */
+	bool loadModelsStep();
+	/** Return how much of the models are loaded, from 0.0 to 1.0. */
+	float getModelLoadProgress() const;
+	/** Unload the models of all tiles and objects. Does nothing while the area is visible. */
+	void unloadModels();
+
+	/** Add the tags of all objects the area's doors lead to to the list. */
+	void getLinkedTags(std::list<Common::UString> &tags) const;
 
 	// Music/Sound
 
@@ -174,7 +200,11 @@ private:
 	float _ambientDayVol;   ///< Day ambient sound volume.
 	float _ambientNightVol; ///< Night ambient sound volume.
 
-	bool _visible; ///< Is the area currently visible?
+	bool _visible;      ///< Is the area currently visible?
+	bool _modelsLoaded; ///< Are the models of the tiles and objects loaded?
+
+	size_t _modelLoadStep; ///< The next step of loading the models.
+	ObjectList::iterator _modelLoadObject; ///< The next object to load the model of.
 
 	Sound::ChannelHandle _ambientSound; ///< Sound handle of the currently playing sound.
 	Sound::ChannelHandle _ambientMusic; ///< Sound handle of the currently playing music.
@@ -221,18 +251,14 @@ private:
 
 	// Model loading/unloading helpers
 
-	void loadModels();
-	void unloadModels();
-
-	void loadTileModels();
-	void unloadTileModels();
-
 	void loadTileset();
 	void unloadTileset();
 
-	void loadTiles();
+	void loadTileModel(size_t n);
 	void unloadTiles();
 
+	void loadObjectModel(NWN::Object &object);
+
 	// Highlight / active helpers
 
 	void checkActive(int x = -1, int y = -1);
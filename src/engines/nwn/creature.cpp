@@ -588,7 +588,9 @@ void Creature::finishPLTs(const std::list<Graphics::Aurora::TextureHandle> &plts
 		plt->setLayerColor(Graphics::Aurora::PLTFile::kLayerCloth1  , _colorCloth1);
 		plt->setLayerColor(Graphics::Aurora::PLTFile::kLayerCloth2  , _colorCloth2);
 
-		plt->rebuild();
+		// Identically colored PLTs share one texture, which is then already built
+		if (!TextureMan.sharePLT(*p))
+			plt->rebuild();
 	}
 }
 
@@ -641,6 +643,10 @@ void Creature::loadModel() {
 			finishPLTs(_bodyParts[i].textures);
 		}
 
+		// Draw all body parts together, following the animated part nodes
+		if (ConfigMan.getBool("bakecreatures"))
+			_model->bakeAttachedModels();
+
 	} else
 		_model.reset(loadModelObject(appearance.getString("RACE")));
 
@@ -258,6 +258,12 @@ bool Door::isOpen() const {
 	return (_state == kStateOpened1) || (_state == kStateOpened2);
 }
 
+const Common::UString &Door::getLinkedTag() const {
+	static const Common::UString kNoLink;
+
+	return (_linkedToFlag != kLinkedToNothing) ? _linkedTo : kNoLink;
+}
+
 void Door::evaluateLink() {
 	if (_evaluatedLink)
 		return;
@@ -69,6 +69,9 @@ public:
 	/** Lock/Unlock the door. */
 	void setLocked(bool locked);
 
+	/** Return the tag of the object this door links to, or "" if it doesn't link anywhere. */
+	const Common::UString &getLinkedTag() const;
+
 	// Object/Cursor interactions
 
 	void enter(); ///< The cursor entered the door.
@@ -29,6 +29,7 @@
 #include "src/common/filepath.h"
 #include "src/common/filelist.h"
 #include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/aurora/resman.h"
 
@@ -37,6 +38,7 @@
 #include "src/sound/sound.h"
 
 #include "src/engines/aurora/util.h"
+#include "src/engines/aurora/benchmark.h"
 
 #include "src/engines/nwn/game.h"
 #include "src/engines/nwn/nwn.h"
@@ -44,6 +46,7 @@
 #include "src/engines/nwn/console.h"
 #include "src/engines/nwn/module.h"
 #include "src/engines/nwn/area.h"
+#include "src/engines/nwn/creature.h"
 
 #include "src/engines/nwn/gui/legal.h"
 #include "src/engines/nwn/gui/main/main.h"
@@ -78,6 +81,13 @@ void Game::run() {
 
 	_module.reset(new Module(*_console, *_version));
 
+	if (Benchmark::isRequested()) {
+		runBenchmark();
+
+		_module.reset();
+		return;
+	}
+
 	while (!EventMan.quitRequested()) {
 		mainMenu(first, first);
 		runModule();
@@ -102,7 +112,10 @@ void Game::runModule() {
 		while (EventMan.pollEvent(event))
 			_module->addEvent(event);
 
-		_module->processEventQueue();
+		{
+			Common::ProfileZone profile("processEventQueue");
+			_module->processEventQueue();
+		}
 		EventMan.delay(10);
 	}
 
@@ -112,6 +125,82 @@ void Game::runModule() {
 	_module->clear();
 }
 
+void Game::runBenchmark() {
+	Benchmark benchmark;
+
+	Common::UString module = ConfigMan.getString("benchmarkmodule");
+	if (module.empty())
+		throw Common::Exception("No benchmark module given");
+
+	if (!hasModule(module))
+		module += ".mod";
+
+	// Use the specified character, or just the first one we can find
+	Common::UString pc = ConfigMan.getString("benchmarkpc");
+	if (pc.empty()) {
+		std::vector<Common::UString> characters;
+		getCharacters(characters, true);
+
+		if (characters.empty())
+			throw Common::Exception("No character to benchmark with");
+
+		pc = characters.front();
+	}
+
+	_module->load(module);
+	_module->usePC(pc, true);
+
+	if (!_module->isLoaded())
+		return;
+
+	_module->enter();
+
+	const Common::UString area = ConfigMan.getString("benchmarkarea");
+	if (!area.empty())
+		_module->movePC(area);
+
+	bool started = false;
+	while (!EventMan.quitRequested() && _module->isRunning()) {
+		// Ignore all input, so that it can't influence the benchmark
+		Events::Event event;
+		while (EventMan.pollEvent(event))
+			;
+
+		{
+			Common::ProfileZone profile("processEventQueue");
+			_module->processEventQueue();
+		}
+
+		// Start once we're inside the area and it's been loaded
+		Area *currentArea = _module->getCurrentArea();
+		if (!started && currentArea) {
+			float width, height;
+			currentArea->getSize(width, height);
+
+			float x, y, z;
+			_module->getPC()->getPosition(x, y, z);
+
+			const float radius = MAX(width, height) / 4.0f;
+			benchmark.setDefaultPath(width / 2.0f, height / 2.0f, z, radius, radius / 2.0f);
+
+			benchmark.start();
+			started = true;
+		}
+
+		if (started && !benchmark.update())
+			break;
+
+		EventMan.delay(10);
+	}
+
+	benchmark.finish();
+
+	_module->leave();
+	_module->clear();
+
+	EventMan.requestQuit();
+}
+
 void Game::playMenuMusic(Common::UString music) {
 	stopMenuMusic();
 
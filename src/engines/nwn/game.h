@@ -94,6 +94,9 @@ private:
 
 	void mainMenu(bool playStartSound, bool showLegal);
 	void runModule();
+
+	/** Run the benchmark requested on the command line, instead of the game. */
+	void runBenchmark();
 };
 
 } // End of namespace NWN
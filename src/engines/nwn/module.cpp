@@ -22,6 +22,8 @@
  *  The context needed to run a Neverwinter Nights module.
  */
 
+#include <algorithm>
+
 #include "src/common/util.h"
 #include "src/common/maths.h"
 #include "src/common/error.h"
@@ -47,6 +49,7 @@
 #include "src/engines/aurora/tokenman.h"
 #include "src/engines/aurora/camera.h"
 #include "src/engines/aurora/console.h"
+#include "src/engines/aurora/loadprogress.h"
 
 #include "src/engines/nwn/types.h"
 #include "src/engines/nwn/version.h"
@@ -97,14 +100,34 @@ namespace Engines {
 
 namespace NWN {
 
-bool Module::Action::operator<(const Action &s) const {
-	return timestamp < s.timestamp;
-}
+/** The number of steps the area loading progress is shown in. */
+static const size_t kAreaLoadSteps = 10;
+
+/** Loading the models of an area, one model at a time. */
+class AreaLoadTask : public LoadTask {
+public:
+	AreaLoadTask(Area &area) : LoadTask("area \"" + area.getResRef() + "\""), _area(&area) {
+	}
+
+	float getProgress() const {
+		return _area->getModelLoadProgress();
+	}
+
+	bool step() {
+		return _area->loadModelsStep();
+	}
+
+private:
+	Area *_area;
+};
+
 
 
 Module::Module(::Engines::Console &console, const Version &gameVersion) : Object(kObjectTypeModule),
 	_console(&console), _gameVersion(&gameVersion), _hasModule(false),
-	_running(false), _currentTexturePack(-1), _exit(false), _currentArea(0) {
+	_running(false), _currentTexturePack(-1), _exit(false), _currentArea(0),
+	_loadingArea(0), _preloadingArea(0),
+	_loadProgressStep(0) {
 
 	_ingameGUI.reset(new IngameGUI(*this, _console));
 }
@@ -339,6 +362,10 @@ void Module::enter() {
 
 		loadTLK();
 		loadHAKs();
+
+		// The module and its HAKs might override 2DAs we already have loaded
+		TwoDAReg.clearChanged();
+
 		loadAreas();
 
 	} catch (Common::Exception &e) {
@@ -396,32 +423,58 @@ void Module::enterArea() {
 	if (_currentArea && (_currentArea->getResRef() == _newArea))
 		return;
 
-	_ingameGUI->stopConversation();
+	// We're already loading a different area; start over
+	if (_loadingArea && (_loadingArea->getResRef() != _newArea))
+		stopLoadingArea();
 
-	if (_currentArea) {
-		_pc->hide();
+	if (!_loadingArea) {
+		_ingameGUI->stopConversation();
 
-		_currentArea->runScript(kScriptExit, _currentArea, _pc.get());
-		_currentArea->hide();
+		leaveArea();
 
-		_currentArea = 0;
+		if (_newArea.empty()) {
+			_exit = true;
+			return;
+		}
+
+		Area *area = getArea(_newArea);
+		if (!area) {
+			warning("Failed entering area \"%s\": No such area", _newArea.c_str());
+			_exit = true;
+			return;
+		}
+
+		/* Load the models of the new area a bit each time the event queue is
+		 * processed, instead of all at once. That way, the game doesn't freeze,
+		 * and we can show the progress while loading. */
+
+		if (!area->hasModels())
+			startLoadingArea(*area);
+		else
+			_currentArea = area;
 	}
 
-	if (_newArea.empty()) {
-		_exit = true;
-		return;
+	if (_loadingArea) {
+		Area *area = _loadingArea;
+		if (!loadAreaModels())
+			return;
+
+		_currentArea = area;
 	}
 
-	AreaMap::iterator area = _areas.find(_newArea);
-	if (area == _areas.end() || !area->second) {
-		warning("Failed entering area \"%s\": No such area", _newArea.c_str());
+	try {
+		_currentArea->show();
+	} catch (...) {
+		_currentArea = 0;
+
+		Common::exceptionDispatcherWarning("Failed entering area \"%s\"", _newArea.c_str());
 		_exit = true;
 		return;
 	}
 
-	_currentArea = area->second;
+	findNearAreas();
+	unloadFarAreas();
 
-	_currentArea->show();
 	_pc->show();
 
 	EventMan.flushEvents();
@@ -435,6 +488,76 @@ void Module::enterArea() {
 	_console->printf("Entering area \"%s\"", _currentArea->getResRef().c_str());
 }
 
+void Module::leaveArea() {
+	if (!_currentArea)
+		return;
+
+	_pc->hide();
+
+	_currentArea->runScript(kScriptExit, _currentArea, _pc.get());
+	_currentArea->hide();
+
+	// Without preloading, keep only the models of the area we're in
+	if (!ConfigMan.getBool("preloadareas"))
+		_currentArea->unloadModels();
+
+	_currentArea = 0;
+}
+
+void Module::startLoadingArea(Area &area) {
+	// Stop preloading. What was loaded so far stays, unless it's an area we don't need
+	if (_preloadingArea && (_preloadingArea != &area))
+		_preloadingArea->unloadModels();
+
+	_loadScheduler.clear();
+	_preloadingArea = 0;
+
+	_loadingArea = &area;
+	_loadScheduler.add(new AreaLoadTask(area));
+
+	_loadProgressStep = 0;
+	_loadProgress.reset(new LoadProgress(kAreaLoadSteps + 1));
+	_loadProgress->step("Loading area \"" + area.getName() + "\"");
+}
+
+void Module::stopLoadingArea() {
+	_loadScheduler.clear();
+
+	// If we didn't finish, we're not entering the area after all. Drop what was loaded of it
+	if (_loadingArea && !_loadingArea->hasModels())
+		_loadingArea->unloadModels();
+
+	_loadingArea = 0;
+	_loadProgress.reset();
+}
+
+bool Module::loadAreaModels() {
+	const uint32 budget = MAX(ConfigMan.getInt("loadbudget"), 1);
+
+	bool done = false;
+	try {
+		done = _loadScheduler.run(budget);
+	} catch (...) {
+		_failedAreas.insert(_newArea);
+		stopLoadingArea();
+
+		Common::exceptionDispatcherWarning("Failed entering area \"%s\"", _newArea.c_str());
+		_exit = true;
+		return false;
+	}
+
+	// Only show coarse steps, since updating the progress display takes time on its own
+	const size_t step = done ? kAreaLoadSteps : (size_t) (_loadingArea->getModelLoadProgress() * kAreaLoadSteps);
+	for (; _loadProgressStep < step; _loadProgressStep++)
+		_loadProgress->step("Loading area \"" + _loadingArea->getName() + "\"");
+
+	if (!done)
+		return false;
+
+	stopLoadingArea();
+	return true;
+}
+
 void Module::exit() {
 	_ingameGUI->abortMain();
 
@@ -463,9 +586,17 @@ void Module::processEventQueue() {
 	if (!isRunning())
 		return;
 
+	// Still loading the new area. Nothing to do until we're in it
+	if (_loadingArea) {
+		_eventQueue.clear();
+		return;
+	}
+
 	handleEvents();
 	handleActions();
 
+	preloadAreas();
+
 	_ingameGUI->updatePartyMember(0, *_pc);
 }
 
@@ -512,19 +643,23 @@ void Module::handleEvents() {
 }
 
 void Module::handleActions() {
-	uint32 now = EventMan.getTimestamp();
+	const uint32 now = EventMan.getTimestamp();
 
-	while (!_delayedActions.empty()) {
-		ActionQueue::iterator action = _delayedActions.begin();
+	std::list<Action> actions;
+	_delayedActions.advance(now, actions);
 
-		if (now < action->timestamp)
-			break;
+	while (!actions.empty()) {
+		const Action &action = actions.front();
 
-		if (action->type == kActionScript)
-			ScriptContainer::runScript(action->script, action->state,
-			                           action->owner, action->triggerer);
+		if (action.type == kActionScript)
+			ScriptContainer::runScript(action.script, action.state,
+			                           action.owner, action.triggerer);
 
-		_delayedActions.erase(action);
+		actions.pop_front();
+
+		// The scripts might have delayed more actions that are already due
+		if (actions.empty())
+			_delayedActions.advance(now, actions);
 	}
 }
 
@@ -548,8 +683,6 @@ void Module::unloadModule() {
 	_eventQueue.clear();
 	_delayedActions.clear();
 
-	TwoDAReg.clear();
-
 	clearVariables();
 	clearScripts();
 
@@ -559,6 +692,9 @@ void Module::unloadModule() {
 
 	deindexResources(_resModule);
 
+	// Drop the 2DAs the module and its HAKs brought, but keep the preloaded ones
+	TwoDAReg.clearChanged();
+
 	_newModule.clear();
 	_hasModule = false;
 }
@@ -634,6 +770,10 @@ void Module::unloadTexturePack() {
 }
 
 void Module::loadAreas() {
+	/* Construct all areas right away, so that their objects can be found by
+	 * their tags. Only the models are loaded when an area is first entered,
+	 * or preloaded while the PC is in a nearby area. */
+
 	status("Loading areas...");
 
 	const std::vector<Common::UString> &areas = _ifo.getAreas();
@@ -658,10 +798,135 @@ void Module::loadAreas() {
 void Module::unloadAreas() {
 	_ingameGUI->stopConversation();
 
+	stopLoadingArea();
+	_preloadingArea = 0;
+
 	_areas.clear();
 	_newArea.clear();
 
 	_currentArea = 0;
+
+	_nearAreas.clear();
+
+	_failedAreas.clear();
+}
+
+Area *Module::getArea(const Common::UString &resRef) {
+	AreaMap::iterator area = _areas.find(resRef);
+	if (area == _areas.end())
+		return 0;
+
+	return area->second;
+}
+
+void Module::findNearAreas() {
+	_nearAreas.clear();
+
+	if (!_currentArea)
+		return;
+
+	std::list<Common::UString> tags;
+	_currentArea->getLinkedTags(tags);
+
+	for (std::list<Common::UString>::const_iterator t = tags.begin(); t != tags.end(); ++t) {
+		NWN::Object *object = dynamic_cast<NWN::Object *>(getFirstObjectByTag(*t));
+		if (!object || !object->getArea() || (object->getArea() == _currentArea))
+			continue;
+
+		const Common::UString &area = object->getArea()->getResRef();
+		if (std::find(_nearAreas.begin(), _nearAreas.end(), area) == _nearAreas.end())
+			_nearAreas.push_back(area);
+	}
+}
+
+void Module::preloadAreas() {
+	if (!_currentArea || !ConfigMan.getBool("preloadareas"))
+		return;
+
+	/* The models of the areas the current area's doors lead to are loaded a
+	 * bit each time the event queue is processed, within a part of the
+	 * per-frame load budget, so that the game stays responsive. */
+
+	// The current area always counts against the budget
+	const int budget = MAX(ConfigMan.getInt("areacache"), 1) - 1;
+
+	int count = 0;
+	for (std::list<Common::UString>::const_iterator a = _nearAreas.begin();
+	     (a != _nearAreas.end()) && (count < budget); ++a, count++) {
+
+		if (_failedAreas.find(*a) != _failedAreas.end())
+			continue;
+
+		AreaMap::iterator area = _areas.find(*a);
+		if (area == _areas.end())
+			continue;
+
+		if (!area->second->hasModels()) {
+			if (_preloadingArea != area->second) {
+				if (_preloadingArea)
+					_preloadingArea->unloadModels();
+
+				status("Preloading area \"%s\"", a->c_str());
+
+				_loadScheduler.clear();
+				_loadScheduler.add(new AreaLoadTask(*area->second));
+
+				_preloadingArea = area->second;
+			}
+
+			// Preloading gets a smaller part of the frame, since we're playing at the same time
+			const uint32 loadBudget = MAX(ConfigMan.getInt("loadbudget") / 4, 1);
+
+			bool done = false;
+			try {
+				done = _loadScheduler.run(loadBudget);
+			} catch (...) {
+				_failedAreas.insert(*a);
+				_preloadingArea = 0;
+
+				Common::exceptionDispatcherWarning("Can't preload area \"%s\"", a->c_str());
+				done = true;
+			}
+
+			if (done) {
+				_preloadingArea = 0;
+				unloadFarAreas();
+			}
+
+			return;
+		}
+	}
+}
+
+void Module::unloadFarAreas() {
+	// Stop preloading an area we're no longer near to, and drop what was loaded of it
+	if (_preloadingArea && (_preloadingArea != _currentArea) &&
+	    (std::find(_nearAreas.begin(), _nearAreas.end(), _preloadingArea->getResRef()) == _nearAreas.end())) {
+
+		_loadScheduler.clear();
+
+		_preloadingArea->unloadModels();
+		_preloadingArea = 0;
+	}
+
+	const size_t budget = MAX(ConfigMan.getInt("areacache"), 1);
+
+	std::list<Area *> loaded, far;
+	for (AreaMap::iterator a = _areas.begin(); a != _areas.end(); ++a) {
+		if (!a->second || !a->second->hasModels())
+			continue;
+
+		loaded.push_back(a->second);
+
+		if ((a->second != _currentArea) &&
+		    (std::find(_nearAreas.begin(), _nearAreas.end(), a->first) == _nearAreas.end()))
+			far.push_back(a->second);
+	}
+
+	for (std::list<Area *>::iterator a = far.begin(); (a != far.end()) && (loaded.size() > budget); ++a) {
+		(*a)->unloadModels();
+		loaded.remove(*a);
+	}
 }
 
 void Module::showMenu() {
@@ -703,13 +968,7 @@ void Module::movePC(const Common::UString &area, float x, float y, float z) {
 	if (!_pc)
 		return;
 
-	Area *pcArea = 0;
-
-	AreaMap::iterator a = _areas.find(area);
-	if (a != _areas.end())
-		pcArea = a->second;
-
-	movePC(pcArea, x, y, z);
+	movePC(getArea(area), x, y, z);
 }
 
 void Module::movePC(Area *area, float x, float y, float z) {
@@ -762,7 +1021,7 @@ void Module::delayScript(const Common::UString &script,
 	action.triggerer = triggerer;
 	action.timestamp = EventMan.getTimestamp() + delay;
 
-	_delayedActions.insert(action);
+	_delayedActions.add(action.timestamp, action);
 }
 
 Common::UString Module::getDescriptionExtra(Common::UString module) {
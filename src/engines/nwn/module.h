@@ -33,6 +33,7 @@
 #include "src/common/ptrmap.h"
 #include "src/common/ustring.h"
 #include "src/common/changeid.h"
+#include "src/common/timerwheel.h"
 
 #include "src/aurora/ifofile.h"
 
@@ -41,6 +42,7 @@
 #include "src/events/types.h"
 
 #include "src/engines/aurora/resources.h"
+#include "src/engines/aurora/loadscheduler.h"
 
 #include "src/engines/nwn/objectcontainer.h"
 #include "src/engines/nwn/object.h"
@@ -48,6 +50,7 @@
 namespace Engines {
 
 class Console;
+class LoadProgress;
 
 namespace NWN {
 
@@ -91,6 +94,8 @@ public:
 	// .--- Elements of the current module
 	/** Return the area the PC is currently in. */
 	Area *getCurrentArea();
+	/** Return an area of the module. */
+	Area *getArea(const Common::UString &resRef);
 	/** Return the currently playing PC. */
 	Creature *getPC();
 	// '---
@@ -162,14 +167,12 @@ private:
 		Aurora::NWScript::Object *triggerer;
 
 		uint32 timestamp;
-
-		bool operator<(const Action &s) const;
 	};
 
 	typedef Common::PtrMap<Common::UString, Area> AreaMap;
 
 	typedef std::list<Events::Event> EventQueue;
-	typedef std::multiset<Action> ActionQueue;
+	typedef Common::TimerWheel<Action> ActionQueue;
 
 
 	::Engines::Console *_console;
@@ -203,6 +206,18 @@ private:
 	Common::UString _newArea;         ///< The new area to enter.
 	Area           *_currentArea;     ///< The current area.
 
+	std::list<Common::UString> _nearAreas; ///< The areas the current area's doors lead to.
+
+	std::set<Common::UString> _failedAreas; ///< Areas that failed to load or preload.
+
+	LoadScheduler _loadScheduler; ///< Loads area models a bit each frame.
+
+	Area *_loadingArea;    ///< The area we're loading, to enter it afterwards.
+	Area *_preloadingArea; ///< The area we're loading in advance.
+
+	Common::ScopedPtr<LoadProgress> _loadProgress; ///< The progress of loading an area.
+	size_t _loadProgressStep; ///< The last progress step shown.
+
 	Common::UString _newModule; ///< The module we should change to.
 
 	EventQueue  _eventQueue;
@@ -239,6 +254,15 @@ private:
 	void loadAreas();       ///< Load the areas.
 	// '---
 
+	// .--- Area preloading
+	/** Find the areas the current area's doors lead to. */
+	void findNearAreas();
+	/** Do one step of loading the areas near the current area in advance. */
+	void preloadAreas();
+	/** Unload the models of areas not near the current area, to stay within the budget. */
+	void unloadFarAreas();
+	// '---
+
 	static Common::UString getDescriptionExtra   (Common::UString module);
 	static Common::UString getDescriptionCampaign(Common::UString module);
 
@@ -246,6 +270,14 @@ private:
 	void removePCTokens();
 
 	void enterArea(); ///< Enter a new area.
+	void leaveArea(); ///< Leave the current area.
+
+	/** Start loading the models of an area we're about to enter. */
+	void startLoadingArea(Area &area);
+	/** Stop loading the area we're about to enter, unloading its models if they're incomplete. */
+	void stopLoadingArea();
+	/** Continue loading the area we're about to enter. Return true when finished. */
+	bool loadAreaModels();
 
 	/** Load the actual module. */
 	void loadModule(const Common::UString &module);
@@ -34,6 +34,7 @@
 #include "src/aurora/language.h"
 #include "src/aurora/talkman.h"
 #include "src/aurora/talktable_tlk.h"
+#include "src/aurora/2dareg.h"
 
 #include "src/events/events.h"
 
@@ -46,6 +47,7 @@
 #include "src/engines/aurora/tokenman.h"
 #include "src/engines/aurora/resources.h"
 #include "src/engines/aurora/model.h"
+#include "src/engines/aurora/benchmark.h"
 
 #include "src/engines/nwn/nwn.h"
 #include "src/engines/nwn/version.h"
@@ -113,6 +115,10 @@ Game &NWNEngine::getGame() {
 	return *_game;
 }
 
+bool NWNEngine::canBenchmark() const {
+	return true;
+}
+
 void NWNEngine::run() {
 	init();
 	if (EventMan.quitRequested())
@@ -121,7 +127,8 @@ void NWNEngine::run() {
 	CursorMan.hideCursor();
 	CursorMan.set();
 
-	playIntroVideos();
+	if (!Benchmark::isRequested())
+		playIntroVideos();
 	if (EventMan.quitRequested())
 		return;
 
@@ -134,7 +141,7 @@ void NWNEngine::run() {
 }
 
 void NWNEngine::init() {
-	LoadProgress progress(20);
+	LoadProgress progress(21);
 
 	progress.step("Declare languages");
 	declareLanguages();
@@ -170,6 +177,9 @@ void NWNEngine::init() {
 	progress.step("Initializing internal game config");
 	initGameConfig();
 
+	progress.step("Preloading 2DAs");
+	preload2DAs();
+
 	progress.step("Successfully initialized the engine");
 }
 
@@ -426,9 +436,13 @@ void NWNEngine::initConfig() {
 	ConfigMan.setInt(Common::kConfigRealmDefault, "difficulty"   ,   0);
 	ConfigMan.setInt(Common::kConfigRealmDefault, "feedbackmode" ,   2);
 	ConfigMan.setInt(Common::kConfigRealmDefault, "tooltipdelay" , 100);
+	ConfigMan.setInt(Common::kConfigRealmDefault, "areacache"    ,   3);
+	ConfigMan.setInt(Common::kConfigRealmDefault, "loadbudget"   ,  16);
 
 	ConfigMan.setBool(Common::kConfigRealmDefault, "largefonts"       , false);
 	ConfigMan.setBool(Common::kConfigRealmDefault, "mouseoverfeedback", true);
+	ConfigMan.setBool(Common::kConfigRealmDefault, "bakecreatures"    , false);
+	ConfigMan.setBool(Common::kConfigRealmDefault, "preloadareas"     , true);
 }
 
 void NWNEngine::initGameConfig() {
@@ -453,6 +467,30 @@ void NWNEngine::initGameConfig() {
 	// TODO: <PlayerName>
 }
 
+static Common::UString get2DASnapshotFile() {
+	if (!ConfigMan.getBool("2dasnapshot", false))
+		return "";
+
+	return Common::FilePath::getUserDataDirectory() + "/nwn_2da.snapshot";
+}
+
+void NWNEngine::preload2DAs() {
+	/* These 2DAs are needed by the character generator and by every
+	 * creature, placeable and area. Parse them in the background now,
+	 * while the intro videos play, instead of when they're first used. */
+	static const char * const k2DAs[] = {
+		"ambientmusic", "appearance", "classes", "domains", "feat", "iprp_abilities",
+		"masterfeats", "packages", "placeableobjsnds", "placeables", "portraits",
+		"racialtypes", "skills", "soundset", "spells", "spellschools"
+	};
+
+	const Common::UString snapshot = get2DASnapshotFile();
+	if (!snapshot.empty())
+		TwoDAReg.loadSnapshot(snapshot);
+
+	TwoDAReg.preload(std::vector<Common::UString>(k2DAs, k2DAs + ARRAYSIZE(k2DAs)));
+}
+
 void NWNEngine::checkConfig() {
 	checkConfigInt("menufogcount" ,   0,    5,   4);
 	checkConfigInt("texturepack"  ,   0,    3,   1);
@@ -464,6 +502,12 @@ void NWNEngine::checkConfig() {
 void NWNEngine::deinit() {
 	unregisterModelLoader();
 
+	const Common::UString snapshot = get2DASnapshotFile();
+	if (!snapshot.empty())
+		TwoDAReg.saveSnapshot(snapshot);
+
+	TwoDAReg.clear();
+
 	_version.reset();
 	_game.reset();
 }
@@ -54,6 +54,8 @@ public:
 	bool getLanguage(Aurora::Language &language) const;
 	bool changeLanguage();
 
+	bool canBenchmark() const;
+
 	/** Return the context running the actual game. */
 	Game &getGame();
 
@@ -84,6 +86,7 @@ private:
 	void declareBogusTextures();
 	void initCursors();
 	void initGameConfig();
+	void preload2DAs();
 
 	void deinit();
 
@@ -260,8 +260,8 @@ bool Object::beginConversation(Object *triggerer) {
 	ctx.setCaller(this);
 	ctx.setTriggerer(triggerer);
 
-	ctx.getParams()[0] = "";
-	ctx.getParams()[1] = (Aurora::NWScript::Object *) 0;
+	ctx.getWritableParams()[0] = "";
+	ctx.getWritableParams()[1] = (Aurora::NWScript::Object *) 0;
 
 	FunctionMan.call("BeginConversation", ctx);
 
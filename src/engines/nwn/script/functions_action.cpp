@@ -166,8 +166,8 @@ void Functions::actionJumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::actionMoveToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	NWN::Object   *object = NWN::ObjectContainer::toObject(ctx.getCaller());
-	NWN::Location *moveTo = NWN::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      NWN::Object   *object = NWN::ObjectContainer::toObject(ctx.getCaller());
+	const NWN::Location *moveTo = NWN::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
@@ -123,7 +123,7 @@ void Functions::getObjectType(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getTag(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	Aurora::NWScript::Object *object = getParamObject(ctx, 0);
 
@@ -139,7 +139,7 @@ void Functions::getName(Aurora::NWScript::FunctionContext &ctx) {
 	// TODO: bOriginalName
 
 	NWN::Object *object = NWN::ObjectContainer::toObject(getParamObject(ctx, 0));
-	ctx.getReturn().getString() = object ? object->getName() : "";
+	ctx.getReturn().setString(object ? object->getName() : "");
 }
 
 void Functions::getArea(Aurora::NWScript::FunctionContext &ctx) {
@@ -388,7 +388,7 @@ void Functions::playAnimation(Aurora::NWScript::FunctionContext &ctx) {
 
 void Functions::jumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 	NWN::Object *object = NWN::ObjectContainer::toObject(ctx.getCaller());
-	NWN::Location *moveTo = NWN::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	const NWN::Location *moveTo = NWN::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
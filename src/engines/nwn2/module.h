@@ -28,11 +28,11 @@
 #include <vector>
 #include <list>
 #include <map>
-#include <set>
 
 #include "src/common/ptrmap.h"
 #include "src/common/ustring.h"
 #include "src/common/changeid.h"
+#include "src/common/timerwheel.h"
 
 #include "src/aurora/ifofile.h"
 
@@ -138,14 +138,12 @@ private:
 		Aurora::NWScript::Object *triggerer;
 
 		uint32 timestamp;
-
-		bool operator<(const Action &s) const;
 	};
 
 	typedef Common::PtrMap<Common::UString, Area> AreaMap;
 
 	typedef std::list<Events::Event> EventQueue;
-	typedef std::multiset<Action> ActionQueue;
+	typedef Common::TimerWheel<Action> ActionQueue;
 
 
 	::Engines::Console *_console;
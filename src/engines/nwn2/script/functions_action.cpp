@@ -123,8 +123,8 @@ void Functions::actionSpeakString(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::actionJumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	NWN2::Object   *object = NWN2::ObjectContainer::toObject(ctx.getCaller());
-	NWN2::Location *moveTo = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      NWN2::Object   *object = NWN2::ObjectContainer::toObject(ctx.getCaller());
+	const NWN2::Location *moveTo = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
@@ -136,8 +136,8 @@ void Functions::actionJumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::actionMoveToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	NWN2::Object   *object = NWN2::ObjectContainer::toObject(ctx.getCaller());
-	NWN2::Location *moveTo = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      NWN2::Object   *object = NWN2::ObjectContainer::toObject(ctx.getCaller());
+	const NWN2::Location *moveTo = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
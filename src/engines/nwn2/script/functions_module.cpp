@@ -57,7 +57,7 @@ void Functions::location(Aurora::NWScript::FunctionContext &ctx) {
 void Functions::getPositionFromLocation(Aurora::NWScript::FunctionContext &ctx) {
 	ctx.getReturn().setVector(0.0f, 0.0f, 0.0f);
 
-	Location *loc = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	const Location *loc = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 	if (!loc)
 		return;
 
@@ -123,7 +123,7 @@ void Functions::getObjectType(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getTag(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	Aurora::NWScript::Object *object = getParamObject(ctx, 0);
 
@@ -139,7 +139,7 @@ void Functions::getName(Aurora::NWScript::FunctionContext &ctx) {
 	// TODO: bOriginalName
 
 	NWN2::Object *object = NWN2::ObjectContainer::toObject(getParamObject(ctx, 0));
-	ctx.getReturn().getString() = object ? object->getName() : "";
+	ctx.getReturn().setString(object ? object->getName() : "");
 }
 
 void Functions::getArea(Aurora::NWScript::FunctionContext &ctx) {
@@ -345,7 +345,7 @@ void Functions::getNearestCreature(Aurora::NWScript::FunctionContext &ctx) {
 
 void Functions::jumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 	NWN2::Object *object = NWN2::ObjectContainer::toObject(ctx.getCaller());
-	NWN2::Location *moveTo = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	const NWN2::Location *moveTo = NWN2::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
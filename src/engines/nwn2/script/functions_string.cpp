@@ -160,7 +160,7 @@ void Functions::getStringLowerCase(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getStringRight(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &str = ctx.getParams()[0].getString();
 
@@ -175,7 +175,7 @@ void Functions::getStringRight(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getStringLeft(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &str = ctx.getParams()[0].getString();
 
@@ -190,7 +190,7 @@ void Functions::getStringLeft(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::insertString(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 	if (ctx.getParams()[2].getInt() < 0) {
 		debugC(Common::kDebugEngineScripts, 1, "Functions::%s: %d",
 		       ctx.getName().c_str(), ctx.getParams()[2].getInt());
@@ -205,7 +205,7 @@ void Functions::insertString(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getSubString(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &str = ctx.getParams()[0].getString();
 
@@ -254,7 +254,7 @@ void Functions::getStringByStrRef(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::get2DAString(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	const Common::UString &file =          ctx.getParams()[0].getString();
 	const Common::UString &col  =          ctx.getParams()[1].getString();
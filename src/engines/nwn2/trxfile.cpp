@@ -23,6 +23,8 @@
  */
 
 #include "src/common/scopedptr.h"
+#include "src/common/util.h"
+#include "src/common/endianness.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
 #include "src/common/encoding.h"
@@ -35,7 +37,7 @@
 #include "src/graphics/vertexbuffer.h"
 #include "src/graphics/indexbuffer.h"
 
-#include "src/graphics/aurora/geometryobject.h"
+#include "src/graphics/aurora/terrain.h"
 
 #include "src/engines/nwn2/trxfile.h"
 
@@ -43,7 +45,9 @@ namespace Engines {
 
 namespace NWN2 {
 
-TRXFile::TRXFile(const Common::UString &resRef) : _visible(false) {
+TRXFile::TRXFile(const Common::UString &resRef) : _visible(false),
+	_terrain(new Graphics::Aurora::Terrain), _water(new Graphics::Aurora::Terrain) {
+
 	try {
 		Common::ScopedPtr<Common::SeekableReadStream> trx(ResMan.getResource(resRef, Aurora::kFileTypeTRX));
 		if (!trx)
@@ -67,10 +71,8 @@ void TRXFile::show() {
 
 	GfxMan.lockFrame();
 
-	for (ObjectList::iterator t = _terrain.begin(); t != _terrain.end(); ++t)
-		(*t)->show();
-	for (ObjectList::iterator w = _water.begin(); w != _water.end(); ++w)
-		(*w)->show();
+	_terrain->show();
+	_water->show();
 
 	_visible = true;
 
@@ -83,10 +85,8 @@ void TRXFile::hide() {
 
 	GfxMan.lockFrame();
 
-	for (ObjectList::iterator t = _terrain.begin(); t != _terrain.end(); ++t)
-		(*t)->hide();
-	for (ObjectList::iterator w = _water.begin(); w != _water.end(); ++w)
-		(*w)->hide();
+	_terrain->hide();
+	_water->hide();
 
 	_visible = false;
 
@@ -112,6 +112,9 @@ void TRXFile::load(Common::SeekableReadStream &trx) {
 
 	loadDirectory(trx, packets);
 	loadPackets(trx, packets);
+
+	_terrain->finalize();
+	_water->finalize();
 }
 
 void TRXFile::loadDirectory(Common::SeekableReadStream &trx, std::vector<Packet> &packets) {
@@ -189,46 +192,50 @@ void TRXFile::loadTRRN(Common::SeekableReadStream &trx, Packet &packet) {
 	Graphics::VertexBuffer vBuf;
 	vBuf.setVertexDeclInterleave(vCount, vertexDecl);
 
-	float *v = reinterpret_cast<float *>(vBuf.getData());
-	for (uint32 i = 0; i < vCount; i++) {
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
+	// Read all vertices and faces at once, instead of value by value
 
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
-		*v++ = ttrn.readIEEEFloatLE();
+	static const uint32 kVertexSize = 44;
 
-		for (int j = 0; j < 3; j++) {
-			int   vals = 1;
-			float rgb  = ttrn.readByte() / 255.0f;
+	if (vCount > ((ttrn.size() - ttrn.pos()) / kVertexSize))
+		throw Common::Exception(Common::kReadError);
 
-			for (int k = 0; k < 6; k++) {
-				if (!textures[k].empty()) {
-					rgb += textureColors[k][j];
-					vals++;
-				}
-			}
+	Common::ScopedArray<byte> vertexData(new byte[vCount * kVertexSize]);
+	if (ttrn.read(vertexData.get(), vCount * kVertexSize) != (vCount * kVertexSize))
+		throw Common::Exception(Common::kReadError);
 
-			rgb /= vals;
+	/* The vertex colors are the mean of the vertex' own color and the colors
+	 * of all the textures used in this tile, which is the same for all. */
 
-			*v++ = rgb;
+	int   colorCount = 1;
+	float colorSum[3] = { 0.0f, 0.0f, 0.0f };
+	for (int k = 0; k < 6; k++) {
+		if (!textures[k].empty()) {
+			for (int j = 0; j < 3; j++)
+				colorSum[j] += textureColors[k][j];
+
+			colorCount++;
 		}
+	}
 
-		*v++ = ttrn.readByte() / 255.0f;
+	float *v = reinterpret_cast<float *>(vBuf.getData());
+	for (uint32 i = 0; i < vCount; i++) {
+		const byte *vertex = vertexData.get() + i * kVertexSize;
+
+		for (int j = 0; j < 6; j++)
+			*v++ = convertIEEEFloat(READ_LE_UINT32(vertex + j * 4));
+
+		for (int j = 0; j < 3; j++)
+			*v++ = (vertex[24 + j] / 255.0f + colorSum[j]) / colorCount;
+
+		*v++ = vertex[27] / 255.0f;
 
-		ttrn.skip(16); // Some texture coordinates?
+		// 16 bytes, some texture coordinates?
 	}
 
 	Graphics::IndexBuffer iBuf;
 	iBuf.setSize(fCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
-	uint16 *f = reinterpret_cast<uint16 *>(iBuf.getData());
-	for (uint32 i = 0; i < fCount; i++) {
-		*f++ = ttrn.readUint16LE();
-		*f++ = ttrn.readUint16LE();
-		*f++ = ttrn.readUint16LE();
-	}
+	readFaces(ttrn, iBuf);
 
 	/* TODO:
 	 *   - uint32 dds1Size
@@ -239,7 +246,7 @@ void TRXFile::loadTRRN(Common::SeekableReadStream &trx, Packet &packet) {
 	 *   - Grass  grass
 	 */
 
-	_terrain.push_back(new Graphics::Aurora::GeometryObject(vBuf, iBuf));
+	_terrain->addChunk(vBuf, iBuf);
 }
 
 void TRXFile::loadWATR(Common::SeekableReadStream &trx, Packet &packet) {
@@ -284,28 +291,33 @@ void TRXFile::loadWATR(Common::SeekableReadStream &trx, Packet &packet) {
 	Graphics::VertexBuffer vBuf;
 	vBuf.setVertexDeclInterleave(vCount, vertexDecl);
 
+	static const uint32 kVertexSize = 28;
+
+	if (vCount > ((watr.size() - watr.pos()) / kVertexSize))
+		throw Common::Exception(Common::kReadError);
+
+	Common::ScopedArray<byte> vertexData(new byte[vCount * kVertexSize]);
+	if (watr.read(vertexData.get(), vCount * kVertexSize) != (vCount * kVertexSize))
+		throw Common::Exception(Common::kReadError);
+
 	float *v = reinterpret_cast<float *>(vBuf.getData());
 	for (uint32 i = 0; i < vCount; i++) {
-		*v++ = watr.readIEEEFloatLE();
-		*v++ = watr.readIEEEFloatLE();
-		*v++ = watr.readIEEEFloatLE();
+		const byte *vertex = vertexData.get() + i * kVertexSize;
+
+		for (int j = 0; j < 3; j++)
+			*v++ = convertIEEEFloat(READ_LE_UINT32(vertex + j * 4));
 
 		*v++ = color[0];
 		*v++ = color[1];
 		*v++ = color[2];
 
-		watr.skip(16); // texture coordinates?
+		// 16 bytes, texture coordinates?
 	}
 
 	Graphics::IndexBuffer iBuf;
 	iBuf.setSize(fCount * 3, sizeof(uint16), GL_UNSIGNED_SHORT);
 
-	uint16 *f = reinterpret_cast<uint16 *>(iBuf.getData());
-	for (uint32 i = 0; i < fCount; i++) {
-		*f++ = watr.readUint16LE();
-		*f++ = watr.readUint16LE();
-		*f++ = watr.readUint16LE();
-	}
+	readFaces(watr, iBuf);
 
 	/* TODO:
 	 *   - uint32  ddsSize
@@ -315,7 +327,20 @@ void TRXFile::loadWATR(Common::SeekableReadStream &trx, Packet &packet) {
 	 *   - uint32  tileY
 	 */
 
-	_water.push_back(new Graphics::Aurora::GeometryObject(vBuf, iBuf));
+	_water->addChunk(vBuf, iBuf);
+}
+
+void TRXFile::readFaces(Common::SeekableReadStream &trx, Graphics::IndexBuffer &iBuf) {
+	const uint32 size = iBuf.getCount() * sizeof(uint16);
+
+	uint16 *f = reinterpret_cast<uint16 *>(iBuf.getData());
+	if (trx.read(f, size) != size)
+		throw Common::Exception(Common::kReadError);
+
+#ifdef XOREOS_BIG_ENDIAN
+	for (uint32 i = 0; i < iBuf.getCount(); i++, f++)
+		*f = FROM_LE_16(*f);
+#endif
 }
 
 void TRXFile::loadASWM(Common::SeekableReadStream &UNUSED(trx), Packet &UNUSED(packet)) {
@@ -29,7 +29,7 @@
 #include <vector>
 
 #include "src/common/types.h"
-#include "src/common/ptrlist.h"
+#include "src/common/scopedptr.h"
 
 namespace Common {
 	class UString;
@@ -37,8 +37,10 @@ namespace Common {
 }
 
 namespace Graphics {
+	class IndexBuffer;
+
 	namespace Aurora {
-		class GeometryObject;
+		class Terrain;
 	}
 }
 
@@ -79,16 +81,13 @@ private:
 		uint32 size;   ///< Size of the packet.
 	};
 
-	typedef Common::PtrList<Graphics::Aurora::GeometryObject> ObjectList;
-
-
 	bool _visible;
 
 	uint32 _width;
 	uint32 _height;
 
-	ObjectList _terrain;
-	ObjectList _water;
+	Common::ScopedPtr<Graphics::Aurora::Terrain> _terrain; ///< The ground of all TRRN packets.
+	Common::ScopedPtr<Graphics::Aurora::Terrain> _water;   ///< The water of all WATR packets.
 
 
 	void load(Common::SeekableReadStream &trx);
@@ -110,6 +109,9 @@ private:
 	void loadTRRN(Common::SeekableReadStream &trx, Packet &packet);
 	/** Load WATR (water tile) packets. */
 	void loadWATR(Common::SeekableReadStream &trx, Packet &packet);
+	/** Read the faces of a TRRN or WATR packet into an index buffer. */
+	void readFaces(Common::SeekableReadStream &trx, Graphics::IndexBuffer &iBuf);
+
 	/** Load ASWM (walk mesh) packets. */
 	void loadASWM(Common::SeekableReadStream &trx, Packet &packet);
 };
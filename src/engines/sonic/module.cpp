@@ -24,6 +24,7 @@
 
 #include "src/common/error.h"
 #include "src/common/ustring.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/graphics/camera.h"
 
@@ -69,7 +70,10 @@ void Module::run() {
 			if (_exit)
 				break;
 
-			handleEvents();
+			{
+				Common::ProfileZone profile("handleEvents");
+				handleEvents();
+			}
 
 			if (!EventMan.quitRequested() && !_exit)
 				EventMan.delay(10);
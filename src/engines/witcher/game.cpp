@@ -30,6 +30,7 @@
 #include "src/common/configman.h"
 #include "src/common/filepath.h"
 #include "src/common/filelist.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/aurora/lua/scriptman.h"
 
@@ -111,7 +112,10 @@ void Game::runCampaign() {
 		while (EventMan.pollEvent(event))
 			_campaign->addEvent(event);
 
-		_campaign->processEventQueue();
+		{
+			Common::ProfileZone profile("processEventQueue");
+			_campaign->processEventQueue();
+		}
 		EventMan.delay(10);
 	}
 
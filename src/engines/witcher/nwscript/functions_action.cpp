@@ -123,8 +123,8 @@ void Functions::actionSpeakString(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::actionJumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	Witcher::Object   *object = Witcher::ObjectContainer::toObject(ctx.getCaller());
-	Witcher::Location *moveTo = Witcher::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      Witcher::Object   *object = Witcher::ObjectContainer::toObject(ctx.getCaller());
+	const Witcher::Location *moveTo = Witcher::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
@@ -136,8 +136,8 @@ void Functions::actionJumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::actionMoveToLocation(Aurora::NWScript::FunctionContext &ctx) {
-	Witcher::Object   *object = Witcher::ObjectContainer::toObject(ctx.getCaller());
-	Witcher::Location *moveTo = Witcher::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	      Witcher::Object   *object = Witcher::ObjectContainer::toObject(ctx.getCaller());
+	const Witcher::Location *moveTo = Witcher::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
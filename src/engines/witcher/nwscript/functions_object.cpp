@@ -123,7 +123,7 @@ void Functions::getObjectType(Aurora::NWScript::FunctionContext &ctx) {
 }
 
 void Functions::getTag(Aurora::NWScript::FunctionContext &ctx) {
-	ctx.getReturn().getString().clear();
+	ctx.getReturn().setString("");
 
 	Aurora::NWScript::Object *object = getParamObject(ctx, 0);
 	if (object)
@@ -134,7 +134,7 @@ void Functions::getName(Aurora::NWScript::FunctionContext &ctx) {
 	// TODO: bOriginalName
 
 	Witcher::Object *object = Witcher::ObjectContainer::toObject(getParamObject(ctx, 0));
-	ctx.getReturn().getString() = object ? object->getName().getString() : "";
+	ctx.getReturn().setString(object ? object->getName().getString() : "");
 }
 
 void Functions::getArea(Aurora::NWScript::FunctionContext &ctx) {
@@ -340,7 +340,7 @@ void Functions::getNearestCreature(Aurora::NWScript::FunctionContext &ctx) {
 
 void Functions::jumpToLocation(Aurora::NWScript::FunctionContext &ctx) {
 	Witcher::Object *object = Witcher::ObjectContainer::toObject(ctx.getCaller());
-	Witcher::Location *moveTo = Witcher::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
+	const Witcher::Location *moveTo = Witcher::ObjectContainer::toLocation(ctx.getParams()[0].getEngineType());
 
 	if (!object || !moveTo)
 		return;
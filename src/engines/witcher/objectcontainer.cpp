@@ -166,6 +166,10 @@ Location *ObjectContainer::toLocation(Aurora::NWScript::EngineType *engineType)
 	return dynamic_cast<Location *>(engineType);
 }
 
+const Location *ObjectContainer::toLocation(const Aurora::NWScript::EngineType *engineType) {
+	return dynamic_cast<const Location *>(engineType);
+}
+
 } // End of namespace Witcher
 
 } // End of namespace Engines
@@ -91,6 +91,7 @@ public:
 	static Creature  *toPC       (Aurora::NWScript::Object *object);
 
 	static Location *toLocation(Aurora::NWScript::EngineType *engineType);
+	static const Location *toLocation(const Aurora::NWScript::EngineType *engineType);
 
 private:
 	typedef std::list<Witcher::Object *> ObjectList;
@@ -30,6 +30,7 @@
 #include "src/common/error.h"
 #include "src/common/threads.h"
 #include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/events/events.h"
 #include "src/events/requests.h"
@@ -39,18 +40,18 @@
 
 #include "src/graphics/types.h"
 #include "src/graphics/graphics.h"
-#include "src/graphics/glcontainer.h"
 #include "src/graphics/windowman.h"
 
 DECLARE_SINGLETON(Events::EventsManager)
 
 namespace Events {
 
+/** The time to spend on queued requests each frame, in milliseconds. */
+static const uint32 kRequestQueueBudget = 4;
+
 const EventsManager::RequestHandler EventsManager::_requestHandler[kITCEventMAX] = {
 	0,
-	&EventsManager::requestCallInMainThread,
-	&EventsManager::requestRebuildGLContainer,
-	&EventsManager::requestDestroyGLContainer
+	&EventsManager::requestCallInMainThread
 };
 
 
@@ -92,6 +93,7 @@ void EventsManager::deinit() {
 
 	deinitJoysticks();
 
+	TimerMan.deinit();
 	RequestMan.deinit();
 
 	_ready = false;
@@ -338,10 +340,16 @@ void EventsManager::raiseFatalError() {
 void EventsManager::runMainLoop() {
 	while (!_doQuit) {
 		// (Pre)Process all events
-		processEvents();
+		{
+			Common::ProfileZone profile("processEvents");
+			processEvents();
+		}
 
 		_queueProcessed.signal();
 
+		// Build and destroy the GL containers the game thread queued up
+		RequestMan.processQueue(kRequestQueueBudget);
+
 		// Render a frame
 		GfxMan.renderScene();
 	}
@@ -390,12 +398,4 @@ void EventsManager::requestCallInMainThread(Request &request) {
 	(*request._callInMainThread.caller)();
 }
 
-void EventsManager::requestRebuildGLContainer(Request &request) {
-	request._glContainer.glContainer->rebuild();
-}
-
-void EventsManager::requestDestroyGLContainer(Request &request) {
-	request._glContainer.glContainer->destroy();
-}
-
 } // End of namespace Events
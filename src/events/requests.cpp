@@ -22,19 +22,29 @@
  *  Inter-thread request events.
  */
 
+#include <SDL_timer.h>
+
 #include "src/common/error.h"
 #include "src/common/util.h"
 #include "src/common/threads.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/events/requests.h"
 #include "src/events/events.h"
 
+#include "src/graphics/glcontainer.h"
 #include "src/graphics/images/decoder.h"
 
 DECLARE_SINGLETON(Events::RequestManager)
 
 namespace Events {
 
+/** How long to wait for queued requests before checking again, in milliseconds. */
+static const uint32 kQueueWaitInterval = 10;
+
+RequestManager::RequestManager() : _queueDone(0), _queueProcessed(_queueMutex) {
+}
+
 RequestManager::~RequestManager() {
 	clearList();
 }
@@ -121,25 +131,109 @@ void RequestManager::dispatchAndForget(RequestID request) {
 }
 
 void RequestManager::sync() {
+	waitFence(_queue.getHead());
+
 	RequestID syncID = newRequest(kITCEventSync);
 
 	dispatchAndWait(syncID);
 }
 
-RequestID RequestManager::rebuild(Graphics::GLContainer &glContainer) {
-	RequestID rID = newRequest(kITCEventRebuildGLContainer);
+RequestFence RequestManager::queueRebuild(Graphics::GLContainer &glContainer) {
+	return queue(glContainer, false);
+}
+
+RequestFence RequestManager::queueDestroy(Graphics::GLContainer &glContainer) {
+	return queue(glContainer, true);
+}
+
+RequestFence RequestManager::queue(Graphics::GLContainer &glContainer, bool destroy) {
+	RequestFence fence;
+	while (!tryQueue(glContainer, destroy, fence)) {
+		// The queue is full. Wait for the main thread to make room, or make room ourselves
+		if (Common::isMainThread()) {
+			processQueue(0);
+			continue;
+		}
+
+		Common::StackLock lock(_queueMutex);
+		_queueProcessed.wait(kQueueWaitInterval);
+	}
+
+	return fence;
+}
+
+bool RequestManager::tryQueue(Graphics::GLContainer &glContainer, bool destroy, RequestFence &fence) {
+	QueuedRequest request;
+
+	request.glContainer = &glContainer;
+	request.destroy     = destroy;
+
+	size_t pos;
+	if (!_queue.tryPush(request, &pos))
+		return false;
+
+	// The fence is reached once this request was processed
+	fence = pos + 1;
+	return true;
+}
+
+bool RequestManager::reachedFence(RequestFence fence) const {
+	return (ptrdiff_t) (_queueDone.load(boost::memory_order_acquire) - fence) >= 0;
+}
+
+void RequestManager::waitFence(RequestFence fence) {
+	if (Common::isMainThread()) {
+		// In the main thread, nobody else would process the queue, so do it now
+		while (!reachedFence(fence))
+			processQueue(0);
 
-	(*rID)->_glContainer.glContainer = &glContainer;
+		return;
+	}
 
-	return rID;
+	Common::StackLock lock(_queueMutex);
+
+	while (!reachedFence(fence))
+		_queueProcessed.wait(kQueueWaitInterval);
 }
 
-RequestID RequestManager::destroy(Graphics::GLContainer &glContainer) {
-	RequestID rID = newRequest(kITCEventDestroyGLContainer);
+bool RequestManager::processQueue(uint32 budget) {
+	Common::enforceMainThread();
+
+	if (_queue.empty())
+		return true;
 
-	(*rID)->_glContainer.glContainer = &glContainer;
+	Common::ProfileZone profile("processQueuedRequests");
+
+	const uint64 end = Common::FrameProfiler::getTicks() +
+	                   (((uint64) budget) * SDL_GetPerformanceFrequency()) / 1000;
+
+	QueuedRequest request;
+	size_t pos;
+
+	size_t count = 0;
+	while (((count == 0) || (Common::FrameProfiler::getTicks() < end)) && _queue.tryPop(request, &pos)) {
+		try {
+			if (request.destroy)
+				request.glContainer->destroy();
+			else
+				request.glContainer->rebuild();
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed processing a queued GL container request");
+		}
+
+		// Only the main thread pops requests, so they're done in order
+		_queueDone.store(pos + 1, boost::memory_order_release);
+
+		count++;
+	}
+
+	// Wake up everybody waiting for a fence or for room in the queue
+	{
+		Common::StackLock lock(_queueMutex);
+		_queueProcessed.broadcast();
+	}
 
-	return rID;
+	return _queue.empty();
 }
 
 RequestID RequestManager::newRequest(ITCEvent type) {
@@ -25,21 +25,25 @@
 #ifndef EVENTS_REQUESTS_H
 #define EVENTS_REQUESTS_H
 
+#include "src/common/atomic.h"
+
 #include <list>
 
 #include <boost/bind.hpp>
 
 #include "src/common/types.h"
 #include "src/common/ptrlist.h"
+#include "src/common/mutex.h"
 #include "src/common/singleton.h"
 #include "src/common/thread.h"
+#include "src/common/boundedqueue.h"
 
 #include "src/graphics/types.h"
 
 #include "src/events/requesttypes.h"
 
 namespace Graphics {
-	class Texture;
+	class GLContainer;
 }
 
 namespace Events {
@@ -61,9 +65,17 @@ typedef RequestList::iterator RequestID;
  *
  *  @note As soon as waitReply(), forget(), dispatchAndWait() or
  *         dispatchAndForget() was called, the RequestID expires.
+ *
+ *  Building and destroying GL containers doesn't use these requests. Instead,
+ *  they are put into a lock-free queue, which the main thread works through
+ *  once per frame, for a limited amount of time. Each queued request returns
+ *  a fence, and waiting for the fence of the last request of a batch waits
+ *  for the whole batch. That way, loading a lot of textures and meshes
+ *  doesn't need a round trip between the threads for each of them.
  */
 class RequestManager : public Common::Singleton<RequestManager>, public Common::Thread {
 public:
+	RequestManager();
 	~RequestManager();
 
 	void init();
@@ -96,19 +108,56 @@ public:
 		return f.getReturnValue();
 	}
 
-	/** Request that a GL container shall be rebuilt. */
-	RequestID rebuild(Graphics::GLContainer &glContainer);
-	/** Request that a GL container shall be destroyed. */
-	RequestID destroy(Graphics::GLContainer &glContainer);
+	/** Queue the rebuilding of a GL container.
+	 *
+	 *  @note The GL container must not be deleted before its fence was reached.
+	 *
+	 *  @return The fence to wait for, until the GL container was rebuilt.
+	 */
+	RequestFence queueRebuild(Graphics::GLContainer &glContainer);
+	/** Queue the destruction of a GL container.
+	 *
+	 *  @note The GL container must not be deleted before its fence was reached.
+	 *
+	 *  @return The fence to wait for, until the GL container was destroyed.
+	 */
+	RequestFence queueDestroy(Graphics::GLContainer &glContainer);
+
+	/** Wait until all queued requests up to this fence were processed. */
+	void waitFence(RequestFence fence);
+
+	/** Process queued requests for about this many milliseconds.
+	 *
+	 *  At least one request is always processed, if there are any.
+	 *  Can only be called from the main thread.
+	 *
+	 *  @return true if all queued requests were processed.
+	 */
+	bool processQueue(uint32 budget);
 
 	// Singleton
 	static void destroy();
 
 private:
+	/** The number of requests the queue can hold. Needs to be a power of 2. */
+	static const size_t kQueueSize = 4096;
+
+	/** A GL container request in the queue. */
+	struct QueuedRequest {
+		Graphics::GLContainer *glContainer; ///< The GL container to rebuild or destroy.
+		bool destroy; ///< Destroy the GL container, instead of rebuilding it?
+	};
+
 	Common::Mutex _mutexUse; ///< The mutex locking the use of the manager.
 
 	RequestList _requests; ///< All currently active requests.
 
+	Common::BoundedQueue<QueuedRequest, kQueueSize> _queue; ///< The queued GL container requests.
+	boost::atomic<size_t> _queueDone; ///< The position up to which queued requests were processed.
+
+	Common::Mutex     _queueMutex;     ///< Protects waiting for the queue to be processed.
+	Common::Condition _queueProcessed; ///< Signals that queued requests were processed.
+
 	/** Create a new, empty request of that type. */
 	RequestID newRequest(ITCEvent type);
 
@@ -119,6 +168,14 @@ private:
 	void threadMethod();
 
 	void callInMainThread(const MainThreadCallerFunctor &caller);
+
+	/** Put a GL container request into the queue. */
+	RequestFence queue(Graphics::GLContainer &glContainer, bool destroy);
+	/** Try to put a GL container request into the queue. Returns false if the queue is full. */
+	bool tryQueue(Graphics::GLContainer &glContainer, bool destroy, RequestFence &fence);
+
+	/** Was the queue processed up to this fence? */
+	bool reachedFence(RequestFence fence) const;
 };
 
 } // End of namespace Events
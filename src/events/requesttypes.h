@@ -30,12 +30,6 @@
 
 #include "src/events/types.h"
 
-#include "src/graphics/types.h"
-
-namespace Graphics {
-	class GLContainer;
-}
-
 namespace Events {
 
 // Data structures for specific requests
@@ -44,10 +38,6 @@ struct RequestCallInMainThread {
 	const MainThreadCallerFunctor *caller;
 };
 
-struct RequestDataGLContainer {
-	Graphics::GLContainer *glContainer;
-};
-
 /** A request, carrying inter-thread communication. */
 class Request {
 public:
@@ -69,7 +59,6 @@ private:
 	/** Request data. */
 	union {
 		RequestCallInMainThread _callInMainThread;
-		RequestDataGLContainer  _glContainer;
 	};
 
 	/** Create the empty request frame. */
@@ -22,6 +22,7 @@
  *  The global timer manager.
  */
 
+#include "src/common/util.h"
 #include "src/common/error.h"
 
 #include "src/events/timerman.h"
@@ -30,7 +31,12 @@ DECLARE_SINGLETON(Events::TimerManager)
 
 namespace Events {
 
-TimerHandle::TimerHandle() : _empty(true) {
+/** How often the timer thread checks for due timers, in milliseconds. */
+static const uint32 kTimerGranularity = 10;
+/** How long the timer thread sleeps without any timers, in milliseconds. */
+static const uint32 kTimerIdleInterval = 100;
+
+TimerHandle::TimerHandle() : _timer(0) {
 }
 
 TimerHandle::~TimerHandle() {
@@ -38,15 +44,29 @@ TimerHandle::~TimerHandle() {
 }
 
 
-TimerManager::TimerManager() {
+TimerID::TimerID(TimerHandle &handle, uint32 interval, const TimerFunc &func, uint64 time) :
+	_handle(&handle), _interval(interval), _func(func), _time(time), _firing(false) {
+
+}
+
+
+TimerManager::TimerManager() : _timerAdded(_mutex) {
 }
 
 TimerManager::~TimerManager() {
-	for (std::list<TimerID>::iterator t = _timers.begin(); t != _timers.end(); ++t)
-		removeTimer(*t);
+	deinit();
 }
 
 void TimerManager::init() {
+	if (!createThread())
+		throw Common::Exception("Failed to create timer thread: %s", SDL_GetError());
+}
+
+void TimerManager::deinit() {
+	if (!destroyThread())
+		warning("TimerManager::deinit(): Timer thread had to be killed");
+
+	clearTimers();
 }
 
 void TimerManager::addTimer(uint32 interval, TimerHandle &handle, const TimerFunc &func) {
@@ -54,61 +74,106 @@ void TimerManager::addTimer(uint32 interval, TimerHandle &handle, const TimerFun
 
 	removeTimer(handle);
 
-	_timers.push_back(TimerID());
+	TimerID *timer = new TimerID(handle, interval, func, SDL_GetTicks() + interval);
+
+	timer->_id = _timers.add(timer->_time, timer);
+	handle._timer = timer;
 
-	std::list<TimerID>::iterator id = --_timers.end();
+	_timerAdded.signal();
+}
 
-	handle._iterator = id;
-	handle._empty    = false;
+void TimerManager::removeTimer(TimerHandle &handle) {
+	Common::StackLock lock(_mutex);
 
-	id->_func = func;
-	id->_id   = SDL_AddTimer(interval, &TimerManager::timerCallback, static_cast<void *>(&handle));
-	if (id->_id)
+	TimerID *timer = handle._timer;
+	if (!timer)
 		return;
 
-	handle._iterator = _timers.end();
-	handle._empty    = true;
+	handle._timer  = 0;
+	timer->_handle = 0;
 
-	_timers.erase(id);
+	// A timer currently firing is deleted by the timer thread afterwards
+	if (timer->_firing)
+		return;
 
-	throw Common::Exception("Failed to add timer");
+	_timers.remove(timer->_id);
+	delete timer;
 }
 
-void TimerManager::removeTimer(TimerHandle &handle) {
+size_t TimerManager::getPendingTimers() {
 	Common::StackLock lock(_mutex);
 
-	if (handle._empty)
-		return;
-
-	removeTimer(*handle._iterator);
+	return _timers.getPending();
+}
 
-	_timers.erase(handle._iterator);
+uint64 TimerManager::getFiredTimers() {
+	Common::StackLock lock(_mutex);
 
-	handle._iterator = _timers.end();
-	handle._empty    = true;
+	return _timers.getFired();
 }
 
-void TimerManager::removeTimer(TimerID &id) {
-	if (id._id == 0)
-		return;
+void TimerManager::clearTimers() {
+	Common::StackLock lock(_mutex);
+
+	std::list<TimerID *> timers;
+	_timers.clear(timers);
 
-	SDL_RemoveTimer(id._id);
+	for (std::list<TimerID *>::iterator t = timers.begin(); t != timers.end(); ++t) {
+		if ((*t)->_handle)
+			(*t)->_handle->_timer = 0;
+
+		delete *t;
+	}
 }
 
-uint32 TimerManager::timerCallback(uint32 interval, void *data) {
-	TimerHandle &handle = *static_cast<TimerHandle *>(data);
+void TimerManager::threadMethod() {
+	std::list<TimerID *> expired;
 
-	if (handle._empty)
-		return 0;
+	while (!_killThread) {
+		{
+			Common::StackLock lock(_mutex);
 
-	uint32 newInterval = handle._iterator->_func(interval);
-	if (newInterval == 0) {
-		handle._iterator->_id = 0;
-		TimerMan.removeTimer(handle);
-		return 0;
-	}
+			_timerAdded.wait(_timers.empty() ? kTimerIdleInterval : kTimerGranularity);
+
+			_timers.advance(SDL_GetTicks(), expired);
+
+			for (std::list<TimerID *>::iterator t = expired.begin(); t != expired.end(); ++t)
+				(*t)->_firing = true;
+		}
+
+		/* Call the functions of all timers that are due. The mutex isn't held
+		 * while doing so, since the functions might lock their own mutexes,
+		 * which might be held while removing a timer. */
 
-	return newInterval;
+		while (!expired.empty()) {
+			TimerID *timer = expired.front();
+			expired.pop_front();
+
+			_mutex.lock();
+			const bool removed = timer->_handle == 0;
+			_mutex.unlock();
+
+			const uint32 interval = removed ? 0 : timer->_func(timer->_interval);
+
+			Common::StackLock lock(_mutex);
+
+			timer->_firing = false;
+
+			if (!timer->_handle || (interval == 0)) {
+				if (timer->_handle)
+					timer->_handle->_timer = 0;
+
+				delete timer;
+				continue;
+			}
+
+			// Keep to the original schedule, unless we fell behind by more than an interval
+			timer->_interval = interval;
+			timer->_time     = MAX<uint64>(timer->_time + interval, SDL_GetTicks());
+
+			timer->_id = _timers.add(timer->_time, timer);
+		}
+	}
 }
 
 } // End of namespace Events
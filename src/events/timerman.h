@@ -34,6 +34,8 @@
 #include "src/common/types.h"
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
+#include "src/common/thread.h"
+#include "src/common/timerwheel.h"
 
 #include "src/events/types.h"
 
@@ -52,13 +54,17 @@ class TimerHandle;
 /** The global timer manager.
  *
  *  Allows registering functions to be called at specific intervals.
+ *
+ *  All timers are kept in a timing wheel, which a single timer thread
+ *  advances. The timer functions are then called from that thread.
  */
-class TimerManager : public Common::Singleton<TimerManager> {
+class TimerManager : public Common::Singleton<TimerManager>, public Common::Thread {
 public:
 	TimerManager();
 	~TimerManager();
 
 	void init();
+	void deinit();
 
 	/** Add a function to be called regularly.
 	 *
@@ -72,21 +78,38 @@ public:
 	/** Remove that timer function. */
 	void removeTimer(TimerHandle &handle);
 
+	/** Return the number of timers currently waiting to be called. */
+	size_t getPendingTimers();
+	/** Return the number of times timer functions were called so far. */
+	uint64 getFiredTimers();
+
 private:
-	Common::Mutex _mutex;
+	Common::Mutex     _mutex;
+	Common::Condition _timerAdded; ///< Wakes up the timer thread when a timer was added.
 
-	std::list<TimerID> _timers;
+	Common::TimerWheel<TimerID *> _timers;
 
-	void removeTimer(TimerID &id);
+	void clearTimers();
 
-	static uint32 timerCallback(uint32 interval, void *data);
+	void threadMethod();
 };
 
 class TimerID {
 private:
-	SDL_TimerID _id;
+	TimerID(TimerHandle &handle, uint32 interval, const TimerFunc &func, uint64 time);
+
+	TimerHandle *_handle; ///< The handle of this timer, or 0 if the timer was removed.
+
+	uint32 _interval;
 	TimerFunc _func;
 
+	uint64 _time; ///< The time the timer is due at.
+
+	bool _firing; ///< Is the timer function currently being called?
+
+	/** The timer's place in the timing wheel, when not firing. */
+	Common::TimerWheel<TimerID *>::ID _id;
+
 	friend class TimerManager;
 };
 
@@ -96,9 +119,7 @@ public:
 	~TimerHandle();
 
 private:
-	bool _empty;
-
-	std::list<TimerID>::iterator _iterator;
+	TimerID *_timer;
 
 	friend class TimerManager;
 };
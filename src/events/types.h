@@ -67,8 +67,6 @@ enum EventWindowType {
 enum ITCEvent {
 	kITCEventSync               = 0, ///< Request a sync, letting all prior requests finish.
 	kITCEventCallInMainThread      , ///< Request to call a function in the main thread.
-	kITCEventRebuildGLContainer    , ///< Request the rebuilding of a GL container.
-	kITCEventDestroyGLContainer    , ///< Request the destruction of a GL container.
 	kITCEventMAX                     ///< For range checks.
 };
 
@@ -123,6 +121,9 @@ public:
 
 typedef boost::function<void ()> MainThreadCallerFunctor;
 
+/** A fence in the queue of batched requests, marking the point up to which they were processed. */
+typedef size_t RequestFence;
+
 } // End of namespace Events
 
 #endif // EVENTS_TYPES_H
@@ -56,21 +56,28 @@ float ABCFont::getWidth(uint32 c) const {
 	return cC.spaceL + cC.width + cC.spaceR;
 }
 
-void ABCFont::draw(uint32 c) const {
-	TextureMan.set(_texture);
-
+void ABCFont::getGlyph(uint32 c, GlyphQuad &glyph) const {
 	const Char &cC = findChar(c);
 
-	glTranslatef(cC.spaceL, 0.0f, 0.0f);
+	glyph.page = 0;
 
-	glBegin(GL_QUADS);
 	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC.tX[i], cC.tY[i]);
-		glVertex2f  (cC.vX[i], cC.vY[i]);
+		glyph.tX[i] = cC.tX[i];
+		glyph.tY[i] = cC.tY[i];
+		glyph.vX[i] = cC.vX[i] + cC.spaceL;
+		glyph.vY[i] = cC.vY[i];
 	}
-	glEnd();
 
-	glTranslatef(cC.width + cC.spaceR, 0.0f, 0.0f);
+	glyph.advance = cC.spaceL + cC.width + cC.spaceR;
+}
+
+void ABCFont::bindPage(size_t page) const {
+	if (page == kNoPage) {
+		TextureMan.set();
+		return;
+	}
+
+	TextureMan.set(_texture);
 }
 
 void ABCFont::load(const Common::UString &name) {
@@ -51,7 +51,8 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, GlyphQuad &glyph) const;
+	void bindPage(size_t page) const;
 
 private:
 	/** A font character. */
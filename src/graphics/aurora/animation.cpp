@@ -22,6 +22,8 @@
  *  An animation to be applied to a model.
  */
 
+#include <cassert>
+
 #include "src/common/readstream.h"
 #include "src/common/debug.h"
 
@@ -68,29 +70,94 @@ void Animation::setTransTime(float transtime) {
 	_transtime = transtime;
 }
 
-void Animation::update(Model *model, float UNUSED(lastFrame), float nextFrame) {
+Animation::Binding::Binding() : _scale(1.0f) {
+}
+
+Animation::Binding::~Binding() {
+}
+
+void Animation::bind(Model &model, Binding &binding) const {
+	binding._scale = model.getAnimationScale(_name);
+
+	binding._targets.resize(_tracks.size());
+
+	binding._positionCursors.assign(_tracks.size(), 0);
+	binding._orientationCursors.assign(_tracks.size(), 0);
+
+	for (size_t i = 0; i < _tracks.size(); i++)
+		binding._targets[i] = model.getNode(_tracks[i].nodeName);
+}
+
+void Animation::update(Binding &binding, float UNUSED(lastFrame), float nextFrame) const {
 	// TODO: Also need to fire off associated events
 	//       for event in _events event->fire()
 
+	assert(binding._targets.size() == _tracks.size());
 
-	float scale = model->getAnimationScale(_name);
-	for (NodeList::iterator n = nodeList.begin(); n != nodeList.end(); ++n) {
-		ModelNode *animNode = (*n)->_nodedata;
-		ModelNode *target = model->getNode(animNode->getName());
+	for (size_t i = 0; i < _tracks.size(); i++) {
+		ModelNode *target = binding._targets[i];
 		if (!target)
 			continue;
 
+		const Track &track = _tracks[i];
+
 		// Update position and orientation based on time
-		if (!animNode->_positionFrames.empty())
-			interpolatePosition(animNode, target, nextFrame, scale);
-		if (!animNode->_orientationFrames.empty())
-			interpolateOrientation(animNode, target, nextFrame);
+		if (!track.positionTime.empty())
+			interpolatePosition(track, binding._positionCursors[i], *target, nextFrame, binding._scale);
+		if (!track.orientationTime.empty())
+			interpolateOrientation(track, binding._orientationCursors[i], *target, nextFrame);
+	}
+}
+
+void Animation::addTrack(const ModelNode &node) {
+	if (node._positionFrames.empty() && node._orientationFrames.empty())
+		return;
+
+	_tracks.push_back(Track());
+	Track &track = _tracks.back();
+
+	track.nodeName = node.getName();
+
+	const size_t positionCount = node._positionFrames.size();
+
+	track.positionTime.resize(positionCount);
+	track.positionX.resize(positionCount);
+	track.positionY.resize(positionCount);
+	track.positionZ.resize(positionCount);
+
+	for (size_t i = 0; i < positionCount; i++) {
+		const PositionKeyFrame &pos = node._positionFrames[i];
+
+		track.positionTime[i] = pos.time;
+		track.positionX[i]    = pos.x;
+		track.positionY[i]    = pos.y;
+		track.positionZ[i]    = pos.z;
+	}
+
+	const size_t orientationCount = node._orientationFrames.size();
+
+	track.orientationTime.resize(orientationCount);
+	track.orientationX.resize(orientationCount);
+	track.orientationY.resize(orientationCount);
+	track.orientationZ.resize(orientationCount);
+	track.orientationQ.resize(orientationCount);
+
+	for (size_t i = 0; i < orientationCount; i++) {
+		const QuaternionKeyFrame &ori = node._orientationFrames[i];
+
+		track.orientationTime[i] = ori.time;
+		track.orientationX[i]    = ori.x;
+		track.orientationY[i]    = ori.y;
+		track.orientationZ[i]    = ori.z;
+		track.orientationQ[i]    = ori.q;
 	}
 }
 
 void Animation::addAnimNode(AnimNode *node) {
 	nodeList.push_back(node);
 	nodeMap.insert(std::make_pair(node->getName(), node));
+
+	addTrack(*node->_nodedata);
 }
 
 bool Animation::hasNode(const Common::UString &node) const {
@@ -132,79 +199,88 @@ static void normQuaternion(float  xIn , float  yIn , float  zIn , float  qIn,
 	qOut = qIn / magnitude;
 }
 
-void Animation::interpolatePosition(ModelNode *animNode, ModelNode *target, float time, float scale) const {
+size_t Animation::seekKeyFrame(const std::vector<float> &times, size_t cursor, float time) {
+	/* Find the last keyframe before the time, or the first keyframe if there is none.
+	 *
+	 * Animations usually play forward, so we start looking from where we were
+	 * the last time. Only if the time went backwards, because the animation
+	 * looped or restarted, do we need to start from the beginning again. */
+
+	if ((cursor >= times.size()) || ((cursor > 0) && (times[cursor] >= time)))
+		cursor = 0;
+
+	while (((cursor + 1) < times.size()) && (times[cursor + 1] < time))
+		cursor++;
+
+	return cursor;
+}
+
+void Animation::interpolatePosition(const Track &track, size_t &cursor, ModelNode &target,
+                                    float time, float scale) {
+
 	// If only one keyframe, don't interpolate, just set the only position
-	if (animNode->_positionFrames.size() == 1) {
-		const PositionKeyFrame &pos = animNode->_positionFrames[0];
-		target->setPosition(pos.x * scale, pos.y * scale, pos.z * scale);
+	if (track.positionTime.size() == 1) {
+		target.setPosition(track.positionX[0] * scale, track.positionY[0] * scale, track.positionZ[0] * scale);
 		return;
 	}
 
-	size_t lastFrame = 0;
-	for (size_t i = 0; i < animNode->_positionFrames.size(); i++) {
-		const PositionKeyFrame &pos = animNode->_positionFrames[i];
-		if (pos.time >= time)
-			break;
+	const size_t last = cursor = seekKeyFrame(track.positionTime, cursor, time);
+	const size_t next = last + 1;
 
-		lastFrame = i;
-	}
-
-	const PositionKeyFrame &last = animNode->_positionFrames[lastFrame];
-	if (lastFrame + 1 >= animNode->_positionFrames.size() || last.time >= time) {
-		target->setPosition(last.x * scale, last.y * scale, last.z * scale);
+	if ((next >= track.positionTime.size()) || (track.positionTime[last] >= time)) {
+		target.setPosition(track.positionX[last] * scale, track.positionY[last] * scale, track.positionZ[last] * scale);
 		return;
 	}
 
-	const PositionKeyFrame &next = animNode->_positionFrames[lastFrame + 1];
+	const float f = (time - track.positionTime[last]) / (track.positionTime[next] - track.positionTime[last]);
 
-	const float f = (time - last.time) / (next.time - last.time);
-	const float x = f * next.x + (1.0f - f) * last.x;
-	const float y = f * next.y + (1.0f - f) * last.y;
-	const float z = f * next.z + (1.0f - f) * last.z;
-	target->setPosition(x * scale, y * scale, z * scale);
+	const float x = f * track.positionX[next] + (1.0f - f) * track.positionX[last];
+	const float y = f * track.positionY[next] + (1.0f - f) * track.positionY[last];
+	const float z = f * track.positionZ[next] + (1.0f - f) * track.positionZ[last];
+	target.setPosition(x * scale, y * scale, z * scale);
 }
 
-void Animation::interpolateOrientation(ModelNode *animNode, ModelNode *target, float time) const {
+void Animation::interpolateOrientation(const Track &track, size_t &cursor, ModelNode &target, float time) {
 	// If only one keyframe, don't interpolate just set the only orientation
-	if (animNode->_orientationFrames.size() == 1) {
-		const QuaternionKeyFrame &ori = animNode->_orientationFrames[0];
-		target->setOrientation(ori.x, ori.y, ori.z, Common::rad2deg(acos(ori.q) * 2.0));
+	if (track.orientationTime.size() == 1) {
+		target.setOrientation(track.orientationX[0], track.orientationY[0], track.orientationZ[0],
+		                      Common::rad2deg(acos(track.orientationQ[0]) * 2.0));
 		return;
 	}
 
-	size_t lastFrame = 0;
-	for (size_t i = 0; i < animNode->_orientationFrames.size(); i++) {
-		const QuaternionKeyFrame &ori = animNode->_orientationFrames[i];
-		if (ori.time >= time)
-			break;
-
-		lastFrame = i;
-	}
+	const size_t last = cursor = seekKeyFrame(track.orientationTime, cursor, time);
+	const size_t next = last + 1;
 
-	const QuaternionKeyFrame &last = animNode->_orientationFrames[lastFrame];
-	if (lastFrame + 1 >= animNode->_orientationFrames.size() || last.time >= time) {
-		target->setOrientation(last.x, last.y, last.z, Common::rad2deg(acos(last.q) * 2.0));
+	if ((next >= track.orientationTime.size()) || (track.orientationTime[last] >= time)) {
+		target.setOrientation(track.orientationX[last], track.orientationY[last], track.orientationZ[last],
+		                      Common::rad2deg(acos(track.orientationQ[last]) * 2.0));
 		return;
 	}
 
-	const QuaternionKeyFrame &next = animNode->_orientationFrames[lastFrame + 1];
+	const float f = (time - track.orientationTime[last]) / (track.orientationTime[next] - track.orientationTime[last]);
 
-	const float f = (time - last.time) / (next.time - last.time);
+	const float lastQ[4] = {
+		track.orientationX[last], track.orientationY[last], track.orientationZ[last], track.orientationQ[last]
+	};
+	const float nextQ[4] = {
+		track.orientationX[next], track.orientationY[next], track.orientationZ[next], track.orientationQ[next]
+	};
 
 	/* If the angle is > 90°, we need to flip the direction of one quaternion to
-	   get a smooth transition instead of wild jumps. */
-	const float angle = acos(dotQuaternion(last.x, last.y, last.z, last.q, next.x, next.y, next.z, next.q));
-	const float dir   = (angle >= (M_PI / 2)) ? -1.0f : 1.0f;
+	   get a smooth transition instead of wild jumps. Since acos() is monotonically
+	   decreasing, that's the case exactly when the dot product is <= 0. */
+	const float dot = dotQuaternion(lastQ[0], lastQ[1], lastQ[2], lastQ[3], nextQ[0], nextQ[1], nextQ[2], nextQ[3]);
+	const float dir = (dot <= 0.0f) ? -1.0f : 1.0f;
 
-	float x = f * dir * next.x + (1.0f - f) * last.x;
-	float y = f * dir * next.y + (1.0f - f) * last.y;
-	float z = f * dir * next.z + (1.0f - f) * last.z;
-	float q = f * dir * next.q + (1.0f - f) * last.q;
+	// Normalized linear interpolation, written as one straight loop the compiler can vectorize
+	float result[4];
+	for (int i = 0; i < 4; i++)
+		result[i] = f * dir * nextQ[i] + (1.0f - f) * lastQ[i];
 
 	// Normalize the result for slightly better results
-	normQuaternion(x, y, z, q, x, y, z, q);
+	normQuaternion(result[0], result[1], result[2], result[3], result[0], result[1], result[2], result[3]);
 
-	target->setOrientation(x, y, z, Common::rad2deg(acos(q) * 2.0));
+	target.setOrientation(result[0], result[1], result[2], Common::rad2deg(acos(result[3]) * 2.0));
 }
 
 } // End of namespace Aurora
@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "src/common/ustring.h"
 #include "src/common/matrix4x4.h"
@@ -50,6 +51,32 @@ class AnimNode;
 
 class Animation {
 public:
+	/** An animation bound to one specific model.
+	 *
+	 *  Holds the model nodes the animation's tracks resolve to, so that
+	 *  they don't need to be looked up by name every frame, and a cursor
+	 *  into each track's keyframes. Since animations mostly play forward,
+	 *  finding the keyframes around the current time is then amortized
+	 *  constant time.
+	 *
+	 *  A binding is only valid as long as the model's state doesn't change.
+	 */
+	class Binding {
+	public:
+		Binding();
+		~Binding();
+
+	private:
+		float _scale; ///< The animation scale of this model.
+
+		std::vector<ModelNode *> _targets; ///< The target node of each track.
+
+		std::vector<size_t> _positionCursors;    ///< Last position keyframe of each track.
+		std::vector<size_t> _orientationCursors; ///< Last orientation keyframe of each track.
+
+		friend class Animation;
+	};
+
 	Animation();
 	~Animation();
 
@@ -63,8 +90,11 @@ public:
 
 	void setTransTime(float transtime);
 
-	/** Update the model position and orientation */
-	void update(Model *model, float lastFrame, float nextFrame);
+	/** Bind this animation to a model, resolving all target nodes. */
+	void bind(Model &model, Binding &binding) const;
+
+	/** Update the position and orientation of a bound model's nodes. */
+	void update(Binding &binding, float lastFrame, float nextFrame) const;
 
 	// Nodes
 
@@ -92,8 +122,30 @@ protected:
 	float _transtime;
 
 private:
-	void interpolatePosition(ModelNode *animNode, ModelNode *target, float time, float scale) const;
-	void interpolateOrientation(ModelNode *animNode, ModelNode *target, float time) const;
+	/** The keyframes of one animated node, as a structure of arrays. */
+	struct Track {
+		Common::UString nodeName; ///< The name of the node this track animates.
+
+		std::vector<float> positionTime;
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+
+		std::vector<float> orientationTime;
+		std::vector<float> orientationX;
+		std::vector<float> orientationY;
+		std::vector<float> orientationZ;
+		std::vector<float> orientationQ;
+	};
+
+	std::vector<Track> _tracks; ///< All nodes with keyframes.
+
+	void addTrack(const ModelNode &node);
+
+	static size_t seekKeyFrame(const std::vector<float> &times, size_t cursor, float time);
+
+	static void interpolatePosition(const Track &track, size_t &cursor, ModelNode &target, float time, float scale);
+	static void interpolateOrientation(const Track &track, size_t &cursor, ModelNode &target, float time);
 };
 
 } // End of namespace Aurora
@@ -36,9 +36,6 @@
 #include "src/graphics/aurora/texture.h"
 
 #include "src/events/events.h"
-#include "src/events/requests.h"
-
-using Events::RequestID;
 
 namespace Graphics {
 
@@ -82,10 +79,13 @@ Cube::Cube(const Common::UString &texture) : _firstTime(true), _lastRotateTime(0
 	for (int i = 0; i < 6; i++)
 		_sides[i] = new CubeSide(*this, i);
 
-	RequestMan.dispatchAndForget(RequestMan.rebuild(*this));
+	queueRebuild();
 }
 
 Cube::~Cube() {
+	// The rebuild queued by the constructor might not have happened yet
+	waitQueued();
+
 	removeFromQueue(kQueueGLContainer);
 
 	for (int i = 0; i < 6; i++)
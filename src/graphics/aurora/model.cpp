@@ -24,6 +24,7 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 
 #include <SDL_timer.h>
 
@@ -48,10 +49,15 @@ namespace Graphics {
 namespace Aurora {
 
 Model::Model(ModelType type) : Renderable((RenderableType) type),
-	_type(type), _superModel(0), _currentState(0),
-	_currentAnimation(0), _nextAnimation(0), _drawBound(false),
+	_type(type), _superModel(0), _attachedTo(0), _currentState(0),
+	_currentAnimation(0), _nextAnimation(0), _bakeAttached(false), _drawBound(false),
 	_drawSkeleton(false), _drawSkeletonInvisible(false) {
 
+	// Seed differently for every model, even if they're created at the same time
+	_randomState = (uint32) reinterpret_cast<size_t>(this) ^ SDL_GetTicks();
+	if (_randomState == 0)
+		_randomState = 1;
+
 	_scale   [0] = 1.0f; _scale   [1] = 1.0f; _scale   [2] = 1.0f;
 	_position[0] = 0.0f; _position[1] = 0.0f; _position[2] = 0.0f;
 
@@ -81,6 +87,12 @@ Model::Model(ModelType type) : Renderable((RenderableType) type),
 Model::~Model() {
 	hide();
 
+	// Remove ourselves from the model we're attached to, including its baked meshes
+	if (_attachedTo)
+		_attachedTo->_model->detachModel(*_attachedTo);
+
+	destroyBakedMeshes();
+
 	for (AnimationMap::iterator a = _animationMap.begin(); a != _animationMap.end(); ++a)
 		delete a->second;
 
@@ -163,6 +175,12 @@ void Model::setEnvironmentMap(const Common::UString &environmentMap) {
 		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
 			(*n)->setEnvironmentMap(environmentMap);
 
+	// The baked meshes hold their own copy of the environment map
+	if (_bakeAttached) {
+		destroyBakedMeshes();
+		createBakedMeshes();
+	}
+
 	unlockFrameIfVisible();
 }
 
@@ -212,8 +230,17 @@ void Model::playDefaultAnimation() {
 	}
 }
 
-Animation *Model::selectDefaultAnimation() const {
-	uint8 pick = std::rand() % 100;
+uint32 Model::getRandom() {
+	// Xorshift32
+	_randomState ^= _randomState << 13;
+	_randomState ^= _randomState >> 17;
+	_randomState ^= _randomState << 5;
+
+	return _randomState;
+}
+
+Animation *Model::selectDefaultAnimation() {
+	uint8 pick = getRandom() % 100;
 	for (DefaultAnimations::const_iterator a = _defaultAnimations.begin(); a != _defaultAnimations.end(); ++a) {
 		if (pick < a->probability)
 			return a->animation;
@@ -349,6 +376,199 @@ void Model::createAbsolutePosition() {
 	_absoluteBoundBox.absolutize();
 }
 
+Model::BakedMesh::BakedMesh() : stride(0) {
+	mesh.data = &data;
+}
+
+/** Does this vertex buffer hold interleaved positions, normals and texture coordinates? */
+static bool isBakeable(const VertexBuffer &buffer) {
+	const VertexDecl &decl = buffer.getVertexDecl();
+	if ((decl.size() < 2) || (buffer.getSize() != (decl.size() * 2 + 2) * sizeof(float)))
+		return false;
+
+	const byte *data = static_cast<const byte *>(buffer.getData());
+
+	uint32 offset = 0;
+	for (size_t i = 0; i < decl.size(); i++) {
+		const GLuint index = (i < 2) ? (VPOSITION + i) : (VTCOORD + i - 2);
+		const GLint  size  = (i < 2) ? 3 : 2;
+
+		if ((decl[i].index != index) || (decl[i].size != size) || (decl[i].type != GL_FLOAT) ||
+		    (decl[i].stride != (GLsizei) buffer.getSize()) || (decl[i].pointer != data + offset))
+			return false;
+
+		offset += size * sizeof(float);
+	}
+
+	return true;
+}
+
+/** Do these two meshes draw with the same textures? */
+static bool sameTextures(const std::vector<TextureHandle> &a, const TextureHandle &envMapA,
+                         const std::vector<TextureHandle> &b, const TextureHandle &envMapB) {
+
+	if ((a.size() != b.size()) || (envMapA.getName() != envMapB.getName()))
+		return false;
+
+	for (size_t i = 0; i < a.size(); i++)
+		if (a[i].getName() != b[i].getName())
+			return false;
+
+	return true;
+}
+
+Common::Matrix4x4 Model::getNodeTransform(const ModelNode &node) {
+	Common::Matrix4x4 transform;
+	if (node._parent)
+		transform = getNodeTransform(*node._parent);
+
+	transform.translate(node._position[0], node._position[1], node._position[2]);
+	transform.rotate(node._orientation[3], node._orientation[0], node._orientation[1], node._orientation[2]);
+
+	transform.rotate(node._rotation[0], 1.0f, 0.0f, 0.0f);
+	transform.rotate(node._rotation[1], 0.0f, 1.0f, 0.0f);
+	transform.rotate(node._rotation[2], 0.0f, 0.0f, 1.0f);
+
+	transform.scale(node._scale[0], node._scale[1], node._scale[2]);
+
+	return transform;
+}
+
+bool Model::bakeMesh(const ModelNode &node, const Common::Matrix4x4 &offset, const ModelNode::Mesh &mesh) {
+	/* Only plain opaque meshes can be merged. Transparent meshes need to be
+	 * sorted, and dangly meshes move on their own. */
+
+	if (mesh.isTransparent || mesh.dangly || mesh.data->textures.empty())
+		return false;
+
+	const VertexBuffer &vertexBuffer = mesh.data->vertexBuffer;
+	const IndexBuffer  &indexBuffer  = mesh.data->indexBuffer;
+
+	if (!isBakeable(vertexBuffer))
+		return false;
+	if ((indexBuffer.getType() != GL_UNSIGNED_SHORT) && (indexBuffer.getType() != GL_UNSIGNED_INT))
+		return false;
+
+	BakedMesh *baked = 0;
+	for (BakedMeshes::iterator b = _bakedMeshes.begin(); b != _bakedMeshes.end(); ++b) {
+		if (((*b)->data.envMapMode == mesh.data->envMapMode) &&
+		    sameTextures((*b)->data.textures, (*b)->data.envMap, mesh.data->textures, mesh.data->envMap)) {
+
+			baked = *b;
+			break;
+		}
+	}
+
+	if (!baked) {
+		_bakedMeshes.push_back(new BakedMesh);
+		baked = _bakedMeshes.back();
+
+		baked->data.textures   = mesh.data->textures;
+		baked->data.envMap     = mesh.data->envMap;
+		baked->data.envMapMode = mesh.data->envMapMode;
+
+		baked->stride = vertexBuffer.getSize() / sizeof(float);
+	}
+
+	BakedPart part;
+
+	part.node        = &node;
+	part.offset      = offset;
+	part.firstVertex = baked->vertices.size() / baked->stride;
+	part.vertexCount = vertexBuffer.getCount();
+
+	const float *vertices = static_cast<const float *>(vertexBuffer.getData());
+	baked->vertices.insert(baked->vertices.end(), vertices, vertices + part.vertexCount * baked->stride);
+
+	if (indexBuffer.getType() == GL_UNSIGNED_SHORT) {
+		const uint16 *indices = static_cast<const uint16 *>(indexBuffer.getData());
+		for (uint32 i = 0; i < indexBuffer.getCount(); i++)
+			baked->indices.push_back(part.firstVertex + indices[i]);
+	} else {
+		const uint32 *indices = static_cast<const uint32 *>(indexBuffer.getData());
+		for (uint32 i = 0; i < indexBuffer.getCount(); i++)
+			baked->indices.push_back(part.firstVertex + indices[i]);
+	}
+
+	baked->parts.push_back(part);
+	return true;
+}
+
+void Model::createBakedMeshes() {
+	if (!_currentState)
+		return;
+
+	for (NodeList::iterator n = _currentState->nodeList.begin(); n != _currentState->nodeList.end(); ++n) {
+		Model *attached = (*n)->_attachedModel;
+
+		// Models in a named state borrow meshes from their default state while rendering
+		if (!attached || !attached->_currentState || !attached->getState().empty())
+			continue;
+
+		Common::Matrix4x4 modelTransform;
+
+		modelTransform.translate(attached->_position[0], attached->_position[1], attached->_position[2]);
+		modelTransform.rotate(attached->_orientation[3], attached->_orientation[0],
+		                      attached->_orientation[1], attached->_orientation[2]);
+		modelTransform.scale(attached->_scale[0], attached->_scale[1], attached->_scale[2]);
+
+		bool complete = true;
+
+		NodeList &attachedNodes = attached->_currentState->nodeList;
+		for (NodeList::iterator a = attachedNodes.begin(); a != attachedNodes.end(); ++a) {
+			// Models attached to the attached model still need to be drawn on their own
+			if ((*a)->_attachedModel)
+				complete = false;
+
+			if (!(*a)->_render || !ModelNode::renderableMesh((*a)->_mesh))
+				continue;
+
+			if (!bakeMesh(**n, modelTransform * getNodeTransform(**a), *(*a)->_mesh)) {
+				complete = false;
+				continue;
+			}
+
+			(*a)->_render = false;
+			_bakedNodes.push_back(*a);
+		}
+
+		(*n)->_attachedBaked = complete;
+	}
+
+	// Create the merged geometry, initially untransformed
+
+	for (BakedMeshes::iterator b = _bakedMeshes.begin(); b != _bakedMeshes.end(); ++b) {
+		BakedMesh &baked = **b;
+
+		VertexDecl vertexDecl;
+
+		vertexDecl.push_back(VertexAttrib(VPOSITION, 3, GL_FLOAT));
+		vertexDecl.push_back(VertexAttrib(VNORMAL  , 3, GL_FLOAT));
+		for (uint32 t = 0; t < (baked.stride - 6) / 2; t++)
+			vertexDecl.push_back(VertexAttrib(VTCOORD + t, 2, GL_FLOAT));
+
+		baked.data.vertexBuffer.setVertexDeclInterleave(baked.vertices.size() / baked.stride, vertexDecl);
+		std::memcpy(baked.data.vertexBuffer.getData(), &baked.vertices[0], baked.vertices.size() * sizeof(float));
+
+		baked.data.indexBuffer.setSize(baked.indices.size(), sizeof(uint32), GL_UNSIGNED_INT);
+		std::memcpy(baked.data.indexBuffer.getData(), &baked.indices[0], baked.indices.size() * sizeof(uint32));
+
+		std::vector<uint32>().swap(baked.indices);
+	}
+}
+
+void Model::destroyBakedMeshes() {
+	for (NodeList::iterator n = _bakedNodes.begin(); n != _bakedNodes.end(); ++n)
+		(*n)->_render = true;
+
+	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s)
+		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
+			(*n)->_attachedBaked = false;
+
+	_bakedNodes.clear();
+	_bakedMeshes.clear();
+}
+
 const std::list<Common::UString> &Model::getStates() const {
 	return _stateNames;
 }
@@ -381,6 +601,15 @@ void Model::setState(const Common::UString &name) {
 
 	_currentState = state;
 
+	// The animation bindings point to nodes of the old state
+	_animationBindings.clear();
+
+	// As do the baked meshes
+	if (_bakeAttached) {
+		destroyBakedMeshes();
+		createBakedMeshes();
+	}
+
 	createBound();
 
 	if (visible) {
@@ -485,11 +714,66 @@ const std::list<ModelNode *> &Model::getNodes() {
 void Model::attachModel(const Common::UString &nodeName, Model *model) {
 	ModelNode *node = getNode(nodeName);
 	if (node) {
+		lockFrameIfVisible();
+
+		if (_bakeAttached)
+			destroyBakedMeshes();
+
+		if (node->_attachedModel)
+			node->_attachedModel->_attachedTo = 0;
+
 		node->_attachedModel = model;
+		if (model)
+			model->_attachedTo = node;
+
+		if (_bakeAttached)
+			createBakedMeshes();
+
 		createBound();
+
+		unlockFrameIfVisible();
 	}
 }
 
+void Model::detachModel(ModelNode &node) {
+	lockFrameIfVisible();
+
+	if (_bakeAttached)
+		destroyBakedMeshes();
+
+	if (node._attachedModel)
+		node._attachedModel->_attachedTo = 0;
+
+	node._attachedModel = 0;
+
+	if (_bakeAttached)
+		createBakedMeshes();
+
+	createBound();
+
+	unlockFrameIfVisible();
+}
+
+void Model::bakeAttachedModels() {
+	lockFrameIfVisible();
+
+	destroyBakedMeshes();
+
+	_bakeAttached = true;
+	createBakedMeshes();
+
+	unlockFrameIfVisible();
+}
+
+void Model::unbakeAttachedModels() {
+	lockFrameIfVisible();
+
+	_bakeAttached = false;
+	destroyBakedMeshes();
+
+	unlockFrameIfVisible();
+}
+
 Animation *Model::getAnimation(const Common::UString &anim) {
 
 	AnimationMap::iterator n = _animationMap.find(anim);
@@ -503,6 +787,17 @@ Animation *Model::getAnimation(const Common::UString &anim) {
 	return n->second;
 }
 
+Animation::Binding &Model::getAnimationBinding(const Animation &anim) {
+	AnimationBindings::iterator b = _animationBindings.find(&anim);
+	if (b != _animationBindings.end())
+		return b->second;
+
+	Animation::Binding &binding = _animationBindings[&anim];
+	anim.bind(*this, binding);
+
+	return binding;
+}
+
 bool Model::hasAnimation(const Common::UString &anim) const {
 	return _animationMap.find(anim) != _animationMap.end();
 }
@@ -572,7 +867,7 @@ void Model::manageAnimations(float dt) {
 
 	// The loop of the animation ended: make sure to play the last frame
 	if ((lastFrame < _animationLoopLength) && (nextFrame >= _animationLoopLength)) {
-		_currentAnimation->update(this, lastFrame, _animationLoopLength);
+		_currentAnimation->update(getAnimationBinding(*_currentAnimation), lastFrame, _animationLoopLength);
 
 		_animationTime    += dt;
 		_animationLoopTime = _animationLoopLength;
@@ -586,7 +881,7 @@ void Model::manageAnimations(float dt) {
 		_nextAnimation = 0;
 
 		if (_currentAnimation)
-			_currentAnimation->update(this, 0.0f, 0.0f);
+			_currentAnimation->update(getAnimationBinding(*_currentAnimation), 0.0f, 0.0f);
 
 		createBound();
 		return;
@@ -594,7 +889,7 @@ void Model::manageAnimations(float dt) {
 
 	// Start the next loop of the animation
 	if (lastFrame >= _animationLoopLength) {
-		_currentAnimation->update(this, 0.0f, 0.0f);
+		_currentAnimation->update(getAnimationBinding(*_currentAnimation), 0.0f, 0.0f);
 
 		lastFrame = 0.0f;
 		nextFrame = _animationSpeed * dt;
@@ -603,7 +898,7 @@ void Model::manageAnimations(float dt) {
 	}
 
 	// Update the animation
-	_currentAnimation->update(this, lastFrame, nextFrame);
+	_currentAnimation->update(getAnimationBinding(*_currentAnimation), lastFrame, nextFrame);
 
 	_animationTime    += dt;
 	_animationLoopTime = nextFrame;
@@ -639,6 +934,10 @@ void Model::render(RenderPass pass) {
 		glPopMatrix();
 	}
 
+	// Draw the baked attached models. They are always opaque
+	if (pass == kRenderPassOpaque)
+		doDrawBaked();
+
 	// Reset the first texture units
 	TextureMan.reset();
 
@@ -729,6 +1028,50 @@ void Model::doDrawSkeleton() {
 	glPointSize(1.0f);
 }
 
+void Model::doDrawBaked() {
+	/* Move the vertices of every merged mesh along with the node its model
+	 * is attached to. The node transformations only have to be calculated
+	 * once per node, even if the node's model spans several baked meshes. */
+
+	typedef std::map<const ModelNode *, Common::Matrix4x4> NodeTransforms;
+	NodeTransforms nodeTransforms;
+
+	for (BakedMeshes::iterator b = _bakedMeshes.begin(); b != _bakedMeshes.end(); ++b) {
+		BakedMesh &baked = **b;
+
+		float *data = static_cast<float *>(baked.data.vertexBuffer.getData());
+
+		for (std::vector<BakedPart>::const_iterator p = baked.parts.begin(); p != baked.parts.end(); ++p) {
+			NodeTransforms::iterator t = nodeTransforms.find(p->node);
+			if (t == nodeTransforms.end())
+				t = nodeTransforms.insert(std::make_pair(p->node, getNodeTransform(*p->node))).first;
+
+			const Common::Matrix4x4 transform = t->second * p->offset;
+
+			const float *src = &baked.vertices[p->firstVertex * baked.stride];
+			      float *dst = data + p->firstVertex * baked.stride;
+
+			for (uint32 v = 0; v < p->vertexCount; v++, src += baked.stride, dst += baked.stride) {
+				const Common::Vector3 position = transform * Common::Vector3(src[0], src[1], src[2]);
+				Common::Vector3 normal = transform.vectorRotate(Common::Vector3(src[3], src[4], src[5]));
+
+				const float length = normal.length();
+				if (length > 0.0f)
+					normal *= 1.0f / length;
+
+				dst[0] = position._x;
+				dst[1] = position._y;
+				dst[2] = position._z;
+				dst[3] = normal._x;
+				dst[4] = normal._y;
+				dst[5] = normal._z;
+			}
+		}
+
+		ModelNode::renderGeometry(baked.mesh);
+	}
+}
+
 void Model::doRebuild() {
 	// TODO: remove this and all references to it.
 }
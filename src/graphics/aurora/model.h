@@ -30,6 +30,7 @@
 #include <map>
 
 #include "src/common/ustring.h"
+#include "src/common/ptrvector.h"
 #include "src/common/matrix4x4.h"
 #include "src/common/boundingbox.h"
 
@@ -38,6 +39,7 @@
 #include "src/graphics/renderable.h"
 
 #include "src/graphics/aurora/modelnode.h"
+#include "src/graphics/aurora/animation.h"
 #include "src/graphics/aurora/types.h"
 
 #include "src/graphics/shader/shaderrenderable.h"
@@ -50,8 +52,6 @@ namespace Graphics {
 
 namespace Aurora {
 
-class Animation;
-
 class Model : public GLContainer, public Renderable {
 public:
 	Model(ModelType type = kModelTypeObject);
@@ -141,6 +141,19 @@ public:
 	/** Add another model as a child to the named node. */
 	void attachModel(const Common::UString &nodeName, Model *model);
 
+	/** Merge the opaque meshes of all attached models into as few meshes as possible.
+	 *
+	 *  The meshes are grouped by their textures, and each group is drawn
+	 *  with a single call. The merged vertices are transformed on the CPU
+	 *  by the nodes their models are attached to, so animations still move
+	 *  them. This costs CPU time every frame, which only pays off when the
+	 *  draw calls are the bottleneck. The merging persists across state
+	 *  changes and new attachments, until unbakeAttachedModels() is called.
+	 */
+	void bakeAttachedModels();
+	/** Draw the attached models on their own again. */
+	void unbakeAttachedModels();
+
 	// Animation
 
 	/** Does this model have this named animation? */
@@ -182,6 +195,7 @@ protected:
 	typedef std::list<ModelNode *> NodeList;
 	typedef std::map<Common::UString, ModelNode *, Common::UString::iless> NodeMap;
 	typedef std::map<Common::UString, Animation *, Common::UString::iless> AnimationMap;
+	typedef std::map<const Animation *, Animation::Binding> AnimationBindings;
 
 	/** A model state. */
 	struct State {
@@ -205,6 +219,31 @@ protected:
 
 	typedef std::list<DefaultAnimation> DefaultAnimations;
 
+	/** A mesh of an attached model, merged into a baked mesh. */
+	struct BakedPart {
+		const ModelNode *node;    ///< The node in this model the mesh's model is attached to.
+		Common::Matrix4x4 offset; ///< The static transformation from that node into the mesh.
+
+		uint32 firstVertex; ///< Index of the mesh's first vertex within the baked mesh.
+		uint32 vertexCount; ///< Number of vertices in the mesh.
+	};
+
+	/** The meshes of attached models that share the same textures, merged into one. */
+	struct BakedMesh {
+		ModelNode::MeshData data; ///< The merged geometry, transformed into this model.
+		ModelNode::Mesh     mesh; ///< The mesh drawing the merged geometry.
+
+		uint32 stride;               ///< Size of one vertex, in floats.
+		std::vector<float> vertices; ///< The untransformed vertices of all meshes.
+		std::vector<uint32> indices; ///< The indices of all meshes, while baking.
+
+		std::vector<BakedPart> parts; ///< The merged meshes.
+
+		BakedMesh();
+	};
+
+	typedef Common::PtrVector<BakedMesh> BakedMeshes;
+
 
 	ModelType _type; ///< The model's type.
 
@@ -214,6 +253,7 @@ protected:
 
 	Common::UString _superModelName; ///< Name of the super model.
 	Model *_superModel; ///< The actual super model.
+	ModelNode *_attachedTo; ///< The node of another model this model is attached to.
 
 	StateList _stateList;   ///< All states within this model.
 	StateMap  _stateMap;    ///< All states within this model, index by name.
@@ -226,11 +266,20 @@ protected:
 	Animation *_currentAnimation; ///< The currently playing animations.
 	Animation *_nextAnimation;    ///< The animation that's scheduled next.
 
+	/** The animations played on this model so far, bound to the current state's nodes. */
+	AnimationBindings _animationBindings;
+
 	float _animationScale; ///< The scale of the animation.
 
 	/** All default animations, sorted from least to most probable. */
 	DefaultAnimations _defaultAnimations;
 
+	/** State of the model's own random number generator.
+	 *
+	 *  Models are advanced in parallel, so they can't share the C library's generator.
+	 */
+	uint32 _randomState;
+
 	float _scale      [3]; ///< Model's scale.
 	float _orientation[4]; ///< Model's orientation.
 	float _position   [3]; ///< Model's position.
@@ -244,16 +293,24 @@ protected:
 	/** The model's box after translate/rotate. */
 	Common::BoundingBox _absoluteBoundBox;
 
+	bool _bakeAttached; ///< Should the attached models be baked?
+
+	BakedMeshes _bakedMeshes; ///< The baked meshes of all attached models.
+	NodeList    _bakedNodes;  ///< The nodes of attached models that are now drawn baked.
+
 
 	// Rendering
 
 	void doDrawBound();
 	void doDrawSkeleton();
+	void doDrawBaked();
 
 	// Animation
 
 	/** Get the animation from its name. */
 	Animation *getAnimation(const Common::UString &anim);
+	/** Get an animation bound to this model, binding it if necessary. */
+	Animation::Binding &getAnimationBinding(const Animation &anim);
 
 
 	/** Finalize the loading procedure. */
@@ -287,9 +344,25 @@ private:
 
 	void createAbsolutePosition();
 
+	/** Remove the model attached to this node of ours. */
+	void detachModel(ModelNode &node);
+
+	/** Merge the attached models of the current state into baked meshes. */
+	void createBakedMeshes();
+	/** Remove all baked meshes, drawing the attached models on their own again. */
+	void destroyBakedMeshes();
+	/** Add a mesh of an attached model to a fitting baked mesh. */
+	bool bakeMesh(const ModelNode &node, const Common::Matrix4x4 &offset, const ModelNode::Mesh &mesh);
+
+	/** Return the transformation of a node within its model, as applied by ModelNode::render(). */
+	static Common::Matrix4x4 getNodeTransform(const ModelNode &node);
+
 	void manageAnimations(float dt);
 
-	Animation *selectDefaultAnimation() const;
+	Animation *selectDefaultAnimation();
+
+	/** Return the next number of the model's random number generator. */
+	uint32 getRandom();
 
 	void setCurrentAnimation(Animation *anim);
 
@@ -61,7 +61,7 @@ ModelNode::Mesh::Mesh() : shininess(1.0f), alpha(1.0f), tilefade(0), render(fals
 
 
 ModelNode::ModelNode(Model &model) :
-	_model(&model), _parent(0), _attachedModel(0), _level(0), _render(false), _mesh(0) {
+	_model(&model), _parent(0), _attachedModel(0), _attachedBaked(false), _level(0), _render(false), _mesh(0) {
 
 	_position[0] = 0.0f; _position[1] = 0.0f; _position[2] = 0.0f;
 	_rotation[0] = 0.0f; _rotation[1] = 0.0f; _rotation[2] = 0.0f;
@@ -87,6 +87,10 @@ ModelNode::~ModelNode() {
 	delete _mesh;
 	_mesh = 0;
 
+	// We're going away together with our model, so there's nothing to detach from
+	if (_attachedModel)
+		_attachedModel->_attachedTo = 0;
+
 	delete _attachedModel;
 	_attachedModel = 0;
 }
@@ -579,7 +583,7 @@ void ModelNode::render(RenderPass pass) {
 	if (shouldRender)
 		renderGeometry(*mesh);
 
-	if (_attachedModel) {
+	if (_attachedModel && !_attachedBaked) {
 		glPushMatrix();
 		_attachedModel->render(pass);
 		glPopMatrix();
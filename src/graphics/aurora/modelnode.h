@@ -178,6 +178,7 @@ protected:
 	std::list<ModelNode *> _children; ///< The node's children.
 
 	Model *_attachedModel; ///< The model that is attached to this node.
+	bool _attachedBaked;   ///< Is the attached model completely drawn by our model's baked meshes?
 
 	uint32 _level;
 
@@ -373,38 +373,30 @@ float NFTRFont::getHeight() const {
 	return _height;
 }
 
-void NFTRFont::drawMissing() const {
-	TextureMan.set();
+void NFTRFont::getGlyph(uint32 c, GlyphQuad &glyph) const {
+	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	if (cC == _chars.end()) {
+		getMissingGlyph(glyph, _missingWidth - 1.0f, _missingWidth);
+		return;
+	}
 
-	const float width = _missingWidth - 1.0f;
+	glyph.page = 0;
 
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
+	std::memcpy(glyph.tX, cC->second.tX, sizeof(glyph.tX));
+	std::memcpy(glyph.tY, cC->second.tY, sizeof(glyph.tY));
+	std::memcpy(glyph.vX, cC->second.vX, sizeof(glyph.vX));
+	std::memcpy(glyph.vY, cC->second.vY, sizeof(glyph.vY));
 
-	glTranslatef(width + 1.0f, 0.0f, 0.0f);
+	glyph.advance = cC->second.width;
 }
 
-void NFTRFont::draw(uint32 c) const {
-	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
-	if (cC == _chars.end()) {
-		drawMissing();
+void NFTRFont::bindPage(size_t page) const {
+	if (page == kNoPage) {
+		TextureMan.set();
 		return;
 	}
 
 	TextureMan.set(_texture);
-
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
-	}
-	glEnd();
-
-	glTranslatef(cC->second.width, 0.0f, 0.0f);
 }
 
 void NFTRFont::drawGlyphs(const std::vector<Glyph> &glyphs) {
@@ -51,7 +51,8 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, GlyphQuad &glyph) const;
+	void bindPage(size_t page) const;
 
 private:
 	struct Header {
@@ -115,8 +116,6 @@ private:
 	void drawGlyphs(const std::vector<Glyph> &glyphs);
 	void drawGlyph(const Glyph &glyph, Surface &surface, uint32 x, uint32 y);
 
-	void drawMissing() const;
-
 	static uint32 convertToUTF32(uint16 codePoint, uint8 encoding);
 };
 
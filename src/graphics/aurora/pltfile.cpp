@@ -59,6 +59,7 @@
 #include "src/graphics/images/surface.h"
 
 #include "src/graphics/aurora/pltfile.h"
+#include "src/graphics/aurora/textureman.h"
 
 static const uint32 kPLTID     = MKTAG('P', 'L', 'T', ' ');
 static const uint32 kVersion1  = MKTAG('V', '1', ' ', ' ');
@@ -99,6 +100,15 @@ void PLTFile::rebuild() {
 	refresh();
 }
 
+Common::UString PLTFile::getColorKey() const {
+	Common::UString key = _name + "#";
+
+	for (size_t i = 0; i < kLayerMAX; i++)
+		key += Common::UString::format("%02X", _colors[i]);
+
+	return key;
+}
+
 void PLTFile::load(Common::SeekableReadStream &plt) {
 	// --- PLT header ---
 	AuroraFile::readHeader(plt);
@@ -124,14 +134,14 @@ void PLTFile::load(Common::SeekableReadStream &plt) {
 
 	size_t size = width * height;
 
-	_dataImage.reset(new uint8[size]);
-	_dataLayers.reset(new uint8[size]);
+	_dataIndices.reset(new uint16[size]);
 
-	uint8 *image = _dataImage.get();
-	uint8 *layer = _dataLayers.get();
+	uint16 *index = _dataIndices.get();
 	while (size-- > 0) {
-		*image++ = plt.readByte();
-		*layer++ = MIN<uint8>(plt.readByte(), kLayerMAX - 1);
+		const uint8 intensity = plt.readByte();
+		const uint8 layer     = MIN<uint8>(plt.readByte(), kLayerMAX - 1);
+
+		*index++ = layer * 256 + intensity;
 	}
 
 	// --- Create the actual texture surface ---
@@ -148,18 +158,26 @@ void PLTFile::build() {
 	/* For all layers, copy one whole row of pixels into the row buffer.
 	 * The row picked for each layer corresponds to the color index we want.
 	 * We don't care about the other rows, as they belong to other color indices. */
-	byte rows[4 * 256 * kLayerMAX];
+	uint32 rows[256 * kLayerMAX];
 	getColorRows(rows, _colors);
 
 	const size_t pixels = _width * _height;
-	const uint8 *image  = _dataImage.get();
-	const uint8 *layer  = _dataLayers.get();
-	      byte  *dst    = _surface->getData();
-
-	/* Now iterate over all pixels, each time copying the correct BGRA values
-	 * for the pixel's intensity into the final image. */
-	for (size_t i = 0; i < pixels; i++, image++, layer++, dst += 4)
-		memcpy(dst, rows + (*layer * 4 * 256) + (*image * 4), 4);
+	const uint16 *index = _dataIndices.get();
+	      uint32 *dst   = reinterpret_cast<uint32 *>(_surface->getData());
+
+	/* Now gather the BGRA values for each pixel's layer and intensity from
+	 * the row buffer into the final image, four pixels at a time. The BGRA
+	 * values are copied as whole 32-bit words, so byte order doesn't matter. */
+	size_t i = 0;
+	for (; (i + 4) <= pixels; i += 4) {
+		dst[i    ] = rows[index[i    ]];
+		dst[i + 1] = rows[index[i + 1]];
+		dst[i + 2] = rows[index[i + 2]];
+		dst[i + 3] = rows[index[i + 3]];
+	}
+
+	for (; i < pixels; i++)
+		dst[i] = rows[index[i]];
 }
 
 /** The palette image resource names for all layers. */
@@ -176,20 +194,22 @@ static const char * const kPalettes[PLTFile::kLayerMAX] = {
 	"pal_tattoo01"
 };
 
-/** Load a specific layer palette image and perform some sanity checks. */
-ImageDecoder *PLTFile::getLayerPalette(uint32 layer, uint8 row) {
+/** Get a specific layer palette image and perform some sanity checks.
+ *
+ *  The palette images are only loaded once, and then shared by all PLTs.
+ */
+const ImageDecoder &PLTFile::getLayerPalette(uint32 layer, uint8 row) {
 	assert(layer < kLayerMAX);
 
-	// TODO: We may want to cache these somehow...
-	Common::ScopedPtr<ImageDecoder> palette(loadImage(kPalettes[layer]));
+	const ImageDecoder &palette = TextureMan.getPalette(kPalettes[layer]);
 
-	if (palette->getFormat() != kPixelFormatBGRA)
-		throw Common::Exception("Invalid format (%d)", palette->getFormat());
+	if (palette.getFormat() != kPixelFormatBGRA)
+		throw Common::Exception("Invalid format (%d)", palette.getFormat());
 
-	if (palette->getMipMapCount() < 1)
+	if (palette.getMipMapCount() < 1)
 		throw Common::Exception("No mip maps");
 
-	const ImageDecoder::MipMap &mipMap = palette->getMipMap(0);
+	const ImageDecoder::MipMap &mipMap = palette.getMipMap(0);
 
 	if (mipMap.width != 256)
 		throw Common::Exception("Invalid width (%d)", mipMap.width);
@@ -197,27 +217,28 @@ ImageDecoder *PLTFile::getLayerPalette(uint32 layer, uint8 row) {
 	if (row >= mipMap.height)
 		throw Common::Exception("Invalid height (%d >= %d)", row, mipMap.height);
 
-	return palette.release();
+	return palette;
 }
 
-void PLTFile::getColorRows(byte rows[4 * 256 * kLayerMAX], const uint8 colors[kLayerMAX]) {
-	for (size_t i = 0; i < kLayerMAX; i++, rows += 4 * 256) {
+void PLTFile::getColorRows(uint32 rows[256 * kLayerMAX], const uint8 colors[kLayerMAX]) {
+	for (size_t i = 0; i < kLayerMAX; i++, rows += 256) {
 		try {
-			Common::ScopedPtr<ImageDecoder> palette(getLayerPalette(i, colors[i]));
+			const ImageDecoder &palette = getLayerPalette(i, colors[i]);
 
 			// The images have their origin at the bottom left, so we flip the color row
-			const uint8 row = palette->getMipMap(0).height - 1 - colors[i];
+			const uint8 row = palette.getMipMap(0).height - 1 - colors[i];
 
 			// Copy the whole row into the buffer
-			memcpy(rows, palette->getMipMap(0).data.get() + (row * 4 * 256), 4 * 256);
+			memcpy(rows, palette.getMipMap(0).data.get() + (row * 4 * 256), 4 * 256);
 
 		} catch (...) {
 			// On error set to pink (while honoring intensity), for high debug visibility
+			byte *pink = reinterpret_cast<byte *>(rows);
 			for (size_t p = 0; p < 256; p++) {
-				rows[p * 4 + 0] = p;
-				rows[p * 4 + 1] = 0x00;
-				rows[p * 4 + 2] = p;
-				rows[p * 4 + 3] = 0xFF;
+				pink[p * 4 + 0] = p;
+				pink[p * 4 + 1] = 0x00;
+				pink[p * 4 + 2] = p;
+				pink[p * 4 + 3] = 0xFF;
 			}
 
 			Common::exceptionDispatcherWarning("Failed to load palette \"%s\"", kPalettes[i]);
@@ -60,6 +60,9 @@ public:
 	/** Rebuild the combined texture image. */
 	void rebuild();
 
+	/** Return a key identifying this PLT's image together with its current layer colors. */
+	Common::UString getColorKey() const;
+
 	bool isDynamic() const;
 	bool reload();
 
@@ -69,8 +72,8 @@ private:
 
 	Surface *_surface;
 
-	Common::ScopedArray<uint8> _dataImage;
-	Common::ScopedArray<uint8> _dataLayers;
+	/** For each pixel, its layer and intensity, as an index into the layer color rows. */
+	Common::ScopedArray<uint16> _dataIndices;
 
 	uint8 _colors[kLayerMAX];
 
@@ -80,8 +83,8 @@ private:
 	void load(Common::SeekableReadStream &plt);
 	void build();
 
-	static ImageDecoder *getLayerPalette(uint32 layer, uint8 row);
-	static void getColorRows(byte rows[4 * 256 * kLayerMAX], const uint8 colors[kLayerMAX]);
+	static const ImageDecoder &getLayerPalette(uint32 layer, uint8 row);
+	static void getColorRows(uint32 rows[256 * kLayerMAX], const uint8 colors[kLayerMAX]);
 
 	friend class Texture;
 };
@@ -0,0 +1,106 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A text object displaying the frame profiler's zone statistics.
+ */
+
+#include <vector>
+
+#include "src/common/system.h"
+#include "src/common/ustring.h"
+#include "src/common/frameprofiler.h"
+
+#include "src/graphics/graphics.h"
+#include "src/graphics/windowman.h"
+
+#include "src/graphics/aurora/profiledisplay.h"
+
+#include "src/events/events.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** Milliseconds between updates of the displayed statistics. */
+static const uint32 kUpdateInterval = 500;
+
+ProfileDisplay::ProfileDisplay(const FontHandle &font) : Text(font, ""), _lastUpdate(0) {
+	setTag("ProfileDisplay");
+
+	update();
+}
+
+ProfileDisplay::~ProfileDisplay() {
+	hide();
+}
+
+void ProfileDisplay::render(RenderPass pass) {
+	// Text objects should always be transparent
+	if (pass == kRenderPassOpaque)
+		return;
+
+	const uint32 now = EventMan.getTimestamp();
+	if ((now - _lastUpdate) >= kUpdateInterval) {
+		_lastUpdate = now;
+
+		update();
+	}
+
+	Text::render(pass);
+}
+
+void ProfileDisplay::update() {
+	std::vector<Common::UString> lines;
+
+	if (FrameProf.isEnabled())
+		FrameProf.getReport(lines);
+	else
+		lines.push_back("The frame profiler is disabled");
+
+	Common::UString text;
+	for (std::vector<Common::UString>::const_iterator l = lines.begin(); l != lines.end(); ++l) {
+		if (!text.empty())
+			text += '\n';
+
+		text += *l;
+	}
+
+	set(text);
+	updatePosition();
+}
+
+void ProfileDisplay::updatePosition() {
+	// Top right corner, so that it doesn't collide with the FPS display
+	const float posX =  (WindowMan.getWindowWidth()  / 2.0f) - getWidth();
+	const float posY =  (WindowMan.getWindowHeight() / 2.0f) - getHeight();
+
+	setPosition(posX, posY);
+}
+
+void ProfileDisplay::notifyResized(int UNUSED(oldWidth), int UNUSED(oldHeight),
+                                   int UNUSED(newWidth), int UNUSED(newHeight)) {
+
+	updatePosition();
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
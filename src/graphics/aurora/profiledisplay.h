@@ -0,0 +1,58 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A text object displaying the frame profiler's zone statistics.
+ */
+
+#ifndef GRAPHICS_AURORA_PROFILEDISPLAY_H
+#define GRAPHICS_AURORA_PROFILEDISPLAY_H
+
+#include "src/events/notifyable.h"
+
+#include "src/graphics/aurora/text.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** An autonomous display of the frame profiler's zone statistics. */
+class ProfileDisplay : public Text, public Events::Notifyable {
+public:
+	ProfileDisplay(const FontHandle &font);
+	~ProfileDisplay();
+
+	// Renderable
+	void render(RenderPass pass);
+
+private:
+	uint32 _lastUpdate;
+
+	void update();
+	void updatePosition();
+
+	void notifyResized(int oldWidth, int oldHeight, int newWidth, int newHeight);
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_PROFILEDISPLAY_H
@@ -40,10 +40,12 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/text.h \
     src/graphics/aurora/highlightabletext.h \
     src/graphics/aurora/fps.h \
+    src/graphics/aurora/profiledisplay.h \
     src/graphics/aurora/cube.h \
     src/graphics/aurora/guiquad.h \
     src/graphics/aurora/highlightableguiquad.h \
     src/graphics/aurora/geometryobject.h \
+    src/graphics/aurora/terrain.h \
     src/graphics/aurora/modelnode.h \
     src/graphics/aurora/model.h \
     src/graphics/aurora/animnode.h \
@@ -74,10 +76,12 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/text.cpp \
     src/graphics/aurora/highlightabletext.cpp \
     src/graphics/aurora/fps.cpp \
+    src/graphics/aurora/profiledisplay.cpp \
     src/graphics/aurora/cube.cpp \
     src/graphics/aurora/highlightableguiquad.cpp \
     src/graphics/aurora/guiquad.cpp \
     src/graphics/aurora/geometryobject.cpp \
+    src/graphics/aurora/terrain.cpp \
     src/graphics/aurora/modelnode.cpp \
     src/graphics/aurora/model.cpp \
     src/graphics/aurora/animnode.cpp \
@@ -0,0 +1,530 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A terrain, split into culled chunks with several levels of detail.
+ */
+
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "src/common/util.h"
+#include "src/common/matrix4x4.h"
+
+#include "src/graphics/graphics.h"
+#include "src/graphics/camera.h"
+
+#include "src/graphics/aurora/terrain.h"
+#include "src/graphics/aurora/textureman.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** Coordinates closer together than this are on the same grid line. */
+static const float kGridEpsilon = 0.001f;
+
+/** The height error a level may have, relative to its distance from the camera. */
+static const float kLODErrorRatio = 0.002f;
+
+/** Don't split quadtree nodes with this many chunks or fewer. */
+static const size_t kChunksPerLeaf = 2;
+/** The maximum depth of the quadtree. */
+static const uint32 kMaxTreeDepth = 8;
+
+static const uint32 kNoVertex = 0xFFFFFFFF;
+
+
+Terrain::Chunk::Chunk() : gridWidth(0), gridHeight(0), facesUp(true) {
+}
+
+Terrain::Node::Node() {
+	children[0] = children[1] = children[2] = children[3] = 0;
+}
+
+
+Terrain::Terrain() : Renderable(kRenderableTypeObject), _root(0) {
+	std::memset(_frustum, 0, sizeof(_frustum));
+	std::memset(_camera , 0, sizeof(_camera));
+}
+
+Terrain::~Terrain() {
+	hide();
+}
+
+size_t Terrain::getChunkCount() const {
+	return _chunks.size();
+}
+
+/** Return the size of one vertex attribute, in bytes. */
+static uint32 getAttribSize(const VertexAttrib &attrib) {
+	switch (attrib.type) {
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE:
+			return attrib.size;
+
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+			return attrib.size * 2;
+
+		case GL_DOUBLE:
+			return attrib.size * 8;
+
+		default:
+			break;
+	}
+
+	return attrib.size * 4;
+}
+
+/** Is this vertex buffer interleaved, starting with a 3 float position? */
+static bool hasInterleavedPositions(const VertexBuffer &buffer) {
+	const VertexDecl &decl = buffer.getVertexDecl();
+	if (decl.empty() || (decl[0].index != VPOSITION) || (decl[0].size != 3) || (decl[0].type != GL_FLOAT))
+		return false;
+
+	const byte *data = static_cast<const byte *>(buffer.getData());
+
+	uint32 offset = 0;
+	for (VertexDecl::const_iterator d = decl.begin(); d != decl.end(); ++d) {
+		if ((d->stride != (GLsizei) buffer.getSize()) || (d->pointer != data + offset))
+			return false;
+
+		offset += getAttribSize(*d);
+	}
+
+	return offset == buffer.getSize();
+}
+
+static inline const float *getPosition(const VertexBuffer &buffer, uint32 vertex) {
+	return reinterpret_cast<const float *>(static_cast<const byte *>(buffer.getData()) + vertex * buffer.getSize());
+}
+
+static inline uint32 getIndex(const IndexBuffer &buffer, uint32 i) {
+	if (buffer.getType() == GL_UNSIGNED_INT)
+		return static_cast<const uint32 *>(buffer.getData())[i];
+
+	return static_cast<const uint16 *>(buffer.getData())[i];
+}
+
+/** Sort the coordinates and merge those on the same grid line. */
+static void mergeGridLines(std::vector<float> &coords) {
+	std::sort(coords.begin(), coords.end());
+
+	std::vector<float> lines;
+	for (std::vector<float>::const_iterator c = coords.begin(); c != coords.end(); ++c)
+		if (lines.empty() || ((*c - lines.back()) > kGridEpsilon))
+			lines.push_back(*c);
+
+	coords.swap(lines);
+}
+
+static uint32 findGridLine(const std::vector<float> &lines, float coord) {
+	std::vector<float>::const_iterator l = std::lower_bound(lines.begin(), lines.end(), coord - kGridEpsilon);
+	if ((l == lines.end()) || (ABS(*l - coord) > kGridEpsilon))
+		return kNoVertex;
+
+	return l - lines.begin();
+}
+
+void Terrain::addChunk(const VertexBuffer &vBuf, const IndexBuffer &iBuf) {
+	assert(!_root);
+
+	if ((vBuf.getCount() == 0) || (iBuf.getCount() < 3))
+		return;
+
+	Chunk *chunk = new Chunk;
+	_chunks.push_back(chunk);
+
+	chunk->vertexBuffer = vBuf;
+	chunk->indexBuffer  = iBuf;
+
+	if (hasInterleavedPositions(vBuf))
+		for (uint32 i = 0; i < vBuf.getCount(); i++) {
+			const float *position = getPosition(vBuf, i);
+
+			chunk->bound.add(position[0], position[1], position[2]);
+		}
+
+	chunk->bound.absolutize();
+
+	createGrid(*chunk);
+}
+
+void Terrain::createGrid(Chunk &chunk) {
+	// The finest level is always the original geometry
+	chunk.errors.push_back(0.0f);
+
+	const VertexBuffer &vBuf = chunk.vertexBuffer;
+	if (!hasInterleavedPositions(vBuf))
+		return;
+
+	const uint32 count = vBuf.getCount();
+
+	std::vector<float> linesX, linesY;
+	linesX.reserve(count);
+	linesY.reserve(count);
+
+	for (uint32 i = 0; i < count; i++) {
+		linesX.push_back(getPosition(vBuf, i)[0]);
+		linesY.push_back(getPosition(vBuf, i)[1]);
+	}
+
+	mergeGridLines(linesX);
+	mergeGridLines(linesY);
+
+	const uint32 width  = linesX.size();
+	const uint32 height = linesY.size();
+	if ((width < 3) || (height < 3) || ((width * height) != count))
+		return;
+
+	// Every grid point needs to have exactly one vertex
+
+	std::vector<uint32> grid(count, kNoVertex);
+	for (uint32 i = 0; i < count; i++) {
+		const float *position = getPosition(vBuf, i);
+
+		const uint32 x = findGridLine(linesX, position[0]);
+		const uint32 y = findGridLine(linesY, position[1]);
+		if ((x == kNoVertex) || (y == kNoVertex) || (grid[y * width + x] != kNoVertex))
+			return;
+
+		grid[y * width + x] = i;
+	}
+
+	chunk.gridWidth  = width;
+	chunk.gridHeight = height;
+	chunk.grid.swap(grid);
+
+	// Look at the first face to find out which way the faces wind
+
+	const float *a = getPosition(vBuf, getIndex(chunk.indexBuffer, 0));
+	const float *b = getPosition(vBuf, getIndex(chunk.indexBuffer, 1));
+	const float *c = getPosition(vBuf, getIndex(chunk.indexBuffer, 2));
+
+	chunk.facesUp = ((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0])) >= 0.0f;
+
+	/* Each coarser level skips every other grid line of the level before.
+	 * Its error is the biggest height difference between a vertex of the
+	 * full grid and the coarse triangle covering it. */
+
+	for (uint32 step = 2; (((width - 1) % step) == 0) && (((height - 1) % step) == 0); step *= 2) {
+		float error = chunk.errors.back();
+
+		for (uint32 y0 = 0; (y0 + step) < height; y0 += step) {
+			for (uint32 x0 = 0; (x0 + step) < width; x0 += step) {
+				const float z00 = getPosition(vBuf, chunk.grid[ y0         * width + x0        ])[2];
+				const float z10 = getPosition(vBuf, chunk.grid[ y0         * width + x0 + step ])[2];
+				const float z01 = getPosition(vBuf, chunk.grid[(y0 + step) * width + x0        ])[2];
+				const float z11 = getPosition(vBuf, chunk.grid[(y0 + step) * width + x0 + step ])[2];
+
+				for (uint32 y = 0; y <= step; y++) {
+					for (uint32 x = 0; x <= step; x++) {
+						const float u = (float) x / step;
+						const float v = (float) y / step;
+
+						const float z = (u >= v) ? (z00 + u * (z10 - z00) + v * (z11 - z10)) :
+						                           (z00 + v * (z01 - z00) + u * (z11 - z01));
+
+						const float real = getPosition(vBuf, chunk.grid[(y0 + y) * width + x0 + x])[2];
+
+						error = MAX(error, ABS(real - z));
+					}
+				}
+			}
+		}
+
+		chunk.errors.push_back(error);
+	}
+}
+
+/** Add a triangle to the list of indices. */
+static inline void addFace(std::vector<uint32> &indices, uint32 a, uint32 b, uint32 c, bool up) {
+	indices.push_back(a);
+	indices.push_back(up ? b : c);
+	indices.push_back(up ? c : b);
+}
+
+/** Add a skirt quad, visible from both sides, between the vertices a and b. */
+static inline void addSkirt(std::vector<uint32> &indices, uint32 a, uint32 b, uint32 skirtA, uint32 skirtB) {
+	addFace(indices, a, b, skirtB, true);
+	addFace(indices, a, skirtB, skirtA, true);
+	addFace(indices, a, b, skirtB, false);
+	addFace(indices, a, skirtB, skirtA, false);
+}
+
+void Terrain::createLevels(Chunk &chunk, float skirtDepth) {
+	if (chunk.gridWidth == 0) {
+		chunk.levels.push_back(chunk.indexBuffer);
+		return;
+	}
+
+	const uint32 width  = chunk.gridWidth;
+	const uint32 height = chunk.gridHeight;
+	const uint32 count  = chunk.vertexBuffer.getCount();
+
+	// Add a copy of every border vertex, moved down, for the skirts
+
+	std::vector<uint32> skirt(width * height, kNoVertex);
+
+	uint32 skirtCount = 0;
+	for (uint32 y = 0; y < height; y++)
+		for (uint32 x = 0; x < width; x++)
+			if ((x == 0) || (y == 0) || (x == (width - 1)) || (y == (height - 1)))
+				skirt[y * width + x] = count + skirtCount++;
+
+	VertexDecl vertexDecl = chunk.vertexBuffer.getVertexDecl();
+
+	VertexBuffer vBuf;
+	vBuf.setVertexDeclInterleave(count + skirtCount, vertexDecl);
+
+	const uint32 vertexSize = vBuf.getSize();
+	byte *data = static_cast<byte *>(vBuf.getData());
+
+	std::memcpy(data, chunk.vertexBuffer.getData(), count * vertexSize);
+
+	for (uint32 i = 0; i < (width * height); i++) {
+		if (skirt[i] == kNoVertex)
+			continue;
+
+		byte *vertex = data + skirt[i] * vertexSize;
+		std::memcpy(vertex, data + chunk.grid[i] * vertexSize, vertexSize);
+
+		reinterpret_cast<float *>(vertex)[2] -= skirtDepth;
+	}
+
+	chunk.vertexBuffer = vBuf;
+
+	const bool bigIndices = (count + skirtCount) > 0xFFFF;
+
+	uint32 step = 1;
+	for (size_t level = 0; level < chunk.errors.size(); level++, step *= 2) {
+		std::vector<uint32> indices;
+
+		if (level == 0) {
+			for (uint32 i = 0; i < chunk.indexBuffer.getCount(); i++)
+				indices.push_back(getIndex(chunk.indexBuffer, i));
+
+		} else {
+			for (uint32 y = 0; (y + step) < height; y += step) {
+				for (uint32 x = 0; (x + step) < width; x += step) {
+					const uint32 v00 = chunk.grid[ y         * width + x       ];
+					const uint32 v10 = chunk.grid[ y         * width + x + step];
+					const uint32 v01 = chunk.grid[(y + step) * width + x       ];
+					const uint32 v11 = chunk.grid[(y + step) * width + x + step];
+
+					addFace(indices, v00, v10, v11, chunk.facesUp);
+					addFace(indices, v00, v11, v01, chunk.facesUp);
+				}
+			}
+		}
+
+		for (uint32 x = 0; (x + step) < width; x += step) {
+			const uint32 bottom = 0, top = (height - 1) * width;
+
+			addSkirt(indices, chunk.grid[bottom + x], chunk.grid[bottom + x + step],
+			                  skirt     [bottom + x], skirt     [bottom + x + step]);
+			addSkirt(indices, chunk.grid[top    + x], chunk.grid[top    + x + step],
+			                  skirt     [top    + x], skirt     [top    + x + step]);
+		}
+
+		for (uint32 y = 0; (y + step) < height; y += step) {
+			const uint32 left = y * width, right = y * width + width - 1;
+
+			addSkirt(indices, chunk.grid[left ], chunk.grid[left  + step * width],
+			                  skirt     [left ], skirt     [left  + step * width]);
+			addSkirt(indices, chunk.grid[right], chunk.grid[right + step * width],
+			                  skirt     [right], skirt     [right + step * width]);
+		}
+
+		chunk.levels.push_back(IndexBuffer());
+		IndexBuffer &iBuf = chunk.levels.back();
+
+		if (bigIndices) {
+			iBuf.setSize(indices.size(), sizeof(uint32), GL_UNSIGNED_INT);
+			std::memcpy(iBuf.getData(), &indices[0], indices.size() * sizeof(uint32));
+		} else {
+			iBuf.setSize(indices.size(), sizeof(uint16), GL_UNSIGNED_SHORT);
+
+			uint16 *f = static_cast<uint16 *>(iBuf.getData());
+			for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
+				*f++ = *i;
+		}
+	}
+}
+
+void Terrain::finalize() {
+	if (_root)
+		return;
+
+	/* The skirts of all chunks hang down as far as the biggest error of any
+	 * level, so that they cover the cracks to any neighbour at any level. */
+
+	float skirtDepth = 0.0f;
+	for (Chunks::const_iterator c = _chunks.begin(); c != _chunks.end(); ++c)
+		skirtDepth = MAX(skirtDepth, (*c)->errors.back());
+
+	for (Chunks::iterator c = _chunks.begin(); c != _chunks.end(); ++c)
+		createLevels(**c, skirtDepth);
+
+	std::vector<Chunk *> chunks(_chunks.begin(), _chunks.end());
+	_root = createNode(chunks, 0);
+}
+
+Terrain::Node *Terrain::createNode(const std::vector<Chunk *> &chunks, uint32 depth) {
+	Node *node = new Node;
+	_nodes.push_back(node);
+
+	for (std::vector<Chunk *>::const_iterator c = chunks.begin(); c != chunks.end(); ++c)
+		node->bound.add((*c)->bound);
+
+	node->bound.absolutize();
+
+	if ((chunks.size() <= kChunksPerLeaf) || (depth >= kMaxTreeDepth)) {
+		node->chunks = chunks;
+		return node;
+	}
+
+	// Sort the chunks into quadrants, by the center of their bounding boxes
+
+	float minX, minY, minZ, maxX, maxY, maxZ;
+	node->bound.getMin(minX, minY, minZ);
+	node->bound.getMax(maxX, maxY, maxZ);
+
+	const float centerX = (minX + maxX) * 0.5f;
+	const float centerY = (minY + maxY) * 0.5f;
+
+	std::vector<Chunk *> quadrants[4];
+	for (std::vector<Chunk *>::const_iterator c = chunks.begin(); c != chunks.end(); ++c) {
+		float cMinX, cMinY, cMinZ, cMaxX, cMaxY, cMaxZ;
+		(*c)->bound.getMin(cMinX, cMinY, cMinZ);
+		(*c)->bound.getMax(cMaxX, cMaxY, cMaxZ);
+
+		const int quadrant = ((((cMinX + cMaxX) * 0.5f) >= centerX) ? 1 : 0) +
+		                     ((((cMinY + cMaxY) * 0.5f) >= centerY) ? 2 : 0);
+
+		quadrants[quadrant].push_back(*c);
+	}
+
+	// All chunks in one quadrant, nothing more to gain from splitting
+	for (int i = 0; i < 4; i++) {
+		if (quadrants[i].size() == chunks.size()) {
+			node->chunks = chunks;
+			return node;
+		}
+	}
+
+	for (int i = 0; i < 4; i++)
+		if (!quadrants[i].empty())
+			node->children[i] = createNode(quadrants[i], depth + 1);
+
+	return node;
+}
+
+void Terrain::calculateDistance() {
+	_distance = 0;
+}
+
+bool Terrain::isInFrustum(const Common::BoundingBox &bound) const {
+	float min[3], max[3];
+	bound.getMin(min[0], min[1], min[2]);
+	bound.getMax(max[0], max[1], max[2]);
+
+	// The box is outside if its corner furthest along a plane's normal is behind that plane
+	for (int i = 0; i < 6; i++) {
+		const float *plane = _frustum[i];
+
+		const float x = (plane[0] >= 0.0f) ? max[0] : min[0];
+		const float y = (plane[1] >= 0.0f) ? max[1] : min[1];
+		const float z = (plane[2] >= 0.0f) ? max[2] : min[2];
+
+		if ((plane[0] * x + plane[1] * y + plane[2] * z + plane[3]) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+size_t Terrain::selectLevel(const Chunk &chunk) const {
+	float min[3], max[3];
+	chunk.bound.getMin(min[0], min[1], min[2]);
+	chunk.bound.getMax(max[0], max[1], max[2]);
+
+	// Distance from the camera to the closest point of the chunk
+	float distance = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		const float d = MAX(MAX(min[i] - _camera[i], _camera[i] - max[i]), 0.0f);
+
+		distance += d * d;
+	}
+
+	distance = sqrtf(distance);
+
+	size_t level = 0;
+	while (((level + 1) < chunk.levels.size()) && (chunk.errors[level + 1] <= (distance * kLODErrorRatio)))
+		level++;
+
+	return level;
+}
+
+void Terrain::renderNode(const Node &node) {
+	if (!isInFrustum(node.bound))
+		return;
+
+	for (std::vector<Chunk *>::const_iterator c = node.chunks.begin(); c != node.chunks.end(); ++c) {
+		if ((node.chunks.size() > 1) && !isInFrustum((*c)->bound))
+			continue;
+
+		(*c)->vertexBuffer.draw(GL_TRIANGLES, (*c)->levels[selectLevel(**c)]);
+	}
+
+	for (int i = 0; i < 4; i++)
+		if (node.children[i])
+			renderNode(*node.children[i]);
+}
+
+void Terrain::render(RenderPass pass) {
+	if (!_root || (pass == kRenderPassTransparent))
+		return;
+
+	// Extract the planes of the view frustum out of the combined view and projection
+
+	const Common::Matrix4x4 viewProjection = GfxMan.getProjectionMatrix() * GfxMan.getModelviewMatrix();
+	const float *m = viewProjection.get();
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 4; j++) {
+			_frustum[i * 2 + 0][j] = m[j * 4 + 3] + m[j * 4 + i];
+			_frustum[i * 2 + 1][j] = m[j * 4 + 3] - m[j * 4 + i];
+		}
+	}
+
+	std::memcpy(_camera, CameraMan.getPosition(), 3 * sizeof(float));
+
+	TextureMan.reset();
+
+	renderNode(*_root);
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
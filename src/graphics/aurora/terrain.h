@@ -0,0 +1,135 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A terrain, split into culled chunks with several levels of detail.
+ */
+
+#ifndef GRAPHICS_AURORA_TERRAIN_H
+#define GRAPHICS_AURORA_TERRAIN_H
+
+#include <vector>
+
+#include "src/common/ptrvector.h"
+#include "src/common/boundingbox.h"
+
+#include "src/graphics/renderable.h"
+#include "src/graphics/indexbuffer.h"
+#include "src/graphics/vertexbuffer.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** A terrain, split into chunks.
+ *
+ *  The chunks are organized into a quadtree, so that whole groups of
+ *  chunks outside the view frustum are skipped at once.
+ *
+ *  Chunks whose vertices form a regular grid additionally get coarser
+ *  levels of detail, each skipping every other grid line of the level
+ *  before it. The level drawn is picked by the distance of the chunk to
+ *  the camera, so that the height error stays below a fixed fraction of
+ *  that distance. Skirts hanging down from the chunk borders hide the
+ *  cracks between neighbouring chunks drawn at different levels.
+ */
+class Terrain : public Renderable {
+public:
+	Terrain();
+	~Terrain();
+
+	/** Add a chunk of terrain.
+	 *
+	 *  The vertices need to be interleaved, starting with a 3 float position.
+	 *  Chunks can only be added before finalize() is called.
+	 */
+	void addChunk(const VertexBuffer &vBuf, const IndexBuffer &iBuf);
+
+	/** Create the levels of detail and the quadtree of all chunks added so far. */
+	void finalize();
+
+	/** Return the number of chunks in the terrain. */
+	size_t getChunkCount() const;
+
+	// Renderable
+	void calculateDistance();
+	void render(RenderPass pass);
+
+private:
+	/** A chunk of terrain. */
+	struct Chunk {
+		VertexBuffer vertexBuffer;   ///< The vertices, plus those of the skirts.
+		IndexBuffer  indexBuffer;    ///< The chunk's original faces.
+
+		uint32 gridWidth;            ///< Number of grid vertices along x, 0 if not a grid.
+		uint32 gridHeight;           ///< Number of grid vertices along y, 0 if not a grid.
+		std::vector<uint32> grid;    ///< The vertex index of each grid point.
+
+		bool facesUp;                ///< Do the faces wind counter-clockwise seen from above?
+
+		std::vector<float> errors;       ///< The maximum height error of each level of detail.
+		std::vector<IndexBuffer> levels; ///< The faces of each level of detail, including skirts.
+
+		Common::BoundingBox bound;   ///< The chunk's bounding box.
+
+		Chunk();
+	};
+
+	/** A node in the quadtree. */
+	struct Node {
+		Common::BoundingBox bound;   ///< The bounding box of all chunks in the node.
+
+		std::vector<Chunk *> chunks; ///< The chunks, if this is a leaf.
+		Node *children[4];           ///< The child nodes, if this isn't a leaf.
+
+		Node();
+	};
+
+	typedef Common::PtrVector<Chunk> Chunks;
+	typedef Common::PtrVector<Node> Nodes;
+
+	Chunks _chunks; ///< All chunks.
+	Nodes  _nodes;  ///< All nodes of the quadtree.
+
+	Node *_root; ///< The root of the quadtree.
+
+	float _frustum[6][4]; ///< The planes of the view frustum, while rendering.
+	float _camera[3];     ///< The camera position, while rendering.
+
+
+	/** Find the grid in a chunk's vertices and calculate the errors of its levels. */
+	static void createGrid(Chunk &chunk);
+	/** Create the faces of a chunk's levels, with skirts hanging down by skirtDepth. */
+	static void createLevels(Chunk &chunk, float skirtDepth);
+
+	/** Build a quadtree node from these chunks. */
+	Node *createNode(const std::vector<Chunk *> &chunks, uint32 depth);
+
+	bool isInFrustum(const Common::BoundingBox &bound) const;
+	size_t selectLevel(const Chunk &chunk) const;
+
+	void renderNode(const Node &node);
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_TERRAIN_H
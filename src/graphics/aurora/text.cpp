@@ -36,7 +36,7 @@ Text::Text(const FontHandle &font, const Common::UString &str,
 		float r, float g, float b, float a, float align) :
 	Graphics::GUIElement(Graphics::GUIElement::kGUIElementFront),
 	_r(r), _g(g), _b(b), _a(a), _font(font), _x(0.0f), _y(0.0f), _align(align),
-	_disableColorTokens(false) {
+	_disableColorTokens(false), _layoutDirty(true) {
 
 	set(str);
 
@@ -49,6 +49,7 @@ Text::~Text() {
 
 void Text::disableColorTokens(bool disabled) {
 	_disableColorTokens = disabled;
+	_layoutDirty = true;
 }
 
 void Text::set(const Common::UString &str, float maxWidth, float maxHeight) {
@@ -68,6 +69,8 @@ void Text::set(const Common::UString &str, float maxWidth, float maxHeight) {
 	_height = font.getHeight(_str, maxWidth, maxHeight);
 	_width  = font.getWidth (_str, maxWidth);
 
+	_layoutDirty = true;
+
 	unlockFrameIfVisible();
 }
 
@@ -79,6 +82,9 @@ void Text::getColor(float& r, float& g, float& b, float& a) const {
 }
 
 void Text::setColor(float r, float g, float b, float a) {
+	if ((_r == r) && (_g == g) && (_b == b) && (_a == a))
+		return;
+
 	lockFrameIfVisible();
 
 	_r = r;
@@ -86,6 +92,8 @@ void Text::setColor(float r, float g, float b, float a) {
 	_b = b;
 	_a = a;
 
+	_layoutDirty = true;
+
 	unlockFrameIfVisible();
 }
 
@@ -95,6 +103,7 @@ void Text::unsetColor() {
 
 void Text::setAlign(float align) {
 	_align = align;
+	_layoutDirty = true;
 }
 
 const Common::UString &Text::get() const {
@@ -145,7 +154,14 @@ void Text::render(RenderPass pass) {
 
 	glTranslatef(_x, _y, 0.0f);
 
-	_font.getFont().draw(_str, _colors, _r, _g, _b, _a, _align, _width, _height);
+	Font &font = _font.getFont();
+
+	if (_layoutDirty) {
+		font.layout(_str, _colors, _layout, _r, _g, _b, _a, _align, _width, _height);
+		_layoutDirty = false;
+	}
+
+	font.draw(_layout);
 }
 
 bool Text::isIn(float x, float y) const {
@@ -29,6 +29,7 @@
 #include "src/common/maths.h"
 
 #include "src/graphics/types.h"
+#include "src/graphics/font.h"
 #include <src/graphics/guielement.h>
 
 #include "src/graphics/aurora/fonthandle.h"
@@ -88,6 +89,10 @@ private:
 
 	bool _disableColorTokens;
 
+	/** The text, laid out by the font. Only redone when the text or its looks change. */
+	TextLayout _layout;
+	bool _layoutDirty;
+
 	void parseColors(const Common::UString &str, Common::UString &parsed,
 	                 ColorPositions &colors);
 };
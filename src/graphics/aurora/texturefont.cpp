@@ -23,6 +23,8 @@
  */
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
 
 #include "src/common/types.h"
 #include "src/common/error.h"
@@ -58,6 +60,8 @@ static uint32 convertToUTF32(byte c, Common::Encoding encoding) {
 
 // TODO: Multibyte fonts?
 TextureFont::TextureFont(const Common::UString &name) : _height(1.0f), _spaceR(0.0f), _spaceB(0.0f) {
+	std::fill(_latinChars, _latinChars + kLatinCharCount, static_cast<const Char *>(0));
+
 	_texture = TextureMan.get(name);
 
 	load();
@@ -67,14 +71,14 @@ TextureFont::~TextureFont() {
 }
 
 float TextureFont::getWidth(uint32 c) const {
-	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	const Char *cC = findChar(c);
 
-	if (cC == _chars.end())
-		cC = _chars.find('m');
-	if (cC == _chars.end())
+	if (!cC)
+		cC = findChar('m');
+	if (!cC)
 		return _spaceR;
 
-	return cC->second.width + _spaceR;
+	return cC->width + _spaceR;
 }
 
 float TextureFont::getHeight() const {
@@ -85,39 +89,43 @@ float TextureFont::getLineSpacing() const {
 	return _spaceB;
 }
 
-void TextureFont::drawMissing() const {
-	TextureMan.set();
+void TextureFont::getGlyph(uint32 c, GlyphQuad &glyph) const {
+	const Char *cC = findChar(c);
+	if (!cC) {
+		const float width = getWidth('m') - _spaceR;
 
-	float width = getWidth('m') - _spaceR;
+		getMissingGlyph(glyph, width, width + _spaceR);
+		return;
+	}
 
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
+	glyph.page = 0;
 
-	glTranslatef(width + _spaceR, 0.0f, 0.0f);
-}
+	std::memcpy(glyph.tX, cC->tX, sizeof(glyph.tX));
+	std::memcpy(glyph.tY, cC->tY, sizeof(glyph.tY));
+	std::memcpy(glyph.vX, cC->vX, sizeof(glyph.vX));
+	std::memcpy(glyph.vY, cC->vY, sizeof(glyph.vY));
 
-void TextureFont::draw(uint32 c) const {
-	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	glyph.advance = cC->width + _spaceR;
+}
 
-	if (cC == _chars.end()) {
-		drawMissing();
+void TextureFont::bindPage(size_t page) const {
+	if (page == kNoPage) {
+		TextureMan.set();
 		return;
 	}
 
 	TextureMan.set(_texture);
+}
 
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
-	}
-	glEnd();
+const TextureFont::Char *TextureFont::findChar(uint32 c) const {
+	if (c < kLatinCharCount)
+		return _latinChars[c];
+
+	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	if (cC == _chars.end())
+		return 0;
 
-	glTranslatef(cC->second.width + _spaceR, 0.0f, 0.0f);
+	return &cC->second;
 }
 
 void TextureFont::load() {
@@ -182,6 +190,9 @@ void TextureFont::load() {
 		c.vX[3] = 0.00f;           c.vY[3] = _height;
 
 		c.width = c.vX[1] - c.vX[0];
+
+		if (result.first->first < kLatinCharCount)
+			_latinChars[result.first->first] = &c;
 	}
 }
 
@@ -54,9 +54,13 @@ public:
 
 	float getLineSpacing() const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, GlyphQuad &glyph) const;
+	void bindPage(size_t page) const;
 
 private:
+	/** Characters below this are looked up in a flat table: Basic Latin to Latin Extended-B. */
+	static const uint32 kLatinCharCount = 0x0250;
+
 	/** A font character. */
 	struct Char {
 		float width;
@@ -67,6 +71,7 @@ private:
 	TextureHandle _texture;
 
 	std::map<uint32, Char> _chars;
+	const Char *_latinChars[kLatinCharCount];
 
 	float _height;
 	float _spaceR;
@@ -74,7 +79,7 @@ private:
 
 	void load();
 
-	void drawMissing() const;
+	const Char *findChar(uint32 c) const;
 };
 
 } // End of namespace Aurora
@@ -41,6 +41,9 @@ struct ManagedTexture {
 	Texture *texture;
 	uint32 referenceCount;
 
+	/** If this is a recolored PLT shared with other managed textures, its sharing key. */
+	Common::UString sharedPLT;
+
 	ManagedTexture(Texture *t);
 	~ManagedTexture();
 };
@@ -29,6 +29,7 @@
 
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
+#include "src/graphics/aurora/pltfile.h"
 
 #include "src/graphics/images/decoder.h"
 
@@ -92,10 +93,15 @@ void TextureManager::clear() {
 
 	_bogusTextures.clear();
 
-	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t)
+	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t) {
+		unsharePLT(*t->second);
 		delete t->second;
+	}
 	_textures.clear();
 
+	_sharedPLTs.clear();
+	_palettes.clear();
+
 	_recordNewTextures = false;
 	_newTextureNames.clear();
 }
@@ -213,6 +219,8 @@ void TextureManager::release(TextureHandle &texture) {
 
 	if (!texture._empty && (texture._it != _textures.end())) {
 		if (--texture._it->second->referenceCount == 0) {
+			unsharePLT(*texture._it->second);
+
 			delete texture._it->second;
 			_textures.erase(texture._it);
 		}
@@ -239,6 +247,85 @@ void TextureManager::reloadAll() {
 	GfxMan.unlockFrame();
 }
 
+const ImageDecoder &TextureManager::getPalette(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	Common::PtrMap<Common::UString, ImageDecoder>::const_iterator palette = _palettes.find(name);
+	if (palette != _palettes.end())
+		return *palette->second;
+
+	Common::ScopedPtr<ImageDecoder> image(Texture::loadImage(name));
+
+	std::pair<Common::PtrMap<Common::UString, ImageDecoder>::iterator, bool> result =
+		_palettes.insert(std::make_pair(name, image.get()));
+
+	image.release();
+
+	return *result.first->second;
+}
+
+bool TextureManager::sharePLT(const TextureHandle &plt) {
+	Common::StackLock lock(_mutex);
+
+	if (plt._empty)
+		return false;
+
+	ManagedTexture &managed = *plt._it->second;
+	if (!managed.sharedPLT.empty())
+		return false;
+
+	PLTFile *pltFile = dynamic_cast<PLTFile *>(managed.texture);
+	if (!pltFile)
+		return false;
+
+	const Common::UString key = pltFile->getColorKey();
+
+	SharedPLTMap::iterator shared = _sharedPLTs.find(key);
+	if (shared == _sharedPLTs.end()) {
+		// First PLT with these colors, others will share this one
+
+		_sharedPLTs.insert(std::make_pair(key, SharedPLT(managed.texture)));
+		managed.sharedPLT = key;
+
+		return false;
+	}
+
+	// Replace our PLT with the identical one
+
+	GfxMan.lockFrame();
+
+	delete managed.texture;
+
+	managed.texture   = shared->second.texture;
+	managed.sharedPLT = key;
+
+	shared->second.users++;
+
+	GfxMan.unlockFrame();
+
+	return true;
+}
+
+void TextureManager::unsharePLT(ManagedTexture &texture) {
+	if (texture.sharedPLT.empty())
+		return;
+
+	SharedPLTMap::iterator shared = _sharedPLTs.find(texture.sharedPLT);
+	texture.sharedPLT.clear();
+
+	if (shared == _sharedPLTs.end())
+		return;
+
+	// The last user deletes the PLT along with its managed texture
+	if (--shared->second.users == 0) {
+		_sharedPLTs.erase(shared);
+		return;
+	}
+
+	// Make sure the managed texture doesn't delete the PLT others still use
+	texture.texture = 0;
+}
+
 void TextureManager::reset() {
 	for (size_t i = 0; i < kTextureUnitCount; i++) {
 		activeTexture(i);
@@ -32,11 +32,14 @@
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
 #include "src/common/ustring.h"
+#include "src/common/ptrmap.h"
 
 #include "src/graphics/aurora/texturehandle.h"
 
 namespace Graphics {
 
+class ImageDecoder;
+
 namespace Aurora {
 
 /** The global Aurora texture manager. */
@@ -80,6 +83,27 @@ public:
 	void reloadAll();
 	// '---
 
+	// .--- Paletted layer textures
+	/** Return the palette image with this name, loading it on first use.
+	 *
+	 *  The palette images used to color PLT layers are shared by all PLTs.
+	 *  The image stays valid until the TextureManager is cleared.
+	 */
+	const ImageDecoder &getPalette(const Common::UString &name);
+
+	/** Share this PLT texture with all other PLTs of the same image and layer colors.
+	 *
+	 *  If an identical PLT already exists, the handle's texture is replaced
+	 *  by that one, and the now unused PLT is deleted. Otherwise, this PLT
+	 *  becomes the one shared with identical PLTs found later. Either way,
+	 *  the PLT must not be recolored afterwards.
+	 *
+	 *  @return true if an already existing PLT is used now, which doesn't
+	 *          need to be rebuilt.
+	 */
+	bool sharePLT(const TextureHandle &plt);
+	// '---
+
 	// .--- Texture rendering
 	/** Bind this texture to the current texture unit. */
 	void set(const TextureHandle &handle, TextureMode mode = kModeDiffuse);
@@ -102,9 +126,26 @@ private:
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
+	/** A recolored PLT shared by several managed textures. */
+	struct SharedPLT {
+		Texture *texture;
+		uint32 users; ///< Number of managed textures using this PLT.
+
+		SharedPLT(Texture *t = 0) : texture(t), users(1) { }
+	};
+
+	typedef std::map<Common::UString, SharedPLT> SharedPLTMap;
+
+	SharedPLTMap _sharedPLTs;
+
+	Common::PtrMap<Common::UString, ImageDecoder> _palettes;
+
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
+	/** Stop this managed texture from sharing its PLT, deleting the PLT if it was the last user. */
+	void unsharePLT(ManagedTexture &texture);
+
 	friend class TextureHandle;
 };
 
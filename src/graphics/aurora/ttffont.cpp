@@ -23,6 +23,8 @@
  */
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -30,6 +32,8 @@
 
 #include "src/aurora/resman.h"
 
+#include "src/events/requests.h"
+
 #include "src/graphics/texture.h"
 #include "src/graphics/ttf.h"
 
@@ -55,12 +59,12 @@ TTFFont::Page::Page() : needRebuild(false),
 	texture = TextureMan.add(Texture::create(surface));
 }
 
-void TTFFont::Page::rebuild() {
+Events::RequestFence TTFFont::Page::rebuild() {
 	if (!needRebuild)
-		return;
+		return 0;
 
-	texture.getTexture().rebuild();
 	needRebuild = false;
+	return texture.getTexture().queueRebuild();
 }
 
 
@@ -82,6 +86,8 @@ TTFFont::~TTFFont() {
 void TTFFont::load(Common::SeekableReadStream *ttf, int height) {
 	Common::ScopedPtr<Common::SeekableReadStream> ttfStream(ttf);
 
+	std::fill(_latinChars, _latinChars + kLatinCharCount, static_cast<const Char *>(0));
+
 	_ttf.reset(new TTFRenderer(*ttfStream, height));
 
 	_height = _ttf->getHeight();
@@ -94,76 +100,67 @@ void TTFFont::load(Common::SeekableReadStream *ttf, int height) {
 
 	// Add the Unicode "replacement character" character
 	addChar(0xFFFD);
-	_missingChar = _chars.find(0xFFFD);
+	_missingChar = findChar(0xFFFD);
 
 	// Find an appropriate width for a "missing character" character
-	if (_missingChar == _chars.end()) {
+	if (!_missingChar) {
 		// This font doesn't have the Unicode "replacement character"
 
 		// Try to find the width of an m. Alternatively, take half of a line's height.
-		std::map<uint32, Char>::const_iterator m = _chars.find('m');
-		if (m != _chars.end())
-			_missingWidth = m->second.width;
+		const Char *m = findChar('m');
+		if (m)
+			_missingWidth = m->width;
 		else
 			_missingWidth = MAX<float>(2.0f, _height / 2);
 
 	} else
-		_missingWidth = _missingChar->second.width;
+		_missingWidth = _missingChar->width;
 
 	rebuildPages();
 }
 
 float TTFFont::getWidth(uint32 c) const {
-	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
-	if (cC == _chars.end())
+	const Char *cC = findChar(c);
+	if (!cC)
 		return _missingWidth;
 
-	return cC->second.width;
+	return cC->width;
 }
 
 float TTFFont::getHeight() const {
 	return _height;
 }
 
-void TTFFont::drawMissing() const {
-	TextureMan.set();
-
-	const float width = _missingWidth - 1.0f;
-
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
-
-	glTranslatef(width + 1.0f, 0.0f, 0.0f);
-}
-
-void TTFFont::draw(uint32 c) const {
-	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
-	if (cC == _chars.end()) {
+void TTFFont::getGlyph(uint32 c, GlyphQuad &glyph) const {
+	const Char *cC = findChar(c);
+	if (!cC) {
 		cC = _missingChar;
 
-		if (cC == _chars.end()) {
-			drawMissing();
+		if (!cC) {
+			getMissingGlyph(glyph, _missingWidth - 1.0f, _missingWidth);
 			return;
 		}
 	}
 
-	size_t page = cC->second.page;
-	assert(page < _pages.size());
+	assert(cC->page < _pages.size());
 
-	TextureMan.set(_pages[page]->texture);
+	glyph.page = cC->page;
+
+	std::memcpy(glyph.tX, cC->tX, sizeof(glyph.tX));
+	std::memcpy(glyph.tY, cC->tY, sizeof(glyph.tY));
+	std::memcpy(glyph.vX, cC->vX, sizeof(glyph.vX));
+	std::memcpy(glyph.vY, cC->vY, sizeof(glyph.vY));
 
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
+	glyph.advance = cC->width;
+}
+
+void TTFFont::bindPage(size_t page) const {
+	if (page >= _pages.size()) {
+		TextureMan.set();
+		return;
 	}
-	glEnd();
 
-	glTranslatef(cC->second.width, 0.0f, 0.0f);
+	TextureMan.set(_pages[page]->texture);
 }
 
 void TTFFont::buildChars(const Common::UString &str) {
@@ -174,8 +171,23 @@ void TTFFont::buildChars(const Common::UString &str) {
 }
 
 void TTFFont::rebuildPages() {
+	// Rebuild all pages in one batch, waiting only once
+	Events::RequestFence fence = 0;
 	for (std::vector<Page *>::iterator p = _pages.begin(); p != _pages.end(); ++p)
-		(*p)->rebuild();
+		fence = MAX(fence, (*p)->rebuild());
+
+	RequestMan.waitFence(fence);
+}
+
+const TTFFont::Char *TTFFont::findChar(uint32 c) const {
+	if (c < kLatinCharCount)
+		return _latinChars[c];
+
+	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
+	if (cC == _chars.end())
+		return 0;
+
+	return &cC->second;
 }
 
 void TTFFont::addChar(uint32 c) {
@@ -251,6 +263,9 @@ void TTFFont::addChar(uint32 c) {
 		_pages.back()->curX       += cWidth;
 		_pages.back()->needRebuild = true;
 
+		if (c < kLatinCharCount)
+			_latinChars[c] = &ch;
+
 	} catch (...) {
 		if (cC != _chars.end())
 			_chars.erase(cC);
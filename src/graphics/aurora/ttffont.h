@@ -32,6 +32,8 @@
 #include "src/common/scopedptr.h"
 #include "src/common/ptrvector.h"
 
+#include "src/events/types.h"
+
 #include "src/graphics/font.h"
 
 #include "src/graphics/aurora/texturehandle.h"
@@ -56,11 +58,15 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void getGlyph(uint32 c, GlyphQuad &glyph) const;
+	void bindPage(size_t page) const;
 
 	void buildChars(const Common::UString &str);
 
 private:
+	/** Characters below this are looked up in a flat table: Basic Latin to Latin Extended-B. */
+	static const uint32 kLatinCharCount = 0x0250;
+
 	/** A texture page filled with characters. */
 	struct Page {
 		Surface *surface;
@@ -76,7 +82,8 @@ private:
 
 		Page();
 
-		void rebuild();
+		/** Queue the rebuild of the page's texture, if needed. Returns the fence to wait for. */
+		Events::RequestFence rebuild();
 	};
 
 	/** A font character. */
@@ -94,8 +101,9 @@ private:
 
 	Common::PtrVector<Page> _pages;
 	std::map<uint32, Char> _chars;
+	const Char *_latinChars[kLatinCharCount];
 
-	std::map<uint32, Char>::const_iterator _missingChar;
+	const Char *_missingChar;
 	float _missingWidth;
 
 	uint32 _height;
@@ -104,7 +112,7 @@ private:
 
 	void rebuildPages();
 	void addChar(uint32 c);
-	void drawMissing() const;
+	const Char *findChar(uint32 c) const;
 };
 
 } // End of namespace Aurora
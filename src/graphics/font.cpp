@@ -30,6 +30,34 @@
 
 namespace Graphics {
 
+const size_t TextLayout::kVertexSize;
+
+size_t TextLayout::getPage(size_t page) {
+	for (size_t i = 0; i < pages.size(); i++)
+		if (pages[i].page == page)
+			return i;
+
+	pages.push_back(Page());
+	pages.back().page = page;
+
+	return pages.size() - 1;
+}
+
+void TextLayout::clear() {
+	pages.clear();
+}
+
+bool TextLayout::empty() const {
+	for (std::vector<Page>::const_iterator p = pages.begin(); p != pages.end(); ++p)
+		if (!p->vertices.empty())
+			return false;
+
+	return true;
+}
+
+
+const size_t Font::kNoPage;
+
 Font::Font() {
 }
 
@@ -66,57 +94,112 @@ float Font::getHeight(const Common::UString &text, float maxWidth, float maxHeig
 void Font::buildChars(const Common::UString &UNUSED(str)) {
 }
 
-void Font::draw(Common::UString text, const ColorPositions &colors,
-                float r, float g, float b, float a, float align, float maxWidth, float maxHeight) const {
+void Font::layout(const Common::UString &text, const ColorPositions &colors, TextLayout &textLayout,
+                  float r, float g, float b, float a, float align, float maxWidth, float maxHeight) const {
 
-	glColor4f(r, g, b, a);
+	textLayout.clear();
 
 	std::vector<Common::UString> lines;
 	float maxLength = split(text, lines, maxWidth, maxHeight, false);
 
-	// Move position to the top
-	glTranslatef(0.0f, (lines.size() - 1) * (getHeight() + getLineSpacing()), 0.0f);
+	// Start at the top
+	float y = (lines.size() - 1) * (getHeight() + getLineSpacing());
+
+	float color[4] = { r, g, b, a };
 
 	size_t position = 0;
 
-	ColorPositions::const_iterator color = colors.begin();
+	ColorPositions::const_iterator colorChange = colors.begin();
 
-	// Draw lines
-	for (std::vector<Common::UString>::iterator l = lines.begin(); l != lines.end(); ++l) {
-		// Save the current position
-		glPushMatrix();
+	GlyphQuad glyph;
+
+	size_t lastPage  = kNoPage;
+	size_t pageIndex = 0;
 
+	// Lay out lines
+	for (std::vector<Common::UString>::iterator l = lines.begin(); l != lines.end(); ++l) {
 		// Align
-		glTranslatef(roundf((maxLength - getLineWidth(*l)) * align), 0.0f, 0.0f);
+		float x = roundf((maxLength - getLineWidth(*l)) * align);
 
-		// Draw line
+		// Lay out the line
 		for (Common::UString::iterator s = l->begin(); s != l->end(); ++s, position++) {
 			// If we have color changes, apply them
-			while ((color != colors.end()) && (color->position <= position)) {
-				if (color->defaultColor)
-					glColor4f(r, g, b, a);
-				else
-					glColor4f(color->r, color->g, color->b, color->a);
+			while ((colorChange != colors.end()) && (colorChange->position <= position)) {
+				if (colorChange->defaultColor) {
+					color[0] = r; color[1] = g; color[2] = b; color[3] = a;
+				} else {
+					color[0] = colorChange->r; color[1] = colorChange->g;
+					color[2] = colorChange->b; color[3] = colorChange->a;
+				}
 
-				++color;
+				++colorChange;
 			}
 
-			draw(*s);
-		}
+			getGlyph(*s, glyph);
+
+			if ((glyph.page != lastPage) || textLayout.pages.empty()) {
+				pageIndex = textLayout.getPage(glyph.page);
+				lastPage  = glyph.page;
+			}
 
-		// Restore position to the start of the line
-		glPopMatrix();
+			std::vector<float> &vertices = textLayout.pages[pageIndex].vertices;
+			for (int i = 0; i < 4; i++) {
+				vertices.push_back(x + glyph.vX[i]);
+				vertices.push_back(y + glyph.vY[i]);
+				vertices.push_back(glyph.tX[i]);
+				vertices.push_back(glyph.tY[i]);
+				vertices.insert(vertices.end(), color, color + 4);
+			}
+
+			x += glyph.advance;
+		}
 
 		// Move to the next line
-		glTranslatef(0.0f, -(getHeight() + getLineSpacing()), 0.0f);
+		y -= getHeight() + getLineSpacing();
 
 		// \n character
 		position++;
 	}
+}
+
+void Font::draw(const TextLayout &textLayout) const {
+	const GLsizei stride = TextLayout::kVertexSize * sizeof(float);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	for (std::vector<TextLayout::Page>::const_iterator p = textLayout.pages.begin(); p != textLayout.pages.end(); ++p) {
+		if (p->vertices.empty())
+			continue;
+
+		bindPage(p->page);
+
+		const float *vertices = &p->vertices[0];
+
+		glVertexPointer  (2, GL_FLOAT, stride, vertices);
+		glTexCoordPointer(2, GL_FLOAT, stride, vertices + 2);
+		glColorPointer   (4, GL_FLOAT, stride, vertices + 4);
+
+		glDrawArrays(GL_QUADS, 0, p->vertices.size() / TextLayout::kVertexSize);
+	}
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
 
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
+void Font::draw(Common::UString text, const ColorPositions &colors,
+                float r, float g, float b, float a, float align, float maxWidth, float maxHeight) const {
+
+	TextLayout textLayout;
+	layout(text, colors, textLayout, r, g, b, a, align, maxWidth, maxHeight);
+
+	draw(textLayout);
+}
+
 float Font::split(const Common::UString &line, std::vector<Common::UString> &lines,
                   float maxWidth, float maxHeight, bool trim) const {
 
@@ -305,6 +388,22 @@ float Font::split(const Common::UString &line, Common::UString &lines, float max
 	return width;
 }
 
+void Font::getMissingGlyph(GlyphQuad &glyph, float width, float advance) const {
+	const float height = getHeight();
+
+	glyph.page = kNoPage;
+
+	glyph.vX[0] = 0.0f ; glyph.vY[0] = 0.0f  ;
+	glyph.vX[1] = width; glyph.vY[1] = 0.0f  ;
+	glyph.vX[2] = width; glyph.vY[2] = height;
+	glyph.vX[3] = 0.0f ; glyph.vY[3] = height;
+
+	for (int i = 0; i < 4; i++)
+		glyph.tX[i] = glyph.tY[i] = 0.0f;
+
+	glyph.advance = advance;
+}
+
 float Font::getLineWidth(const Common::UString &text) const {
 	float width = 0.0f;
 
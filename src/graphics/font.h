@@ -33,9 +33,44 @@
 
 namespace Graphics {
 
+/** A text laid out by a font into quads, grouped by font texture page. */
+struct TextLayout {
+	/** All quads on one texture page of the font. */
+	struct Page {
+		size_t page; ///< The font's texture page.
+
+		/** Interleaved vertex data, kVertexSize floats per vertex:
+		 *  position (x, y), texture coordinates (u, v) and color (r, g, b, a). */
+		std::vector<float> vertices;
+	};
+
+	static const size_t kVertexSize = 8; ///< Number of floats per vertex.
+
+	std::vector<Page> pages;
+
+	/** Return the index into the pages vector for this font texture page. */
+	size_t getPage(size_t page);
+
+	void clear();
+	bool empty() const;
+};
+
 /** An abstract font. */
 class Font {
 public:
+	/** A character of the font, as a quad relative to the current pen position. */
+	struct GlyphQuad {
+		/** The font texture page the character is on, or kNoPage for an untextured quad. */
+		size_t page;
+
+		float tX[4], tY[4];
+		float vX[4], vY[4];
+
+		float advance; ///< How far to move the pen after drawing this character.
+	};
+
+	static const size_t kNoPage = SIZE_MAX;
+
 	Font();
 	virtual ~Font();
 
@@ -58,8 +93,17 @@ public:
 	/** Build all necessary characters to display this string. */
 	virtual void buildChars(const Common::UString &str);
 
-	/** Draw this character. */
-	virtual void draw(uint32 c) const = 0;
+	/** Get the quad to draw this character with. */
+	virtual void getGlyph(uint32 c, GlyphQuad &glyph) const = 0;
+	/** Bind the texture of a font page, or no texture for kNoPage. */
+	virtual void bindPage(size_t page) const = 0;
+
+	/** Lay out a text into quads, which can then be drawn as often as needed. */
+	void layout(const Common::UString &text, const ColorPositions &colors, TextLayout &textLayout,
+	            float r, float g, float b, float a, float align = 0.0f, float maxWidth = 0.0f, float maxHeight = 0.0f) const;
+
+	/** Draw a text laid out before, with one draw call per font texture page. */
+	void draw(const TextLayout &textLayout) const;
 
 	void draw(Common::UString text, const ColorPositions &colors,
 		  float r, float g, float b, float a, float align = 0.0f, float maxWidth = 0.0f, float maxHeight = 0.0f) const;
@@ -69,6 +113,10 @@ public:
 	float split(Common::UString &line, float maxWidth, float maxHeight = 0.0f, bool trim = true) const;
 	float split(const Common::UString &line, Common::UString &lines, float maxWidth, float maxHeight = 0.0f, bool trim = true) const;
 
+protected:
+	/** Get an untextured box, standing in for a character the font doesn't have. */
+	void getMissingGlyph(GlyphQuad &glyph, float width, float advance) const;
+
 private:
 	float getLineWidth(const Common::UString &text) const;
 	bool addLine(std::vector<Common::UString> &lines, const Common::UString &newLine, float maxHeight) const;
@@ -31,20 +31,37 @@
 
 namespace Graphics {
 
-GLContainer::GLContainer() : _built(false) {
+GLContainer::GLContainer() : _built(false), _fence(0), _dying(false) {
 	addToQueue(kQueueGLContainer);
 }
 
 GLContainer::~GLContainer() {
+	/* The derived class is already gone, so requests still in the queue
+	 * can't call into it anymore. Skip them, but don't leave the queue
+	 * with a dangling pointer. */
+	_dying.store(true);
+	waitQueued();
+
 	removeFromQueue(kQueueGLContainer);
 }
 
+void GLContainer::waitQueued() {
+	if (_fence == 0)
+		return;
+
+	RequestMan.waitFence(_fence);
+	_fence = 0;
+}
+
 void GLContainer::rebuild() {
 	if (!Common::isMainThread()) {
-		RequestMan.dispatchAndWait(RequestMan.rebuild(*this));
+		RequestMan.waitFence(RequestMan.queueRebuild(*this));
 		return;
 	}
 
+	if (_dying.load())
+		return;
+
 	doRebuild();
 
 	_built = true;
@@ -55,13 +72,36 @@ void GLContainer::destroy() {
 		return;
 
 	if (!Common::isMainThread()) {
-		RequestMan.dispatchAndWait(RequestMan.destroy(*this));
+		RequestMan.waitFence(RequestMan.queueDestroy(*this));
 		return;
 	}
 
+	if (_dying.load())
+		return;
+
 	doDestroy();
 
 	_built = false;
 }
 
+Events::RequestFence GLContainer::queueRebuild() {
+	if (Common::isMainThread()) {
+		rebuild();
+		return 0;
+	}
+
+	_fence = RequestMan.queueRebuild(*this);
+	return _fence;
+}
+
+Events::RequestFence GLContainer::queueDestroy() {
+	if (Common::isMainThread()) {
+		destroy();
+		return 0;
+	}
+
+	_fence = RequestMan.queueDestroy(*this);
+	return _fence;
+}
+
 } // End of namespace Graphics
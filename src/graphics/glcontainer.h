@@ -25,8 +25,12 @@
 #ifndef GRAPHICS_GLCONTAINER_H
 #define GRAPHICS_GLCONTAINER_H
 
+#include "src/common/atomic.h"
+
 #include <boost/noncopyable.hpp>
 
+#include "src/events/types.h"
+
 #include "src/graphics/queueable.h"
 
 namespace Graphics {
@@ -40,12 +44,36 @@ public:
 	void rebuild();
 	void destroy();
 
+	/** Rebuild the container in the main thread, together with other queued requests.
+	 *
+	 *  Doesn't wait for the rebuild to happen. To wait for a whole batch of
+	 *  containers, wait for the fence of the last one with RequestMan.waitFence().
+	 *  Deleting the container waits for its queued requests, too.
+	 */
+	Events::RequestFence queueRebuild();
+	/** Destroy the container in the main thread, together with other queued requests.
+	 *
+	 *  Same as queueRebuild(), but for destroying the container.
+	 */
+	Events::RequestFence queueDestroy();
+
 protected:
 	virtual void doRebuild() = 0;
 	virtual void doDestroy() = 0;
 
+	/** Wait until the requests queued for this container were processed.
+	 *
+	 *  Containers that queue requests should call this at the start of their
+	 *  destructor, while doRebuild() and doDestroy() still work. Otherwise,
+	 *  the GLContainer destructor waits, and the requests are skipped.
+	 */
+	void waitQueued();
+
 private:
 	bool _built;
+
+	Events::RequestFence _fence; ///< The fence of the last request queued for this container.
+	boost::atomic<bool>  _dying; ///< Is the container being deleted?
 };
 
 } // End of namespace Graphics
@@ -26,6 +26,9 @@
 #include <cstring>
 
 #include <boost/bind.hpp>
+#include <boost/scope_exit.hpp>
+
+#include <SDL_timer.h>
 
 #include "src/version/version.h"
 
@@ -35,8 +38,10 @@
 #include "src/common/configman.h"
 #include "src/common/debugman.h"
 #include "src/common/threads.h"
+#include "src/common/threadpool.h"
 #include "src/common/matrix4x4.h"
 #include "src/common/vector3.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/events/requests.h"
 #include "src/events/events.h"
@@ -65,6 +70,52 @@ namespace Graphics {
 
 PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
 
+/** Minimum number of world objects worth giving to a separate update job. */
+static const size_t kMinObjectsPerUpdateJob = 8;
+
+/** A job advancing the time of a contiguous range of world objects. */
+class GraphicsManager::AdvanceTimeJob : public Common::Job {
+public:
+	AdvanceTimeJob(SDL_TLSID updateThread) : _updateThread(updateThread), _objects(0), _count(0), _dt(0.0f) {
+	}
+
+	void set(Renderable * const *objects, size_t count, float dt) {
+		_objects = objects;
+		_count   = count;
+		_dt      = dt;
+	}
+
+	void run() {
+		// Mark the thread as updating, for as long as the job runs
+		void *previous = SDL_TLSGet(_updateThread);
+		SDL_TLSSet(_updateThread, this, 0);
+
+		BOOST_SCOPE_EXIT( (&previous) (this_) ) {
+			SDL_TLSSet(this_->_updateThread, previous, 0);
+		} BOOST_SCOPE_EXIT_END
+
+		for (size_t i = 0; i < _count; i++)
+			_objects[i]->advanceTime(_dt);
+	}
+
+private:
+	SDL_TLSID _updateThread;
+
+	Renderable * const *_objects;
+	size_t _count;
+	float _dt;
+};
+
+
+GraphicsManager::UpdateStatistics::UpdateStatistics() : objectCount(0), jobCount(0), time(0.0f) {
+}
+
+GraphicsManager::RenderStatistics::RenderStatistics() : worldObjectCount(0), sortCount(0),
+	sortedObjects(0), sortTime(0.0f) {
+
+}
+
+
 GraphicsManager::GraphicsManager() : Events::Notifyable() {
 	_ready = false;
 
@@ -89,6 +140,8 @@ GraphicsManager::GraphicsManager() : Events::Notifyable() {
 
 	_fpsCounter.reset(new FPSCounter(3));
 
+	_updateThread = SDL_TLSCreate();
+
 	_frameLock.store(0);
 
 	_cursor = 0;
@@ -150,6 +203,9 @@ void GraphicsManager::deinit() {
 
 	QueueMan.clearAllQueues();
 
+	_updateJobs.clear();
+	_updateObjects.clear();
+
 	MeshMan.deinit();
 	MaterialMan.deinit();
 	SurfaceMan.deinit();
@@ -187,6 +243,18 @@ uint32 GraphicsManager::getFPS() const {
 	return _fpsCounter->getFPS();
 }
 
+GraphicsManager::UpdateStatistics GraphicsManager::getUpdateStatistics() const {
+	Common::StackLock lock(_statisticsMutex);
+
+	return _updateStatistics;
+}
+
+GraphicsManager::RenderStatistics GraphicsManager::getRenderStatistics() const {
+	Common::StackLock lock(_statisticsMutex);
+
+	return _renderStatistics;
+}
+
 bool GraphicsManager::setFSAA(int level) {
 	// Force calling it from the main thread
 	if (!Common::isMainThread()) {
@@ -660,7 +728,16 @@ bool GraphicsManager::unproject(float x, float y,
 	return true;
 }
 
+bool GraphicsManager::isUpdateThread() const {
+	// Other jobs on the shared pool still need to lock the frame like any other thread
+	return SDL_TLSGet(_updateThread) != 0;
+}
+
 void GraphicsManager::lockFrame() {
+	// The update threads only ever run while the main thread holds the frame
+	if (isUpdateThread())
+		return;
+
 	uint32 lock = _frameLock.fetch_add(1, boost::memory_order_acquire);
 	if (Common::isMainThread() || EventMan.quitRequested() || (lock > 0))
 		return;
@@ -670,6 +747,9 @@ void GraphicsManager::lockFrame() {
 }
 
 void GraphicsManager::unlockFrame() {
+	if (isUpdateThread())
+		return;
+
 	uint32 lock = _frameLock.fetch_sub(1, boost::memory_order_release);
 
 	assert(lock != 0);
@@ -679,8 +759,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	// World objects
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
 
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	for (QueueManager::Queue::const_iterator o = objects.begin(); o != objects.end(); ++o)
 		static_cast<Renderable *>(*o)->calculateDistance();
 
 	QueueMan.sortQueue(kQueueVisibleWorldObject);
@@ -689,8 +769,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	// GUI front objects
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
 
-	const std::list<Queueable *> &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
-	for (std::list<Queueable *>::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
+	const QueueManager::Queue &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	for (QueueManager::Queue::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
 		static_cast<Renderable *>(*g)->calculateDistance();
 
 	QueueMan.sortQueue(kQueueVisibleGUIFrontObject);
@@ -699,8 +779,8 @@ void GraphicsManager::recalculateObjectDistances() {
 	// GUI back objects
 	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
 
-	const std::list<Queueable *> &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
-	for (std::list<Queueable *>::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
+	const QueueManager::Queue &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
+	for (QueueManager::Queue::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
 		static_cast<Renderable *>(*g)->calculateDistance();
 
 	QueueMan.sortQueue(kQueueVisibleGUIBackObject);
@@ -765,10 +845,10 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 	Renderable *object = 0;
 
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	const QueueManager::Queue &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
 
 	// Go through the GUI elements, from nearest to furthest
-	for (std::list<Queueable *>::const_iterator g = gui.begin(); g != gui.end(); ++g) {
+	for (QueueManager::Queue::const_iterator g = gui.begin(); g != gui.end(); ++g) {
 		Renderable &r = static_cast<Renderable &>(**g);
 
 		if (!r.isClickable())
@@ -800,9 +880,9 @@ Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
 	Renderable *object = 0;
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
+	for (QueueManager::Queue::const_iterator o = objects.begin(); o != objects.end(); ++o) {
 		Renderable &r = static_cast<Renderable &>(**o);
 
 		if (!r.isClickable())
@@ -834,13 +914,15 @@ Renderable *GraphicsManager::getObjectAt(float x, float y) {
 
 void GraphicsManager::buildNewTextures() {
 	QueueMan.lockQueue(kQueueNewTexture);
-	const std::list<Queueable *> &text = QueueMan.getQueue(kQueueNewTexture);
+	const QueueManager::Queue &text = QueueMan.getQueue(kQueueNewTexture);
 	if (text.empty()) {
 		QueueMan.unlockQueue(kQueueNewTexture);
 		return;
 	}
 
-	for (std::list<Queueable *>::const_iterator t = text.begin(); t != text.end(); ++t)
+	Common::ProfileZone profile("buildNewTextures");
+
+	for (QueueManager::Queue::const_iterator t = text.begin(); t != text.end(); ++t)
 		static_cast<GLContainer *>(*t)->rebuild();
 
 	QueueMan.clearQueue(kQueueNewTexture);
@@ -871,9 +953,9 @@ bool GraphicsManager::playVideo() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleVideo);
-	const std::list<Queueable *> &videos = QueueMan.getQueue(kQueueVisibleVideo);
+	const QueueManager::Queue &videos = QueueMan.getQueue(kQueueVisibleVideo);
 
-	for (std::list<Queueable *>::const_iterator v = videos.begin(); v != videos.end(); ++v) {
+	for (QueueManager::Queue::const_iterator v = videos.begin(); v != videos.end(); ++v) {
 		glPushMatrix();
 		static_cast<Renderable *>(*v)->render(kRenderPassAll);
 		glPopMatrix();
@@ -883,9 +965,85 @@ bool GraphicsManager::playVideo() {
 	return true;
 }
 
-bool GraphicsManager::renderWorld() {
+void GraphicsManager::advanceWorldTime() {
 	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
+		return;
+
+	const uint64 startTime = SDL_GetPerformanceCounter();
+
+	QueueMan.lockQueue(kQueueVisibleWorldObject);
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+
+	// Get the current time
+	uint32 now = EventMan.getTimestamp();
+	if (_lastSampled == 0)
+		_lastSampled = now;
+
+	// Calc elapsed time
+	float elapsedTime = (now - _lastSampled) / 1000.0f;
+	_lastSampled = now;
+
+	// If game paused, skip the advanceTime loop below
+
+	_updateObjects.clear();
+	for (QueueManager::Queue::const_reverse_iterator o = objects.rbegin();
+	     o != objects.rend(); ++o)
+		_updateObjects.push_back(static_cast<Renderable *>(*o));
+
+	const size_t objectCount = _updateObjects.size();
+
+	// Split the objects into contiguous ranges, one per job
+	size_t jobCount = MAX<size_t>(MIN<size_t>(objectCount / kMinObjectsPerUpdateJob,
+	                                          ThreadPoolMan.getThreadCount() + 1), 1);
+
+	if (jobCount <= 1) {
+		// Not worth the synchronization overhead: advance the objects right here
+
+		for (size_t i = 0; i < objectCount; i++)
+			_updateObjects[i]->advanceTime(elapsedTime);
+
+	} else {
+		// Each object is touched by exactly one job, and the main thread helps
+		// working through the jobs while waiting for them to finish
+
+		while (_updateJobs.size() < jobCount)
+			_updateJobs.push_back(new AdvanceTimeJob(_updateThread));
+
+		const size_t objectsPerJob = (objectCount + jobCount - 1) / jobCount;
+
+		Common::JobGroup group;
+
+		size_t jobsQueued = 0;
+		for (size_t start = 0; start < objectCount; start += objectsPerJob, jobsQueued++) {
+			const size_t count = MIN(objectsPerJob, objectCount - start);
+
+			_updateJobs[jobsQueued]->set(&_updateObjects[start], count, elapsedTime);
+			ThreadPoolMan.addJob(*_updateJobs[jobsQueued], group);
+		}
+
+		ThreadPoolMan.wait(group);
+
+		jobCount = jobsQueued;
+	}
+
+	QueueMan.unlockQueue(kQueueVisibleWorldObject);
+
+	const float time = ((SDL_GetPerformanceCounter() - startTime) * 1000.0f) / SDL_GetPerformanceFrequency();
+
+	Common::StackLock lock(_statisticsMutex);
+
+	_updateStatistics.objectCount = objectCount;
+	_updateStatistics.jobCount    = jobCount;
+	_updateStatistics.time        = time;
+}
+
+bool GraphicsManager::renderWorld() {
+	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject)) {
+		Common::StackLock lock(_statisticsMutex);
+
+		_renderStatistics.worldObjectCount = 0;
 		return false;
+	}
 
 	float cPos[3];
 	float cOrient[3];
@@ -916,38 +1074,19 @@ bool GraphicsManager::renderWorld() {
 	_modelview.translate(-cPos[0], -cPos[1], -cPos[2]);
 
 	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const QueueManager::Queue &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
-	// Get the current time
-	uint32 now = EventMan.getTimestamp();
-	if (_lastSampled == 0)
-		_lastSampled = now;
-
-	// Calc elapsed time
-	float elapsedTime = (now - _lastSampled) / 1000.0f;
-	_lastSampled = now;
-
-	// If game paused, skip the advanceTime loop below
-
-	// Advance time for animation queues
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
-		static_cast<Renderable *>(*o)->advanceTime(elapsedTime);
-	}
-
-	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
-
+	// Draw opaque objects, front to back, so that hidden fragments fail the depth test early
+	for (QueueManager::Queue::const_iterator o = objects.begin(); o != objects.end(); ++o) {
 		glPushMatrix();
 		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
-	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	// Draw transparent objects, back to front
+	for (QueueManager::Queue::const_reverse_iterator o = objects.rbegin();
 	     o != objects.rend(); ++o) {
 
 		glPushMatrix();
@@ -955,6 +1094,12 @@ bool GraphicsManager::renderWorld() {
 		glPopMatrix();
 	}
 
+	{
+		Common::StackLock lock(_statisticsMutex);
+
+		_renderStatistics.worldObjectCount = objects.size();
+	}
+
 	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 	return true;
 }
@@ -973,11 +1118,11 @@ bool GraphicsManager::renderGUIFront() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	const QueueManager::Queue &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
 
 	buildNewTextures();
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator g = gui.rbegin();
 	     g != gui.rend(); ++g) {
 
 		glPushMatrix();
@@ -1006,11 +1151,11 @@ bool GraphicsManager::renderGUIBack() {
 	glLoadIdentity();
 
 	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIBackObject);
+	const QueueManager::Queue &gui = QueueMan.getQueue(kQueueVisibleGUIBackObject);
 
 	buildNewTextures();
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
+	for (QueueManager::Queue::const_reverse_iterator g = gui.rbegin();
 	     g != gui.rend(); ++g) {
 
 		glPushMatrix();
@@ -1046,7 +1191,10 @@ bool GraphicsManager::renderCursor() {
 }
 
 void GraphicsManager::endScene() {
-	WindowMan.endScene();
+	{
+		Common::ProfileZone profile("swapBuffers");
+		WindowMan.endScene();
+	}
 
 	if (_takeScreenshot) {
 		Graphics::takeScreenshot();
@@ -1055,6 +1203,19 @@ void GraphicsManager::endScene() {
 
 	_fpsCounter->finishedFrame();
 
+	const QueueManager::SortStatistics sortStatistics = QueueMan.getSortStatistics();
+	QueueMan.resetSortStatistics();
+
+	{
+		Common::StackLock lock(_statisticsMutex);
+
+		_renderStatistics.sortCount     = sortStatistics.sortCount;
+		_renderStatistics.sortedObjects = sortStatistics.objectCount;
+		_renderStatistics.sortTime      = sortStatistics.time;
+	}
+
+	FrameProf.endFrame();
+
 	if (_fsaa > 0)
 		glDisable(GL_MULTISAMPLE_ARB);
 }
@@ -1062,7 +1223,10 @@ void GraphicsManager::endScene() {
 void GraphicsManager::renderScene() {
 	Common::enforceMainThread();
 
-	cleanupAbandoned();
+	{
+		Common::ProfileZone profile("cleanupAbandoned");
+		cleanupAbandoned();
+	}
 
 	if (EventMan.quitRequested() || (_frameLock.load(boost::memory_order_acquire) > 0)) {
 		_frameEndSignal.store(true, boost::memory_order_release);
@@ -1077,10 +1241,27 @@ void GraphicsManager::renderScene() {
 		return;
 	}
 
-	renderGUIBack();
-	renderWorld();
-	renderGUIFront();
-	renderCursor();
+	{
+		Common::ProfileZone profile("advanceTime");
+		advanceWorldTime();
+	}
+
+	{
+		Common::ProfileZone profile("renderGUIBack");
+		renderGUIBack();
+	}
+	{
+		Common::ProfileZone profile("renderWorld");
+		renderWorld();
+	}
+	{
+		Common::ProfileZone profile("renderGUIFront");
+		renderGUIFront();
+	}
+	{
+		Common::ProfileZone profile("renderCursor");
+		renderCursor();
+	}
 
 	endScene();
 
@@ -1118,8 +1299,8 @@ bool GraphicsManager::isGL3() const {
 void GraphicsManager::rebuildGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
+	const QueueManager::Queue &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (QueueManager::Queue::const_iterator c = cont.begin(); c != cont.end(); ++c)
 		static_cast<GLContainer *>(*c)->rebuild();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
@@ -1128,8 +1309,8 @@ void GraphicsManager::rebuildGLContainers() {
 void GraphicsManager::destroyGLContainers() {
 	QueueMan.lockQueue(kQueueGLContainer);
 
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
+	const QueueManager::Queue &cont = QueueMan.getQueue(kQueueGLContainer);
+	for (QueueManager::Queue::const_iterator c = cont.begin(); c != cont.end(); ++c)
 		static_cast<GLContainer *>(*c)->destroy();
 
 	QueueMan.unlockQueue(kQueueGLContainer);
@@ -30,8 +30,11 @@
 #include <vector>
 #include <list>
 
+#include <SDL_thread.h>
+
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
 #include "src/common/matrix4x4.h"
@@ -52,6 +55,25 @@ class Renderable;
 /** The graphics manager. */
 class GraphicsManager : public Common::Singleton<GraphicsManager>, public Events::Notifyable {
 public:
+	/** Statistics about advancing the time of all world objects in one frame. */
+	struct UpdateStatistics {
+		size_t objectCount; ///< Number of world objects that were advanced.
+		size_t jobCount;    ///< Number of jobs the objects were split into.
+		float  time;        ///< Time the update took, in milliseconds.
+
+		UpdateStatistics();
+	};
+
+	/** Statistics about one rendered frame. */
+	struct RenderStatistics {
+		size_t worldObjectCount; ///< Number of visible world objects.
+		size_t sortCount;        ///< Number of render queue sorts.
+		size_t sortedObjects;    ///< Number of objects sorted, over all sorts.
+		float  sortTime;         ///< Time spent sorting render queues, in milliseconds.
+
+		RenderStatistics();
+	};
+
 	GraphicsManager();
 	~GraphicsManager();
 
@@ -82,6 +104,11 @@ public:
 	/** How many frames per second to we render at the moments? */
 	uint32 getFPS() const;
 
+	/** Return statistics about the last frame's world object update. */
+	UpdateStatistics getUpdateStatistics() const;
+	/** Return statistics about the last rendered frame. */
+	RenderStatistics getRenderStatistics() const;
+
 	/** Enable/Disable face culling. */
 	void setCullFace(bool enabled, GLenum mode = GL_BACK);
 
@@ -146,6 +173,8 @@ private:
 		kProjectTypeOrthogonal
 	};
 
+	class AdvanceTimeJob;
+
 	bool _ready; ///< Was the graphics subsystem successfully initialized?
 
 	bool _debugGL; ///< Should we create an OpenGL debug context?
@@ -172,6 +201,17 @@ private:
 
 	uint32 _lastSampled; ///< Timestamp used to advance animations.
 
+	std::vector<Renderable *> _updateObjects;   ///< World objects to advance this frame.
+	Common::PtrVector<AdvanceTimeJob> _updateJobs; ///< Jobs advancing the world objects.
+
+	SDL_TLSID _updateThread; ///< Set for a thread while it's running one of the update jobs.
+
+	UpdateStatistics _updateStatistics; ///< Statistics of the last world object update.
+	RenderStatistics _renderStatistics; ///< Statistics of the last rendered frame.
+
+	/** Protects the statistics, which are read by other threads. */
+	mutable Common::Mutex _statisticsMutex;
+
 	Common::Matrix4x4 _projection;    ///< Our projection matrix.
 	Common::Matrix4x4 _projectionInv; ///< The inverse of our projection matrix.
 	Common::Matrix4x4 _modelview;     ///< Our base modelview matrix (i.e camera view).
@@ -217,8 +257,12 @@ private:
 
 	void buildNewTextures();
 
+	/** Is the calling thread currently running one of the world update jobs? */
+	bool isUpdateThread() const;
+
 	void beginScene();
 	bool playVideo();
+	void advanceWorldTime();
 	bool renderWorld();
 	bool renderGUIFront();
 	bool renderGUIBack();
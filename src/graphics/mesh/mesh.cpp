@@ -22,6 +22,8 @@
  *  Generic mesh handling class.
  */
 
+#include <cassert>
+
 #include "src/graphics/mesh/mesh.h"
 
 namespace Graphics {
@@ -182,6 +184,16 @@ void Mesh::render() {
 	}
 }
 
+void Mesh::renderInstanced(uint32 count) {
+	assert(GfxMan.isGL3());
+
+	if (_indexBuffer.getCount()) {
+		glDrawElementsInstanced(_type, _indexBuffer.getCount(), _indexBuffer.getType(), 0, count);
+	} else {
+		glDrawArraysInstanced(_type, 0, _vertexBuffer.getCount(), count);
+	}
+}
+
 void Mesh::renderUnbind() {
 	if (GfxMan.isGL3()) {
 		// So long as each mesh rebinds what it needs, there's actually no need to bind 0 here.
@@ -66,6 +66,9 @@ public:
 	void render();
 	void renderUnbind();
 
+	/** Render several instances of the mesh at once. GL3.x only, and needs to be bound first. */
+	void renderInstanced(uint32 count);
+
 	void useIncrement();
 	void useDecrement();
 	uint32 useCount() const;
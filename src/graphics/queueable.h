@@ -25,7 +25,7 @@
 #ifndef GRAPHICS_QUEUEABLE_H
 #define GRAPHICS_QUEUEABLE_H
 
-#include <list>
+#include "src/common/types.h"
 
 #include "src/graphics/types.h"
 
@@ -36,7 +36,8 @@ public:
 	Queueable();
 	virtual ~Queueable();
 
-	virtual bool operator<(const Queueable &q) const;
+	/** Return the key queues are sorted by, lowest first. */
+	virtual uint64 getSortKey() const;
 
 protected:
 	bool isInQueue(QueueType queue) const {
@@ -52,7 +53,7 @@ protected:
 
 private:
 	bool _isInQueue[kQueueMAX];
-	std::list<Queueable *>::iterator _queueRef[kQueueMAX];
+	size_t _queueIndex[kQueueMAX]; ///< Our position within each queue we're in.
 
 	void removeFromAll();
 	void kickedOut(QueueType queue);
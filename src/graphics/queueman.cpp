@@ -22,6 +22,10 @@
  *  The graphics queue manager.
  */
 
+#include <cassert>
+
+#include <SDL_timer.h>
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/queueable.h"
 
@@ -29,12 +33,15 @@ DECLARE_SINGLETON(Graphics::QueueManager)
 
 namespace Graphics {
 
-static bool queueComp(Queueable *a, Queueable *b) {
-	return *a < *b;
+QueueManager::SortStatistics::SortStatistics() : sortCount(0), objectCount(0), time(0.0f) {
 }
 
 
 QueueManager::QueueManager() {
+	for (int i = 0; i < kQueueMAX; i++) {
+		_sorted    [i] = false;
+		_disordered[i] = false;
+	}
 }
 
 QueueManager::~QueueManager() {
@@ -55,35 +62,88 @@ bool QueueManager::isQueueEmpty(QueueType queue) {
 	return _queue[queue].empty();
 }
 
-const std::list<Queueable *> &QueueManager::getQueue(QueueType queue) const {
+const QueueManager::Queue &QueueManager::getQueue(QueueType queue) {
+	if (_disordered[queue])
+		sortQueue(queue);
+
 	return _queue[queue];
 }
 
 void QueueManager::sortQueue(QueueType queue) {
 	lockQueue(queue);
 
-	_queue[queue].sort(queueComp);
+	_sorted    [queue] = true;
+	_disordered[queue] = false;
+
+	Queue &q = _queue[queue];
+	if (q.size() < 2) {
+		unlockQueue(queue);
+		return;
+	}
+
+	const uint64 startTime = SDL_GetPerformanceCounter();
+
+	_sortMutex.lock();
+
+	std::vector<Common::SortKey> &keys = _sortKeys[0];
+
+	keys.resize(q.size());
+	for (size_t i = 0; i < q.size(); i++)
+		keys[i] = Common::SortKey(q[i]->getSortKey(), i);
+
+	Common::radixSort(keys, _sortKeys[1]);
+
+	// Reorder the queue and update the objects' positions within it
+	_sortScratch.resize(q.size());
+	for (size_t i = 0; i < keys.size(); i++) {
+		_sortScratch[i] = q[keys[i].index];
+		_sortScratch[i]->_queueIndex[queue] = i;
+	}
+
+	q.swap(_sortScratch);
+
+	_sortMutex.unlock();
+
+	const float time = ((SDL_GetPerformanceCounter() - startTime) * 1000.0f) / SDL_GetPerformanceFrequency();
+
+	_statisticsMutex.lock();
+
+	_sortStatistics.sortCount++;
+	_sortStatistics.objectCount += q.size();
+	_sortStatistics.time        += time;
+
+	_statisticsMutex.unlock();
 
 	unlockQueue(queue);
 }
 
-std::list<Queueable *>::iterator QueueManager::addToQueue(QueueType queue, Queueable &q) {
+size_t QueueManager::addToQueue(QueueType queue, Queueable &q) {
 	lockQueue(queue);
 
 	_queue[queue].push_back(&q);
-	std::list<Queueable *>::iterator ref = --_queue[queue].end();
+	const size_t index = _queue[queue].size() - 1;
 
 	unlockQueue(queue);
 
-	return ref;
+	return index;
 }
 
-void QueueManager::removeFromQueue(QueueType queue,
-		const std::list<Queueable *>::iterator &ref) {
-
+void QueueManager::removeFromQueue(QueueType queue, size_t index) {
 	lockQueue(queue);
 
-	_queue[queue].erase(ref);
+	Queue &q = _queue[queue];
+	assert((index < q.size()) && (q[index]->_queueIndex[queue] == index));
+
+	// Move the last object into the hole. This breaks the order of a sorted
+	// queue, so it is sorted again the next time someone looks at it
+	if (index != (q.size() - 1)) {
+		q[index] = q.back();
+		q[index]->_queueIndex[queue] = index;
+
+		_disordered[queue] = _sorted[queue];
+	}
+
+	q.pop_back();
 
 	unlockQueue(queue);
 }
@@ -91,11 +151,11 @@ void QueueManager::removeFromQueue(QueueType queue,
 void QueueManager::clearQueue(QueueType queue) {
 	lockQueue(queue);
 
-	for (std::list<Queueable *>::iterator q = _queue[queue].begin();
-	     q != _queue[queue].end(); ++q)
+	for (Queue::iterator q = _queue[queue].begin(); q != _queue[queue].end(); ++q)
 		(*q)->kickedOut(queue);
 
 	_queue[queue].clear();
+	_disordered[queue] = false;
 
 	unlockQueue(queue);
 }
@@ -105,4 +165,16 @@ void QueueManager::clearAllQueues() {
 		clearQueue((QueueType) i);
 }
 
+QueueManager::SortStatistics QueueManager::getSortStatistics() const {
+	Common::StackLock lock(_statisticsMutex);
+
+	return _sortStatistics;
+}
+
+void QueueManager::resetSortStatistics() {
+	Common::StackLock lock(_statisticsMutex);
+
+	_sortStatistics = SortStatistics();
+}
+
 } // End of namespace Graphics
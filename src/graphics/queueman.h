@@ -25,11 +25,12 @@
 #ifndef GRAPHICS_QUEUEMAN_H
 #define GRAPHICS_QUEUEMAN_H
 
-#include <list>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
+#include "src/common/radixsort.h"
 
 #include "src/graphics/types.h"
 
@@ -40,6 +41,17 @@ class Queueable;
 /** The graphics queue manager. */
 class QueueManager : public Common::Singleton<QueueManager> {
 public:
+	typedef std::vector<Queueable *> Queue;
+
+	/** Statistics about the queue sorts done since the last reset. */
+	struct SortStatistics {
+		size_t sortCount;   ///< Number of queue sorts.
+		size_t objectCount; ///< Number of objects sorted, over all sorts.
+		float  time;        ///< Time spent sorting, in milliseconds.
+
+		SortStatistics();
+	};
+
 	QueueManager();
 	~QueueManager();
 
@@ -48,19 +60,45 @@ public:
 	void lockQueue(QueueType queue);
 	void unlockQueue(QueueType queue);
 
-	const std::list<Queueable *> &getQueue(QueueType queue) const;
-
+	/** Return a queue, which needs to be locked.
+	 *
+	 *  If objects were removed from a sorted queue, it is sorted again first.
+	 */
+	const Queue &getQueue(QueueType queue);
+
+	/** Sort the queue by the objects' sort keys, lowest first.
+	 *
+	 *  The sort is stable, so objects with the same key stay in the order
+	 *  they were added in.
+	 */
 	void sortQueue(QueueType queue);
 	void clearQueue(QueueType queue);
 
 	void clearAllQueues();
 
+	SortStatistics getSortStatistics() const;
+	void resetSortStatistics();
+
 private:
 	Common::Mutex _queueMutex[kQueueMAX];
-	std::list<Queueable *> _queue[kQueueMAX];
+	Queue _queue[kQueueMAX];
+
+	bool _sorted[kQueueMAX];     ///< Has the queue ever been sorted?
+	bool _disordered[kQueueMAX]; ///< Did a removal move objects out of sort order?
+
+	/** Protects the sort buffers, which are shared between all queues. */
+	Common::Mutex _sortMutex;
+
+	/** Sort keys and scratch space, reused between sorts. */
+	std::vector<Common::SortKey> _sortKeys[2];
+	/** Scratch space for reordering a queue after a sort. */
+	Queue _sortScratch;
+
+	mutable Common::Mutex _statisticsMutex;
+	SortStatistics _sortStatistics;
 
-	std::list<Queueable *>::iterator addToQueue(QueueType queue, Queueable &q);
-	void removeFromQueue(QueueType queue, const std::list<Queueable *>::iterator &ref);
+	size_t addToQueue(QueueType queue, Queueable &q);
+	void removeFromQueue(QueueType queue, size_t index);
 
 	friend class Queueable;
 };
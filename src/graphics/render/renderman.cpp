@@ -62,6 +62,24 @@ void RenderManager::clear() {
 	_queueColorTransparent.clear();
 }
 
+RenderQueue::Statistics RenderManager::getStatistics() const {
+	const RenderQueue::Statistics &solid       = _queueColorSolid.getStatistics();
+	const RenderQueue::Statistics &transparent = _queueColorTransparent.getStatistics();
+
+	RenderQueue::Statistics statistics;
+
+	statistics.nodeCount       = solid.nodeCount       + transparent.nodeCount;
+	statistics.drawCalls       = solid.drawCalls       + transparent.drawCalls;
+	statistics.instancedCalls  = solid.instancedCalls  + transparent.instancedCalls;
+	statistics.instances       = solid.instances       + transparent.instances;
+	statistics.programChanges  = solid.programChanges  + transparent.programChanges;
+	statistics.materialChanges = solid.materialChanges + transparent.materialChanges;
+	statistics.meshChanges     = solid.meshChanges     + transparent.meshChanges;
+	statistics.sortTime        = solid.sortTime        + transparent.sortTime;
+
+	return statistics;
+}
+
 } // namespace Render
 
 } // namespace Graphics
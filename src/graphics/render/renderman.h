@@ -46,6 +46,9 @@ public:
 
 	void clear();
 
+	/** Return the statistics of the solid and the transparent queue, combined. */
+	RenderQueue::Statistics getStatistics() const;
+
 private:
 	RenderQueue _queueColorSolid;
 	RenderQueue _queueColorTransparent;
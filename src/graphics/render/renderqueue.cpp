@@ -23,43 +23,55 @@
  */
 
 #include <cassert>
+#include <cstring>
+
+#include <SDL_timer.h>
 
 #include "src/graphics/render/renderqueue.h"
+#include "src/graphics/shader/shader.h"
 #include "src/common/util.h"
 
-#include <algorithm>
-
 namespace Graphics {
 
 namespace Render {
 
-bool compareShader(const RenderQueue::RenderQueueNode &a, const RenderQueue::RenderQueueNode &b)
-{
-	if (a.program < b.program)
-		return false;
-	else if (a.program > b.program)
-		return true;
-	if (a.material < b.material)  // node_program values are equal.
-		return false;
-	else if (a.material > b.material)
-		return true;
-	else  // node material values are equal, compare mesh values next.
-		return (a.mesh <= b.mesh ? false : true);
-	// No, surfaces are not compared here.
+/** Fold a pointer into a 16-bit value, for grouping equal pointers in a sort key. */
+static uint64 pointerKey(const void *ptr) {
+	const uint64 p = (uint64) (uintptr_t) ptr;
+
+	// Allocations are aligned, so the lowest bits carry no information
+	return ((p >> 4) ^ (p >> 20) ^ (p >> 36)) & 0xFFFF;
 }
 
-bool compareDepth(const RenderQueue::RenderQueueNode &a, const RenderQueue::RenderQueueNode &b) {
-	return (a.reference <= b.reference);
-	//return (a.reference.lengthSquared() <= b.reference.lengthSquared());
+/** Quantize a (positive) depth value into 16 bits, keeping its ordering. */
+static uint64 depthKey(float depth) {
+	return Common::floatToSortKey(depth) >> 16;
+}
+
+
+/** Runs of identical nodes at least this long are drawn with one instanced call. */
+static const size_t kMinInstanceCount = 2;
+
+/** Number of floats in one per-instance transform. */
+static const size_t kInstanceSize = 16;
+
+
+RenderQueue::Statistics::Statistics() : nodeCount(0), drawCalls(0), instancedCalls(0), instances(0),
+	programChanges(0), materialChanges(0), meshChanges(0), sortTime(0.0f) {
+
 }
 
-RenderQueue::RenderQueue(uint32 precache) : _nodeArray(precache) {
-//	_nodeArray.reserve(1000);
+
+RenderQueue::RenderQueue(uint32 precache) : _instanceBuffer(0) {
+	_nodeArray.reserve(precache);
 }
 
 RenderQueue::~RenderQueue()
 {
 	_nodeArray.clear();
+
+	if (_instanceBuffer)
+		glDeleteBuffers(1, &_instanceBuffer);
 }
 
 void RenderQueue::setCameraReference(const Common::Vector3 &reference) {
@@ -81,70 +93,146 @@ void RenderQueue::queueItem(Shader::ShaderRenderable *renderable, const Common::
 }
 
 void RenderQueue::sortShader() {
-	std::sort(_nodeArray.begin(), _nodeArray.end(), compareShader);
+	const uint64 startTime = SDL_GetPerformanceCounter();
+
+	/* Program, material and mesh, to minimize state changes. Within the
+	 * same state, nearer nodes go first, so that hidden fragments of the
+	 * nodes behind them are rejected by the depth test early. */
+
+	_sortKeys[0].resize(_nodeArray.size());
+	for (size_t i = 0; i < _nodeArray.size(); i++) {
+		const RenderQueueNode &node = _nodeArray[i];
+
+		const uint64 program = node.program ? (node.program->glid & 0xFFFF) : 0;
+
+		_sortKeys[0][i] = Common::SortKey((program                  << 48) |
+		                                  (pointerKey(node.material) << 32) |
+		                                  (pointerKey(node.mesh)     << 16) |
+		                                   depthKey(node.reference), i);
+	}
+
+	sortKeys();
+
+	_statistics.sortTime = ((SDL_GetPerformanceCounter() - startTime) * 1000.0f) / SDL_GetPerformanceFrequency();
 }
 
 void RenderQueue::sortDepth() {
-	std::sort(_nodeArray.begin(), _nodeArray.end(), compareDepth);
+	const uint64 startTime = SDL_GetPerformanceCounter();
+
+	/* Farthest nodes first, so that blending works. Nodes at the same
+	 * depth are grouped by program and material. */
+
+	_sortKeys[0].resize(_nodeArray.size());
+	for (size_t i = 0; i < _nodeArray.size(); i++) {
+		const RenderQueueNode &node = _nodeArray[i];
+
+		const uint64 depth   = ~Common::floatToSortKey(node.reference);
+		const uint64 program = node.program ? (node.program->glid & 0xFFFF) : 0;
+
+		_sortKeys[0][i] = Common::SortKey(((depth & 0xFFFFFFFF) << 32) | (program << 16) |
+		                                  pointerKey(node.material), i);
+	}
+
+	sortKeys();
+
+	_statistics.sortTime = ((SDL_GetPerformanceCounter() - startTime) * 1000.0f) / SDL_GetPerformanceFrequency();
+}
+
+void RenderQueue::sortKeys() {
+	Common::radixSort(_sortKeys[0], _sortKeys[1]);
+
+	_sortNodes.resize(_nodeArray.size());
+	for (size_t i = 0; i < _sortKeys[0].size(); i++)
+		_sortNodes[i] = _nodeArray[_sortKeys[0][i].index];
+
+	_nodeArray.swap(_sortNodes);
 }
 
 void RenderQueue::render() {
+	_statistics.nodeCount       = _nodeArray.size();
+	_statistics.drawCalls       = 0;
+	_statistics.instancedCalls  = 0;
+	_statistics.instances       = 0;
+	_statistics.programChanges  = 0;
+	_statistics.materialChanges = 0;
+	_statistics.meshChanges     = 0;
+
 	if (_nodeArray.size() == 0) {
 		return;
 	}
 
+	const bool canInstance = GfxMan.isGL3();
+
 	Shader::ShaderProgram *currentProgram = 0;
 	Shader::ShaderMaterial *currentMaterial = 0;
-	Shader::ShaderSurface *currentSurface = 0;
-	Mesh::Mesh *currentMesh = 0;
 
-	uint32 i = 0;
-	uint32 limit = _nodeArray.size();
+	size_t i = 0;
+	const size_t limit = _nodeArray.size();
 	while (i < limit) {
-		assert(_nodeArray[i].program);
-		if (currentProgram != _nodeArray[i].program) {
-			currentProgram = _nodeArray[i].program;
+		const RenderQueueNode &node = _nodeArray[i];
+
+		assert(node.program);
+		assert(node.material);
+		assert(node.surface);
+		assert(node.mesh);
+
+		// Find the run of nodes that only differ in their object modelview transform.
+		size_t end = i + 1;
+		while ((end < limit) && (_nodeArray[end].program == node.program) && (_nodeArray[end].mesh == node.mesh) &&
+		       (_nodeArray[end].material == node.material) && (_nodeArray[end].surface == node.surface))
+			++end;
+
+		Shader::ShaderProgram *instancedProgram = 0;
+		if (canInstance && ((end - i) >= kMinInstanceCount))
+			instancedProgram = ShaderMan.getInstancedProgram(node.program);
+
+		Shader::ShaderProgram *program = instancedProgram ? instancedProgram : node.program;
+		if (currentProgram != program) {
+			currentProgram = program;
 			glUseProgram(currentProgram->glid);
+			_statistics.programChanges++;
 
 			if (currentMaterial != 0) {
 				currentMaterial->unbindGLState();
 			}
 			currentMaterial = 0;
-			currentSurface = 0;
 		}
 
-		assert(_nodeArray[i].material);
-		if (currentMaterial != _nodeArray[i].material) {
+		if (currentMaterial != node.material) {
 			if (currentMaterial != 0) {
 				currentMaterial->unbindGLState();
 			}
-			currentMaterial = _nodeArray[i].material;
+			currentMaterial = node.material;
 			currentMaterial->bindProgram(currentProgram);
 			currentMaterial->bindGLState();
+			_statistics.materialChanges++;
 		}
 
-		assert(_nodeArray[i].surface);
-		assert(_nodeArray[i].mesh);
-
-		currentSurface = _nodeArray[i].surface;
-		currentMesh = _nodeArray[i].mesh;
-		currentMesh->renderBind();  // Binds VAO ready for rendering.
-
-		// There's at least one mesh to be rendering here.
-		assert(_nodeArray[i].transform);
-		currentSurface->bindProgram(currentProgram, _nodeArray[i].transform);
-		currentMesh->render();
-
-		++i;  // Move to next object.
-		while ((i < limit) && (_nodeArray[i].mesh == currentMesh) && (_nodeArray[i].material == currentMaterial) && (_nodeArray[i].surface == currentSurface)) {
-			// Next object is basically the same, but will have a different object modelview transform. So rebind that, and render again.
-			assert(_nodeArray[i].transform);
-			currentSurface->bindObjectModelview(currentProgram, _nodeArray[i].transform);
-			currentMesh->render();
-			++i;
+		node.mesh->renderBind();  // Binds VAO ready for rendering.
+		_statistics.meshChanges++;
+
+		if (instancedProgram) {
+			renderInstanced(instancedProgram, i, end);
+		} else {
+			assert(node.transform);
+			node.surface->bindProgram(currentProgram, node.transform);
+			node.mesh->render();
+
+			for (size_t j = i + 1; j < end; j++) {
+				// Next object is basically the same, but will have a different object modelview transform. So rebind that, and render again.
+				assert(_nodeArray[j].transform);
+				node.surface->bindObjectModelview(currentProgram, _nodeArray[j].transform);
+				node.mesh->render();
+			}
+
+			_statistics.drawCalls += end - i;
+			_statistics.instances += end - i;
 		}
+
 		// Done rendering, unbind the mesh, and onwards into the queue.
-		currentMesh->renderUnbind();
+		node.mesh->renderUnbind();
+
+		i = end;
 	}
 
 	// Restore OpenGL state on exit.
@@ -154,10 +242,60 @@ void RenderQueue::render() {
 	glDepthMask(GL_TRUE);
 }
 
+void RenderQueue::renderInstanced(Shader::ShaderProgram *program, size_t start, size_t end) {
+	const RenderQueueNode &node = _nodeArray[start];
+	const size_t count = end - start;
+
+	// Uniforms other than the object modelview matrix are shared by all instances.
+	node.surface->bindProgram(program, node.transform);
+
+	_instanceData.resize(count * kInstanceSize);
+	for (size_t i = 0; i < count; i++) {
+		assert(_nodeArray[start + i].transform);
+		memcpy(&_instanceData[i * kInstanceSize], _nodeArray[start + i].transform->get(), kInstanceSize * sizeof(float));
+	}
+
+	if (!_instanceBuffer)
+		glGenBuffers(1, &_instanceBuffer);
+
+	glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, _instanceData.size() * sizeof(float), &_instanceData[0], GL_STREAM_DRAW);
+
+	// A mat4 attribute takes up four consecutive locations, one per column.
+	for (GLuint c = 0; c < 4; c++) {
+		const GLuint location = Shader::VERTEX_INSTANCE_A + c;
+
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, kInstanceSize * sizeof(float),
+		                      reinterpret_cast<void *>(c * 4 * sizeof(float)));
+		glVertexAttribDivisor(location, 1);
+	}
+
+	node.mesh->renderInstanced(count);
+
+	// Leave the mesh's VAO as we found it.
+	for (GLuint c = 0; c < 4; c++) {
+		const GLuint location = Shader::VERTEX_INSTANCE_A + c;
+
+		glVertexAttribDivisor(location, 0);
+		glDisableVertexAttribArray(location);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_statistics.drawCalls++;
+	_statistics.instancedCalls++;
+	_statistics.instances += count;
+}
+
 void RenderQueue::clear() {
 	_nodeArray.clear();
 }
 
+const RenderQueue::Statistics &RenderQueue::getStatistics() const {
+	return _statistics;
+}
+
 } // namespace Render
 
 } // namespace Graphics
@@ -25,11 +25,13 @@
 #ifndef GRAPHICS_RENDER_RENDERQUEUE_H
 #define GRAPHICS_RENDER_RENDERQUEUE_H
 
+#include <vector>
+
+#include "src/common/radixsort.h"
+
 #include "src/graphics/graphics.h"
 #include "src/graphics/shader/shaderrenderable.h"
 
-#include <vector>
-
 namespace Graphics {
 
 namespace Render {
@@ -45,12 +47,23 @@ public:
 		float reference;  ///< Reference point to the camera location, primarily used for depth sorting.
 		float padding;    ///< Padding for 64bit architectures.
 
-		RenderQueueNode() : program(0), surface(0), material(0), mesh(0), transform(0), reference(0.0f) {}
-		RenderQueueNode(const RenderQueueNode &src) : program(src.program), surface(src.surface), material(src.material), mesh(src.mesh), transform(src.transform), reference(src.reference) {}
-		RenderQueueNode(Shader::ShaderProgram *prog, Shader::ShaderSurface *sur, Shader::ShaderMaterial *mat, Mesh::Mesh *mes, const Common::Matrix4x4 *t) : program(prog), surface(sur), material(mat), mesh(mes), transform(t), reference(0.0f) {}
-		RenderQueueNode(Shader::ShaderProgram *prog, Shader::ShaderSurface *sur, Shader::ShaderMaterial *mat, Mesh::Mesh *mes, const Common::Matrix4x4 *t, float ref) : program(prog), surface(sur), material(mat), mesh(mes), transform(t), reference(ref) {}
+		RenderQueueNode() : program(0), surface(0), material(0), mesh(0), transform(0), reference(0.0f), padding(0.0f) {}
+		RenderQueueNode(Shader::ShaderProgram *prog, Shader::ShaderSurface *sur, Shader::ShaderMaterial *mat, Mesh::Mesh *mes, const Common::Matrix4x4 *t) : program(prog), surface(sur), material(mat), mesh(mes), transform(t), reference(0.0f), padding(0.0f) {}
+		RenderQueueNode(Shader::ShaderProgram *prog, Shader::ShaderSurface *sur, Shader::ShaderMaterial *mat, Mesh::Mesh *mes, const Common::Matrix4x4 *t, float ref) : program(prog), surface(sur), material(mat), mesh(mes), transform(t), reference(ref), padding(0.0f) {}
+	};
 
-		inline const RenderQueueNode &operator=(const RenderQueueNode &src) { material = src.material; surface = src.surface; mesh = src.mesh; transform = src.transform; reference = src.reference; return *this; }
+	/** Statistics about the last sort and render of this queue. */
+	struct Statistics {
+		size_t nodeCount;       ///< Number of queued nodes.
+		size_t drawCalls;       ///< Number of mesh render calls, instanced or not.
+		size_t instancedCalls;  ///< Number of instanced mesh render calls.
+		size_t instances;       ///< Number of mesh instances drawn, over all calls.
+		size_t programChanges;  ///< Number of shader program binds.
+		size_t materialChanges; ///< Number of material binds.
+		size_t meshChanges;     ///< Number of mesh binds.
+		float  sortTime;        ///< Time spent sorting, in milliseconds.
+
+		Statistics();
 	};
 
 	RenderQueue(uint32 precache = 1000);
@@ -61,17 +74,35 @@ public:
 	void queueItem(Shader::ShaderProgram *program, Shader::ShaderSurface *surface, Shader::ShaderMaterial *material, Mesh::Mesh *mesh, const Common::Matrix4x4 *transform);
 	void queueItem(Shader::ShaderRenderable *renderable, const Common::Matrix4x4 *transform);
 
-	void sortShader(); ///< Sort queue elements by shader program.
-	void sortDepth();  ///< Sort queue elements by depth.
+	/** Sort queue elements by shader program, material and mesh, then front to back. */
+	void sortShader();
+	/** Sort queue elements back to front, then by shader program and material. */
+	void sortDepth();
 
 	void render();  ///< Render all queued items.
 
 	void clear();  ///< Clear the queue of all items.
 
-private:
+	const Statistics &getStatistics() const;
 
-	std::vector<RenderQueueNode>_nodeArray;
+private:
+	std::vector<RenderQueueNode> _nodeArray;
 	Common::Vector3 _cameraReference;
+
+	/** Sort keys, nodes and scratch space, reused between sorts. */
+	std::vector<Common::SortKey> _sortKeys[2];
+	std::vector<RenderQueueNode> _sortNodes;
+
+	Statistics _statistics;
+
+	GLuint _instanceBuffer;            ///< Vertex buffer holding the per-instance transforms.
+	std::vector<float> _instanceData;  ///< Staging area for the per-instance transforms.
+
+	/** Sort the nodes by their sort keys, which are already in _sortKeys[0]. */
+	void sortKeys();
+
+	/** Draw the nodes [start, end), which share program, material, surface and mesh, in one call. */
+	void renderInstanced(Shader::ShaderProgram *program, size_t start, size_t end);
 };
 
 } // namespace Render
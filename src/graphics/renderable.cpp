@@ -24,6 +24,7 @@
 
 #include "src/common/system.h"
 #include "src/common/error.h"
+#include "src/common/radixsort.h"
 
 #include "src/graphics/renderable.h"
 #include "src/graphics/graphics.h"
@@ -67,8 +68,8 @@ Renderable::~Renderable() {
 	removeFromQueue(_queueExists);
 }
 
-bool Renderable::operator<(const Queueable &q) const {
-	return _distance < static_cast<const Renderable &>(q)._distance;
+uint64 Renderable::getSortKey() const {
+	return Common::doubleToSortKey(_distance);
 }
 
 void Renderable::advanceTime(float UNUSED(dt)) {
@@ -42,7 +42,8 @@ public:
 	Renderable(RenderableType type);
 	~Renderable();
 
-	bool operator<(const Queueable &q) const;
+	/** Sort by distance, nearest first. */
+	uint64 getSortKey() const;
 
 	/** Calculate the object's distance. */
 	virtual void calculateDistance() = 0;
@@ -69,6 +69,9 @@ void ShaderManager::init() {
 
 		fObj = getShaderObject("default/color.frag", Graphics::Shader::fragmentColor3xText, SHADER_FRAGMENT);
 		registerShaderProgram(vObj, fObj);
+
+		registerInstancedVariant(vObj, getShaderObject("default/default_instanced.vert",
+		                         Graphics::Shader::vertexDefaultInstanced3xText, SHADER_VERTEX));
 	} else {
 		vObj = getShaderObject("default/default.vert", Graphics::Shader::vertexDefault2xText, SHADER_VERTEX);
 		fObj = getShaderObject("default/default.frag", Graphics::Shader::fragmentDefault2xText, SHADER_FRAGMENT);
@@ -310,6 +313,7 @@ ShaderProgram *ShaderManager::registerShaderProgram(ShaderObject *vertexObject,
 		glBindAttribLocation(glid, (GLuint)(VERTEX_LOCATION), "inPosition");
 		glBindAttribLocation(glid, (GLuint)(VERTEX_TEXCOORD0), "inTexCoord0");
 		glBindAttribLocation(glid, (GLuint)(VERTEX_NORMAL), "inNormal");
+		glBindAttribLocation(glid, (GLuint)(VERTEX_INSTANCE_A), "inInstanceMatrix");
 	}
 
 	glLinkProgram(glid);
@@ -392,6 +396,40 @@ ShaderProgram *ShaderManager::registerShaderProgram(ShaderObject *vertexObject,
 	return program;
 }
 
+void ShaderManager::registerInstancedVariant(ShaderObject *vertexObject, ShaderObject *instancedObject) {
+	if (!vertexObject || !instancedObject)
+		return;
+
+	const std::vector<ShaderObject::ShaderObjectVariable> &vars          = vertexObject->variablesCombined;
+	const std::vector<ShaderObject::ShaderObjectVariable> &instancedVars = instancedObject->variablesCombined;
+
+	bool matches = vars.size() == instancedVars.size();
+	for (size_t i = 0; matches && (i < vars.size()); i++)
+		matches = (vars[i].type == instancedVars[i].type) && (vars[i].name == instancedVars[i].name);
+
+	if (!matches) {
+		warning("Instanced vertex shader variant doesn't match the original shader's uniforms");
+		return;
+	}
+
+	vertexObject->instancedObject = instancedObject;
+}
+
+ShaderProgram *ShaderManager::getInstancedProgram(ShaderProgram *program) {
+	if (!program)
+		return 0;
+
+	if (!program->instancedChecked) {
+		program->instancedChecked = true;
+
+		if (program->vertexObject && program->vertexObject->instancedObject)
+			program->instancedProgram = registerShaderProgram(program->vertexObject->instancedObject,
+			                                                  program->fragmentObject);
+	}
+
+	return program->instancedProgram;
+}
+
 void ShaderManager::genShaderVariableList(ShaderObject *obj, std::vector<ShaderObject::ShaderObjectVariable> &vars) {
 	if (!obj) {
 		return;
@@ -202,6 +202,11 @@ struct ShaderObject {
 	std::vector<ShaderObject::ShaderObjectVariable> variablesSelf;
 	std::vector<ShaderObject::ShaderObjectVariable> variablesCombined;
 	std::vector<ShaderObject *> subObjects;
+
+	/** Vertex shader variant reading the object modelview matrix from the per-instance attributes. */
+	ShaderObject *instancedObject;
+
+	ShaderObject() : usageCount(0), id(0), glid(0), type(SHADER_VERTEX), instancedObject(0) {}
 };
 
 struct ShaderProgram {
@@ -213,6 +218,12 @@ struct ShaderProgram {
 	GLuint glid;
 	uint32 usageCount;
 
+	ShaderProgram *instancedProgram;  // Instanced variant of this program, if any.
+	bool instancedChecked;            // Was instancedProgram already looked up?
+
+	ShaderProgram() : vertexObject(0), fragmentObject(0), id(0), glid(0), usageCount(0),
+	                  instancedProgram(0), instancedChecked(false) {}
+
 	void bindAttribute(ShaderVertexAttrib attrib, const Common::UString &name) {
 		glBindAttribLocation(glid, (GLuint)(attrib), name.c_str());
 	}
@@ -239,6 +250,16 @@ public:
 	ShaderProgram *getShaderProgram(ShaderObject *vertexObject, ShaderObject *fragmentObject);
 	ShaderProgram *registerShaderProgram(ShaderObject *vertexObject, ShaderObject *fragmentObject);
 
+	/** Register a vertex shader variant that takes the object modelview matrix from
+	 *  the per-instance attributes VERTEX_INSTANCE_A to VERTEX_INSTANCE_D.
+	 *
+	 *  The instanced variant has to declare the same uniforms, in the same order, as
+	 *  the original vertex shader, so that surfaces can bind to either of them.
+	 */
+	void registerInstancedVariant(ShaderObject *vertexObject, ShaderObject *instancedObject);
+	/** Return the instanced variant of this program, or 0 if there is none. */
+	ShaderProgram *getInstancedProgram(ShaderProgram *program);
+
 	void genShaderVariableList(ShaderObject *obj, std::vector<ShaderObject::ShaderObjectVariable> &vars);
 
 	// Takes a string, and returns the appropriate enum representing that type (e.g "vec4" => SHADER_VEC4).
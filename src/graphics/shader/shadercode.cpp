@@ -75,6 +75,29 @@ void main(void) {\n\
 }\n\
 ";
 // ---------------------------------------------------------
+const char vertexDefaultInstanced3xText[] =
+"#version 330\n\
+\n\
+layout(location = 0) in vec3 inPosition;\n\
+layout(location = 3) in vec2 inTexCoord0;\n\
+layout(location = 6) in mat4 inInstanceMatrix;\n\
+\n\
+out vec2 texCoords;\n\
+\n\
+// Unused, but keeps the uniforms in line with the non-instanced shader.\n\
+uniform mat4 objectModelviewMatrix;\n\
+\n\
+uniform mat4 projectionMatrix;\n\
+uniform mat4 modelviewMatrix;\n\
+\n\
+void main(void) {\n\
+  vec4 vertex = (modelviewMatrix * inInstanceMatrix) * vec4(inPosition, 1.0f);\n\
+\n\
+  gl_Position = projectionMatrix * vertex;\n\
+  texCoords = inTexCoord0;\n\
+}\n\
+";
+// ---------------------------------------------------------
 
 
 // ---------------------------------------------------------
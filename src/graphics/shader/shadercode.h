@@ -34,6 +34,7 @@ namespace Shader {
 extern const char vertexDefault3xText[];
 extern const char fragmentDefault3xText[];
 extern const char fragmentColor3xText[];
+extern const char vertexDefaultInstanced3xText[];
 
 extern const char vertexDefault2xText[];
 extern const char fragmentDefault2xText[];
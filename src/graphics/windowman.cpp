@@ -45,6 +45,7 @@ namespace Graphics {
 
 WindowManager::WindowManager() {
 	_fullScreen = false;
+	_hidden     = false;
 
 	_fsaaMax = 0;
 
@@ -75,6 +76,13 @@ void WindowManager::init() {
 	_height     = ConfigMan.getInt ("height"    , _height);
 	_fullScreen = ConfigMan.getBool("fullscreen", false);
 
+	/* When benchmarking, the window is never shown. Together with the SDL
+	 * offscreen video driver (SDL_VIDEODRIVER=offscreen), this renders
+	 * without any visible window at all. */
+	_hidden = ConfigMan.hasKey("benchmark");
+	if (_hidden)
+		_fullScreen = false;
+
 	probeFSAA();
 
 	// Set the gamma correction to what the config specifies
@@ -117,6 +125,10 @@ bool WindowManager::initRender(RenderType type, bool useDebug, int fsaa) {
 		return false;
 	}
 
+	// Don't let vsync limit the frame rate while benchmarking
+	if (_hidden)
+		SDL_GL_SetSwapInterval(0);
+
 	status("OpenGL context successfully created:");
 	SDL_GL_GetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, &majorVersion);
 	SDL_GL_GetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, &minorVersion);
@@ -245,6 +257,8 @@ uint32 WindowManager::windowFlags() {
 	uint32 flags = SDL_WINDOW_OPENGL;
 	if (_fullScreen)
 		flags |= SDL_WINDOW_FULLSCREEN;
+	if (_hidden)
+		flags |= SDL_WINDOW_HIDDEN;
 	return flags;
 }
 
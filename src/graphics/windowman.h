@@ -101,6 +101,7 @@ private:
 	};
 
 	bool _fullScreen; ///< Are we currently in fullscreen mode?
+	bool _hidden;     ///< Do we render into a hidden window, because we're benchmarking?
 
 	int _fsaaMax; ///< Max supported FSAA level.
 
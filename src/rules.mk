@@ -64,6 +64,13 @@ src_xoreos_LDADD = \
     $(LDADD) \
     $(EMPTY)
 
+# Audio decoder benchmark, counting the decoders' allocations.
+# Not installed: it replaces the global operator new.
+
+noinst_PROGRAMS += src/soundbench
+src_soundbench_SOURCES = src/soundbench.cpp
+src_soundbench_LDADD = $(src_xoreos_LDADD)
+
 # Subdirectories
 
 include src/version/rules.mk
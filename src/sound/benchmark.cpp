@@ -0,0 +1,300 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarking the audio decoders, without any audio output.
+ */
+
+#include <cstdio>
+#include <vector>
+#include <map>
+
+#include <SDL_timer.h>
+
+#include "src/common/scopedptr.h"
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/error.h"
+#include "src/common/readfile.h"
+#include "src/common/filepath.h"
+#include "src/common/filelist.h"
+
+#include "src/sound/benchmark.h"
+#include "src/sound/sound.h"
+#include "src/sound/audiostream.h"
+#include "src/sound/interleaver.h"
+
+#include "src/sound/decoders/wave_types.h"
+
+namespace Sound {
+
+/** Number of samples decoded at once, the same as one OpenAL buffer. */
+static const size_t kBenchmarkBufferSize = 16384;
+
+/** The decoder name of files SoundManager::makeAudioStream() doesn't recognize. */
+static const char * const kUnknownDecoder = "unknown";
+
+/** Identify the decoder SoundManager::makeAudioStream() will use for this stream. */
+static Common::UString identifyDecoder(Common::SeekableReadStream &stream) {
+	const uint32 tag = stream.readUint32BE();
+
+	Common::UString decoder = kUnknownDecoder;
+
+	if        (tag == 0xfff360c4) {
+		// The sync word of a raw MP3 frame, as found in NWN's WAV files
+		decoder = "MP3";
+	} else if (tag == MKTAG('R', 'I', 'F', 'F')) {
+		stream.seek(20);
+
+		switch (stream.readUint16LE()) {
+			case kWavePCM:
+				decoder = "PCM";
+				break;
+
+			case kWaveMSADPCM:
+				decoder = "MS ADPCM";
+				break;
+
+			case kWaveMSIMAADPCM:
+			case kWaveMSIMAADPCM2:
+				decoder = "IMA ADPCM";
+				break;
+
+			case kWaveWMAv2:
+				decoder = "WMA";
+				break;
+
+			case 0x0055:
+				decoder = "MP3";
+				break;
+
+			default:
+				decoder = "WAV";
+				break;
+		}
+
+	} else if ((tag == MKTAG('B', 'M', 'U', ' ')) && (stream.readUint32BE() == MKTAG('V', '1', '.', '0'))) {
+		decoder = "MP3";
+	} else if (tag == MKTAG('O', 'g', 'g', 'S')) {
+		decoder = "Vorbis";
+	} else if (tag == 0x3026B275) {
+		decoder = "WMA";
+	} else if (((tag & 0xFFFFFF00) | 0x20) == MKTAG('I', 'D', '3', ' ')) {
+		decoder = "MP3";
+	} else if ((tag & 0xFFFA0000) == 0xFFFA0000) {
+		decoder = "MP3";
+	}
+
+	stream.seek(0);
+	return decoder;
+}
+
+Common::UString identifyDecoder(const Common::UString &file) {
+	Common::ReadFile stream(file);
+
+	return identifyDecoder(stream);
+}
+
+static AudioStream *openAudioFile(const Common::UString &file, Common::UString &decoder) {
+	Common::ScopedPtr<Common::SeekableReadStream> stream(new Common::ReadFile(file));
+
+	decoder = identifyDecoder(*stream);
+
+	AudioStream *audioStream = SoundManager::makeAudioStream(stream.get());
+	stream.release();
+
+	return audioStream;
+}
+
+DecoderBenchmark::DecoderBenchmark() : success(false), channels(0), rate(0), samples(0),
+	audioTime(0.0), decodeTime(0.0), countedAllocations(false), allocations(0), allocatedBytes(0) {
+
+}
+
+double DecoderBenchmark::getRealTimeFactor() const {
+	if (decodeTime <= 0.0)
+		return 0.0;
+
+	return audioTime / decodeTime;
+}
+
+DecoderBenchmark benchmarkDecoder(const Common::UString &file, bool interleave,
+                                  AllocationCounter *allocations) {
+
+	DecoderBenchmark result;
+	result.file = file;
+
+	Common::ScopedArray<int16> buffer(new int16[kBenchmarkBufferSize]);
+
+	if (allocations)
+		allocations->start();
+
+	const uint64 startTime = SDL_GetPerformanceCounter();
+
+	try {
+		Common::ScopedPtr<AudioStream> stream;
+
+		if (interleave) {
+			std::vector<AudioStream *> streams;
+
+			try {
+				streams.push_back(openAudioFile(file, result.decoder));
+				streams.push_back(openAudioFile(file, result.decoder));
+			} catch (...) {
+				for (std::vector<AudioStream *>::iterator s = streams.begin(); s != streams.end(); ++s)
+					delete *s;
+
+				throw;
+			}
+
+			stream.reset(makeInterleaver(streams.front()->getRate(), streams));
+
+			result.decoder = "Interleaver(" + result.decoder + ")";
+
+		} else
+			stream.reset(openAudioFile(file, result.decoder));
+
+		result.channels = stream->getChannels();
+		result.rate     = stream->getRate();
+
+		while (!stream->endOfData()) {
+			const size_t samples = stream->readBuffer(buffer.get(), kBenchmarkBufferSize);
+			if (samples == AudioStream::kSizeInvalid)
+				throw Common::Exception("Failed reading from the audio stream");
+
+			if (samples == 0)
+				break;
+
+			result.samples += samples;
+		}
+
+		result.success = true;
+
+	} catch (...) {
+		if (allocations)
+			allocations->stop(result.allocations, result.allocatedBytes);
+
+		Common::exceptionDispatcherWarning("Failed to decode \"%s\"", file.c_str());
+		return result;
+	}
+
+	const uint64 endTime = SDL_GetPerformanceCounter();
+
+	if (allocations) {
+		allocations->stop(result.allocations, result.allocatedBytes);
+		result.countedAllocations = true;
+	}
+
+	result.decodeTime = (double) (endTime - startTime) / SDL_GetPerformanceFrequency();
+
+	if ((result.channels > 0) && (result.rate > 0))
+		result.audioTime = (double) result.samples / result.channels / result.rate;
+
+	return result;
+}
+
+static void printBenchmark(const char *name, const char *decoder, int channels, int rate,
+                           const DecoderBenchmark &result) {
+
+	Common::UString allocations = "-", allocatedBytes = "-";
+	if (result.countedAllocations) {
+		allocations    = Common::composeString(result.allocations);
+		allocatedBytes = Common::FilePath::getHumanReadableSize(result.allocatedBytes);
+	}
+
+	std::printf("%-40s %-22s %2d %6d %9.2f %9.3f %9.1f %9s %10s\n", name, decoder, channels, rate,
+	            result.audioTime, result.decodeTime, result.getRealTimeFactor(),
+	            allocations.c_str(), allocatedBytes.c_str());
+}
+
+bool benchmarkDecoders(const Common::UString &path, AllocationCounter *allocations) {
+	Common::FileList files;
+
+	if (Common::FilePath::isDirectory(path)) {
+		Common::FileList directory(path, -1);
+
+		directory.getSubListGlob(".*\\.(wav|mp3|ogg|wma|bmu|asf)$", true, files);
+		files.sort(true);
+
+	} else if (Common::FilePath::isRegularFile(path)) {
+		Common::FileList directory(Common::FilePath::getDirectory(path));
+
+		directory.getSubList("/" + Common::FilePath::getFile(path), true, files);
+	}
+
+	if (files.empty()) {
+		warning("No audio files found in \"%s\"", path.c_str());
+		return false;
+	}
+
+	std::printf("%-40s %-22s %2s %6s %9s %9s %9s %9s %10s\n", "File", "Decoder", "Ch", "Rate",
+	            "Length", "Decode", "RTF", "Allocs", "Allocated");
+
+	typedef std::map<Common::UString, DecoderBenchmark> Summary;
+	Summary summary;
+
+	bool success = true;
+	for (Common::FileList::const_iterator f = files.begin(); f != files.end(); ++f) {
+		// Files that merely have a sound file extension would only distort the results
+		try {
+			if (identifyDecoder(*f) == kUnknownDecoder) {
+				std::printf("%-40s %-22s SKIPPED\n", Common::FilePath::getFile(*f).c_str(), kUnknownDecoder);
+				continue;
+			}
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed to open \"%s\"", f->c_str());
+
+			std::printf("%-40s %-22s FAILED\n", Common::FilePath::getFile(*f).c_str(), "");
+			success = false;
+			continue;
+		}
+
+		for (int interleave = 0; interleave < 2; interleave++) {
+			const DecoderBenchmark result = benchmarkDecoder(*f, interleave != 0, allocations);
+
+			success = success && result.success;
+			if (!result.success) {
+				std::printf("%-40s %-22s FAILED\n", Common::FilePath::getFile(*f).c_str(), result.decoder.c_str());
+				continue;
+			}
+
+			printBenchmark(Common::FilePath::getFile(*f).c_str(), result.decoder.c_str(),
+			               result.channels, result.rate, result);
+
+			DecoderBenchmark &total = summary[result.decoder];
+
+			total.countedAllocations = result.countedAllocations;
+
+			total.samples        += result.samples;
+			total.audioTime      += result.audioTime;
+			total.decodeTime     += result.decodeTime;
+			total.allocations    += result.allocations;
+			total.allocatedBytes += result.allocatedBytes;
+		}
+	}
+
+	std::printf("\n");
+	for (Summary::const_iterator s = summary.begin(); s != summary.end(); ++s)
+		printBenchmark("Total", s->first.c_str(), 0, 0, s->second);
+
+	return success;
+}
+
+} // End of namespace Sound
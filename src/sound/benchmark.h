@@ -0,0 +1,100 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmarking the audio decoders, without any audio output.
+ */
+
+#ifndef SOUND_BENCHMARK_H
+#define SOUND_BENCHMARK_H
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Sound {
+
+/** Counts the heap allocations made while an audio file is decoded.
+ *
+ *  Counting allocations needs a replaced global operator new, which
+ *  is something only a dedicated benchmark program can provide.
+ */
+class AllocationCounter {
+public:
+	virtual ~AllocationCounter() { }
+
+	/** Start counting allocations, from zero. */
+	virtual void start() = 0;
+	/** Stop counting, and return the number and combined size of the allocations. */
+	virtual void stop(uint64 &count, uint64 &size) = 0;
+};
+
+/** The result of decoding one audio file as fast as possible. */
+struct DecoderBenchmark {
+	Common::UString file;    ///< The decoded file.
+	Common::UString decoder; ///< The name of the decoder used for the file.
+
+	bool success; ///< Was the file decoded without errors?
+
+	int channels; ///< Number of channels in the decoded audio.
+	int rate;     ///< Sampling rate of the decoded audio.
+
+	uint64 samples; ///< Number of decoded samples, over all channels.
+
+	double audioTime;  ///< Length of the decoded audio, in seconds.
+	double decodeTime; ///< Time taken to create the stream and decode it, in seconds.
+
+	bool   countedAllocations; ///< Were the allocations counted?
+	uint64 allocations;        ///< Number of C++ heap allocations made while decoding.
+	uint64 allocatedBytes;     ///< Number of bytes allocated on the C++ heap while decoding.
+
+	DecoderBenchmark();
+
+	/** Return how many times faster than real time the audio was decoded. */
+	double getRealTimeFactor() const;
+};
+
+/** Return the name of the decoder used for an audio file, or "unknown" if it's not recognized. */
+Common::UString identifyDecoder(const Common::UString &file);
+
+/** Decode an audio file as fast as possible and measure it.
+ *
+ *  @param file The audio file to decode.
+ *  @param interleave If true, open the file twice and decode both
+ *                    streams together through an interleaver.
+ *  @param allocations If given, count the allocations made while decoding.
+ */
+DecoderBenchmark benchmarkDecoder(const Common::UString &file, bool interleave = false,
+                                  AllocationCounter *allocations = 0);
+
+/** Benchmark all audio files found in a path and print a report.
+ *
+ *  Every file is decoded once on its own, and once interleaved with
+ *  itself. Files in an unknown format are skipped. The report, with a
+ *  summary for every decoder, is written to stdout.
+ *
+ *  @param  path A single audio file, or a directory to search recursively.
+ *  @param  allocations If given, count the allocations made while decoding.
+ *  @return true if all files decoded without errors.
+ */
+bool benchmarkDecoders(const Common::UString &path, AllocationCounter *allocations = 0);
+
+} // End of namespace Sound
+
+#endif // SOUND_BENCHMARK_H
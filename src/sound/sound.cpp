@@ -33,6 +33,7 @@
 #include "src/common/error.h"
 #include "src/common/configman.h"
 #include "src/common/debug.h"
+#include "src/common/frameprofiler.h"
 
 #include "src/sound/sound.h"
 #include "src/sound/audiostream.h"
@@ -58,17 +59,36 @@ static const size_t kOpenALBufferCount = 5;
  */
 static const size_t kOpenALBufferSize = 32768;
 
+/** Number of buffers per sound kept decoded in addition to the queued OpenAL buffers.
+ *
+ *  The sound thread itself fills them at the end of each update, so that the
+ *  next update can immediately queue them. This is a larger synchronous
+ *  prefill, not a decoder running in the background.
+ *
+ *  @note Check the channels' underrun counts before changing this.
+ */
+static const size_t kPrefillBufferCount = 2;
+
+/** Maximal number of unused PCM staging buffers kept around for reuse. */
+static const size_t kPCMBufferPoolSize = 64;
+
 namespace Sound {
 
+SoundManager::PCMBuffer::PCMBuffer() : data(new byte[kOpenALBufferSize]), size(0) {
+}
+
+
 SoundManager::Channel::Channel(uint32 i, size_t idx, SoundType t,
                                const TypeList::iterator &ti, AudioStream *s, bool d) :
 	id(i), index(idx), state(AL_PAUSED), stream(s, d), source(0),
-	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f) {
+	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f), underruns(0), nullTimestamp(0), nullPlayTime(0), activeIndex(0), users(0), freed(false) {
 
 }
 
 
-SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0) {
+SoundManager::SoundManager() : _ready(false), _hasSound(false), _nullOutput(false),
+	_hasMultiChannel(false), _format51(0) {
+	_unusedChannel = 0;
 }
 
 SoundManager::~SoundManager() {
@@ -80,13 +100,27 @@ void SoundManager::init() {
 
 	_curID = 1;
 
+	_unusedChannel = 0;
+	_freeChannels.clear();
+
 	_ctx = 0;
 
-	_hasSound = false;
+	_hasSound   = false;
+	_nullOutput = false;
 
 	_hasMultiChannel = false;
 	_format51        = 0;
 
+	if (ConfigMan.getBool("nullsound", false)) {
+		// Don't open an audio device, but still decode all sounds at the rate they would play
+		_nullOutput = createThread();
+		if (!_nullOutput)
+			warning("Failed to create sound thread: %s", SDL_GetError());
+
+		_ready = true;
+		return;
+	}
+
 	try {
 		_dev = alcOpenDevice(0);
 		if (!_dev)
@@ -134,8 +168,10 @@ void SoundManager::deinit() {
 	if (!destroyThread())
 		warning("SoundManager::deinit(): Sound thread had to be killed");
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		freeChannel(i);
+	while (!_activeChannels.empty())
+		freeChannel(_activeChannels.back()->index);
+
+	clearPCMBuffers();
 
 	if (_hasSound) {
 		alcMakeContextCurrent(0);
@@ -169,18 +205,19 @@ bool SoundManager::isValidChannel(const ChannelHandle &handle) const {
 bool SoundManager::isPlaying(const ChannelHandle &handle) {
 	Common::StackLock lock(_mutex);
 
-	if ((handle.channel >= kChannelCount) || (handle.id == 0) || !_channels[handle.channel])
+	Channel *channel = getChannel(handle);
+	if (!channel)
 		return false;
 
-	if (_channels[handle.channel]->id != handle.id)
-		return false;
+	Common::StackLock channelLock(channel->mutex);
 
-	return isPlaying(handle.channel);
+	return isPlaying(*channel);
 }
 
-bool SoundManager::isPlaying(size_t channel) const {
-	if ((channel >= kChannelCount) || !_channels[channel])
-		return false;
+bool SoundManager::isPlaying(Channel &channel) {
+	// Without an audio device, a sound plays until all its data has been consumed
+	if (_nullOutput)
+		return channel.stream && !(channel.stream->endOfStream() && channel.decoded.empty());
 
 	// TODO: This might pose a problem should we ever need to wait
 	//       for sounds to finish (for syncing, ...). We need to
@@ -192,33 +229,41 @@ bool SoundManager::isPlaying(size_t channel) const {
 	ALenum error = AL_NO_ERROR;
 
 	ALint val;
-	alGetSourcei(_channels[channel]->source, AL_SOURCE_STATE, &val);
+	alGetSourcei(channel.source, AL_SOURCE_STATE, &val);
 	if ((error = alGetError()) != AL_NO_ERROR)
 		throw Common::Exception("OpenAL error while getting source state in %s: 0x%X",
-		                        formatChannel(_channels[channel].get()).c_str(), error);
+		                        formatChannel(&channel).c_str(), error);
 
 	if (val != AL_PLAYING) {
-		if (!_channels[channel]->stream || _channels[channel]->stream->endOfStream()) {
+		if (!channel.stream || (channel.stream->endOfStream() && channel.decoded.empty())) {
 			ALint buffersQueued;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_QUEUED, &buffersQueued);
+			alGetSourcei(channel.source, AL_BUFFERS_QUEUED, &buffersQueued);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while getting queued buffers in %s: 0x%X",
-				                        formatChannel(_channels[channel].get()).c_str(), error);
+				                        formatChannel(&channel).c_str(), error);
 
 			ALint buffersProcessed;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_PROCESSED, &buffersProcessed);
+			alGetSourcei(channel.source, AL_BUFFERS_PROCESSED, &buffersProcessed);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while getting processed buffers in %s: 0x%X",
-				                        formatChannel(_channels[channel].get()).c_str(), error);
+				                        formatChannel(&channel).c_str(), error);
 
 			if (buffersQueued == buffersProcessed)
 				return false;
 		}
 
-		if (_channels[channel]->state != AL_PLAYING)
+		if (channel.state != AL_PLAYING)
 			return true;
 
-		alSourcePlay(_channels[channel]->source);
+		// The source stopped on its own, even though there's still data: it ran dry
+		if (val == AL_STOPPED) {
+			channel.underruns++;
+
+			debugC(Common::kDebugSound, 1, "Sound channel %s underrun (%u total)",
+			       formatChannel(&channel).c_str(), channel.underruns);
+		}
+
+		alSourcePlay(channel.source);
 	}
 
 	return true;
@@ -233,7 +278,10 @@ bool SoundManager::isPaused(const ChannelHandle &handle) {
 	if (_channels[handle.channel]->id != handle.id)
 		return false;
 
-	return _channels[handle.channel]->state == AL_PAUSED;
+	Channel &channel = *_channels[handle.channel];
+	Common::StackLock channelLock(channel.mutex);
+
+	return channel.state == AL_PAUSED;
 }
 
 AudioStream *SoundManager::makeAudioStream(Common::SeekableReadStream *stream) {
@@ -322,29 +370,42 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 	if (!audStream)
 		throw Common::Exception("No audio stream");
 
-	Common::StackLock lock(_mutex);
+	/* Create the channel and decode its initial buffers before taking the global
+	 * lock, so that starting a sound doesn't stall the other channels. The OpenAL
+	 * objects are then only created with the lock held. */
+	Channel *channel = new Channel(0, kChannelInvalid, type, _types[type].list.end(), audStream, disposeAfterUse);
 
-	ChannelHandle handle = newChannel();
+	channel->nullTimestamp = EventMan.getTimestamp();
 
 	bool success = false;
-	BOOST_SCOPE_EXIT ( (&success) (&handle) (this_) ) {
-		if (!success)
-			this_->freeChannel(handle);
+	BOOST_SCOPE_EXIT ( (&success) (&channel) (this_) ) {
+		if (!success) {
+			Common::StackLock lock(this_->_mutex);
+
+			this_->destroyChannel(channel);
+		}
 	} BOOST_SCOPE_EXIT_END
 
-	const TypeList::iterator typeEndIt = _types[type].list.end();
+	if (!channel->stream)
+		throw Common::Exception("Could not detect stream type");
 
-	_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, typeEndIt, audStream, disposeAfterUse));
-	Channel &channel = *_channels[handle.channel];
+	if (_hasSound) {
+		for (size_t i = 0; i < kOpenALBufferCount; i++) {
+			PCMBuffer *pcm = decodeBuffer(*channel);
+			if (!pcm)
+				break;
 
-	if (!channel.stream)
-		throw Common::Exception("Could not detect stream type");
+			channel->decoded.push_back(pcm);
+		}
+	}
+
+	Common::StackLock lock(_mutex);
 
 	ALenum error = AL_NO_ERROR;
 
 	if (_hasSound) {
 		// Create the source
-		alGenSources(1, &channel.source);
+		alGenSources(1, &channel->source);
 		if ((error = alGetError()) != AL_NO_ERROR)
 			throw Common::Exception("OpenAL error while generating sources: 0x%X", error);
 
@@ -356,27 +417,38 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while generating buffers: 0x%X", error);
 
-			if (fillBuffer(channel, buffer, channel.stream.get(), channel.bufferSize[buffer])) {
+			channel->buffers.push_back(buffer);
+
+			if (fillBuffer(*channel, buffer, channel->bufferSize[buffer])) {
 				// If we could fill the buffer with data, queue it
 
-				alSourceQueueBuffers(channel.source, 1, &buffer);
+				alSourceQueueBuffers(channel->source, 1, &buffer);
 				if ((error = alGetError()) != AL_NO_ERROR)
 					throw Common::Exception("OpenAL error while queueing buffers: 0x%X", error);
 
 			} else
 				// If not, put it into our free list
-				channel.freeBuffers.push_back(buffer);
-
-			channel.buffers.push_back(buffer);
+				channel->freeBuffers.push_back(buffer);
 		}
-
-		// Set the gain to the current sound type gain
-		alSourcef(channel.source, AL_GAIN, _types[channel.type].gain);
 	}
 
-	// Add the channel to the correct type list
-	_types[channel.type].list.push_back(&channel);
-	channel.typeIt = --_types[channel.type].list.end();
+	ChannelHandle handle = newChannel();
+
+	channel->id    = handle.id;
+	channel->index = handle.channel;
+
+	// Set the gain to the current sound type gain
+	if (_hasSound)
+		alSourcef(channel->source, AL_GAIN, _types[channel->type].gain);
+
+	// Add the channel to the correct type list and the active list
+	_activeChannels.push_back(channel);
+	channel->activeIndex = _activeChannels.size() - 1;
+
+	_types[channel->type].list.push_back(channel);
+	channel->typeIt = --_types[channel->type].list.end();
+
+	_channels[handle.channel].reset(channel);
 
 	debugC(Common::kDebugSound, 2, "Created sound channel %s", formatChannel(handle).c_str());
 
@@ -436,7 +508,11 @@ void SoundManager::startChannel(ChannelHandle &handle) {
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	channel->state = AL_PLAYING;
+	{
+		Common::StackLock channelLock(channel->mutex);
+
+		channel->state = AL_PLAYING;
+	}
 
 	debugC(Common::kDebugSound, 1, "Start sound channel %s", formatChannel(handle).c_str());
 
@@ -478,15 +554,15 @@ void SoundManager::stopChannel(ChannelHandle &handle) {
 void SoundManager::pauseAll(bool pause) {
 	Common::StackLock lock(_mutex);
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		pauseChannel(_channels[i].get(), pause);
+	for (std::vector<Channel *>::iterator c = _activeChannels.begin(); c != _activeChannels.end(); ++c)
+		pauseChannel(*c, pause);
 }
 
 void SoundManager::stopAll() {
 	Common::StackLock lock(_mutex);
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		freeChannel(i);
+	while (!_activeChannels.empty())
+		freeChannel(_activeChannels.back()->index);
 }
 
 void SoundManager::setListenerGain(float gain) {
@@ -509,6 +585,8 @@ void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, floa
 		throw Common::Exception("Cannot set position of a non-mono sound in %s",
 		                        formatChannel(handle).c_str());
 
+	Common::StackLock channelLock(channel->mutex);
+
 	if (_hasSound)
 		alSource3f(channel->source, AL_POSITION, x, y, z);
 }
@@ -524,6 +602,8 @@ void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, flo
 		throw Common::Exception("Cannot get position of a non-mono sound in %s",
 		                        formatChannel(handle).c_str());
 
+	Common::StackLock channelLock(channel->mutex);
+
 	if (_hasSound)
 		alGetSource3f(channel->source, AL_POSITION, &x, &y, &z);
 }
@@ -535,6 +615,8 @@ void SoundManager::setChannelGain(const ChannelHandle &handle, float gain) {
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
+	Common::StackLock channelLock(channel->mutex);
+
 	channel->gain = gain;
 
 	if (_hasSound)
@@ -548,39 +630,68 @@ void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
+	Common::StackLock channelLock(channel->mutex);
+
 	if (_hasSound)
 		alSourcef(channel->source, AL_PITCH, pitch);
 }
 
-uint64 SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
+uint32 SoundManager::getChannelUnderruns(const ChannelHandle &handle) {
 	Common::StackLock lock(_mutex);
 
 	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	if (!channel)
 		return 0;
 
-	// Update the queued/unqueued buffers to make sure the channel is up-to-date
-	bufferData(*channel);
+	Common::StackLock channelLock(channel->mutex);
 
-	// The position within the currently playing buffer
-	ALint currentPosition;
-	alGetSourcei(channel->source, AL_BYTE_OFFSET, &currentPosition);
+	return channel->underruns;
+}
 
-	// Total number of bytes processed
-	uint64 byteCount = channel->finishedBuffers + currentPosition;
+uint64 SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
+	Common::StackLock lock(_mutex);
 
-	// Number of 16bit samples per channel
-	return byteCount / channel->stream->getChannels() / 2;
+	Channel *channel = getChannel(handle);
+	if (!channel)
+		return 0;
+
+	Common::StackLock channelLock(channel->mutex);
+
+	return getSamplesPlayed(*channel);
 }
 
 uint64 SoundManager::getChannelDurationPlayed(const ChannelHandle &handle) {
 	Common::StackLock lock(_mutex);
 
 	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
+	if (!channel)
+		return 0;
+
+	Common::StackLock channelLock(channel->mutex);
+
+	if (!channel->stream)
 		return 0;
 
-	return (getChannelSamplesPlayed(handle) * 1000) / channel->stream->getRate();
+	return (getSamplesPlayed(*channel) * 1000) / channel->stream->getRate();
+}
+
+uint64 SoundManager::getSamplesPlayed(Channel &channel) {
+	if (!channel.stream)
+		return 0;
+
+	// Update the unqueued buffers to make sure the channel is up-to-date
+	unqueueBuffers(channel);
+
+	// The position within the currently playing buffer
+	ALint currentPosition = 0;
+	if (_hasSound)
+		alGetSourcei(channel.source, AL_BYTE_OFFSET, &currentPosition);
+
+	// Total number of bytes processed
+	uint64 byteCount = channel.finishedBuffers + currentPosition;
+
+	// Number of 16bit samples per channel
+	return byteCount / channel.stream->getChannels() / 2;
 }
 
 void SoundManager::setTypeGain(SoundType type, float gain) {
@@ -595,28 +706,28 @@ void SoundManager::setTypeGain(SoundType type, float gain) {
 	for (TypeList::iterator t = _types[type].list.begin(); t != _types[type].list.end(); ++t) {
 		assert(*t);
 
+		Common::StackLock channelLock((*t)->mutex);
+
 		if (_hasSound)
 			alSourcef((*t)->source, AL_GAIN, (*t)->gain * gain);
 	}
 }
 
-bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
-                              AudioStream *stream, ALsizei &bufferedSize) const {
-
+bool SoundManager::fillBuffer(Channel &channel, ALuint alBuffer, ALsizei &bufferedSize) {
 	bufferedSize = 0;
 
-	if (!stream)
+	if (!channel.stream)
 		throw Common::Exception("No stream in %s", formatChannel(&channel).c_str());
 
 	if (!_hasSound)
 		return true;
 
-	if (stream->endOfData())
+	if (channel.stream->endOfData() && channel.decoded.empty())
 		return false;
 
 	ALenum format;
 
-	const int channelCount = stream->getChannels();
+	const int channelCount = channel.stream->getChannels();
 	if        (channelCount == 1) {
 		format = AL_FORMAT_MONO16;
 	} else if (channelCount == 2) {
@@ -636,20 +747,19 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 		return false;
 	}
 
-	// Read in the required amount of samples
-	size_t numSamples = kOpenALBufferSize / 2;
-
-	Common::ScopedArray<byte> buffer(new byte[kOpenALBufferSize]);
-	std::memset(buffer.get(), 0, kOpenALBufferSize);
+	// Take the data from the prefilled buffers, or decode some now
+	PCMBuffer *pcm = 0;
+	if (!channel.decoded.empty()) {
+		pcm = channel.decoded.front();
+		channel.decoded.pop_front();
+	} else
+		if (!(pcm = decodeBuffer(channel)))
+			return false;
 
-	numSamples = stream->readBuffer(reinterpret_cast<int16 *>(buffer.get()), numSamples);
-	if (numSamples == AudioStream::kSizeInvalid) {
-		warning("Failed reading from stream while filling buffer in %s", formatChannel(&channel).c_str());
-		return false;
-	}
+	bufferedSize = pcm->size;
+	alBufferData(alBuffer, format, pcm->data.get(), bufferedSize, channel.stream->getRate());
 
-	bufferedSize = numSamples * 2;
-	alBufferData(alBuffer, format, buffer.get(), bufferedSize, stream->getRate());
+	returnPCMBuffer(pcm);
 
 	ALenum error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -660,14 +770,82 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 	return true;
 }
 
-void SoundManager::bufferData(size_t channel) {
-	if ((channel >= kChannelCount) || !_channels[channel])
+SoundManager::PCMBuffer *SoundManager::decodeBuffer(Channel &channel) {
+	if (!channel.stream || channel.stream->endOfData())
+		return 0;
+
+	Common::ScopedPtr<PCMBuffer> pcm(getPCMBuffer());
+
+	// Read in the required amount of samples
+	size_t numSamples = channel.stream->readBuffer(reinterpret_cast<int16 *>(pcm->data.get()), kOpenALBufferSize / 2);
+	if (numSamples == AudioStream::kSizeInvalid) {
+		warning("Failed reading from stream while filling buffer in %s", formatChannel(&channel).c_str());
+
+		returnPCMBuffer(pcm.release());
+		return 0;
+	}
+
+	pcm->size = numSamples * 2;
+
+	return pcm.release();
+}
+
+void SoundManager::prefillBuffers(Channel &channel) {
+	if ((!_hasSound && !_nullOutput) || !channel.stream)
 		return;
 
-	bufferData(*_channels[channel]);
+	for (size_t count = channel.decoded.size(); count < kPrefillBufferCount; count++) {
+		PCMBuffer *pcm = decodeBuffer(channel);
+		if (!pcm)
+			break;
+
+		channel.decoded.push_back(pcm);
+	}
 }
 
-void SoundManager::bufferData(Channel &channel) {
+SoundManager::PCMBuffer *SoundManager::getPCMBuffer() {
+	{
+		Common::StackLock lock(_pcmMutex);
+
+		if (!_pcmBuffers.empty()) {
+			PCMBuffer *buffer = _pcmBuffers.back();
+			_pcmBuffers.pop_back();
+
+			return buffer;
+		}
+	}
+
+	return new PCMBuffer;
+}
+
+void SoundManager::returnPCMBuffer(PCMBuffer *buffer) {
+	if (!buffer)
+		return;
+
+	buffer->size = 0;
+
+	{
+		Common::StackLock lock(_pcmMutex);
+
+		if (_pcmBuffers.size() < kPCMBufferPoolSize) {
+			_pcmBuffers.push_back(buffer);
+			return;
+		}
+	}
+
+	delete buffer;
+}
+
+void SoundManager::clearPCMBuffers() {
+	Common::StackLock lock(_pcmMutex);
+
+	for (std::vector<PCMBuffer *>::iterator b = _pcmBuffers.begin(); b != _pcmBuffers.end(); ++b)
+		delete *b;
+
+	_pcmBuffers.clear();
+}
+
+void SoundManager::unqueueBuffers(Channel &channel) {
 	if (!channel.stream)
 		return;
 
@@ -702,11 +880,28 @@ void SoundManager::bufferData(Channel &channel) {
 
 		channel.finishedBuffers += channel.bufferSize[freeBuffers[i]];
 	}
+}
+
+void SoundManager::bufferData(Channel &channel) {
+	if (!channel.stream)
+		return;
+
+	if (_nullOutput) {
+		consumeNullOutput(channel);
+		return;
+	}
+
+	if (!_hasSound)
+		return;
+
+	unqueueBuffers(channel);
+
+	ALenum error = AL_NO_ERROR;
 
 	// Buffer as long as we still have data and free buffers
 	std::list<ALuint>::iterator buffer = channel.freeBuffers.begin();
 	while (buffer != channel.freeBuffers.end()) {
-		if (!fillBuffer(channel, *buffer, channel.stream.get(), channel.bufferSize[*buffer]))
+		if (!fillBuffer(channel, *buffer, channel.bufferSize[*buffer]))
 			break;
 
 		alSourceQueueBuffers(channel.source, 1, &*buffer);
@@ -718,40 +913,107 @@ void SoundManager::bufferData(Channel &channel) {
 	}
 }
 
+void SoundManager::consumeNullOutput(Channel &channel) {
+	const uint32 now = EventMan.getTimestamp();
+
+	// Only a playing channel consumes data
+	if (channel.state == AL_PLAYING)
+		channel.nullPlayTime += now - channel.nullTimestamp;
+
+	channel.nullTimestamp = now;
+
+	const uint64 bytesPerSecond = channel.stream->getRate() * channel.stream->getChannels() * 2;
+	const uint64 bytesPlayed    = (channel.nullPlayTime * bytesPerSecond) / 1000;
+
+	while (channel.finishedBuffers < bytesPlayed) {
+		PCMBuffer *pcm = 0;
+		if (!channel.decoded.empty()) {
+			pcm = channel.decoded.front();
+			channel.decoded.pop_front();
+		} else
+			if (!(pcm = decodeBuffer(channel)))
+				break;
+
+		const ALsizei size = pcm->size;
+		channel.finishedBuffers += size;
+
+		returnPCMBuffer(pcm);
+
+		if (size == 0)
+			break;
+	}
+}
+
 void SoundManager::checkReady() {
 	if (!_ready)
 		throw Common::Exception("SoundManager not ready");
 }
 
 void SoundManager::update() {
-	Common::StackLock lock(_mutex);
+	// Take all active channels, marking them as in use by this update pass
+	{
+		Common::StackLock lock(_mutex);
 
-	size_t channelCount = 0;
-	for (size_t i = 0; i < kChannelCount; i++) {
-		if (!_channels[i])
-			continue;
+		_updateChannels = _activeChannels;
+		for (std::vector<Channel *>::iterator c = _updateChannels.begin(); c != _updateChannels.end(); ++c)
+			(*c)->users++;
+	}
 
-		channelCount++;
+	for (std::vector<Channel *>::iterator c = _updateChannels.begin(); c != _updateChannels.end(); ++c) {
+		Channel &channel = **c;
 
-		// Free the channel if it is no longer playing
-		if (!isPlaying(i)) {
-			freeChannel(i);
-			continue;
+		bool playing = false;
+		try {
+			Common::StackLock lock(_mutex);
+			Common::StackLock channelLock(channel.mutex);
+
+			// Try to buffer some more data, if the channel is still playing
+			if (!channel.freed && (playing = isPlaying(channel)))
+				bufferData(channel);
+
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed to update sound channel %s", formatChannel(&channel).c_str());
+			playing = false;
+		}
+
+		// Prefill the next buffers, without holding up the other sound calls
+		if (playing) {
+			try {
+				Common::StackLock channelLock(channel.mutex);
+
+				if (!channel.freed)
+					prefillBuffers(channel);
+
+			} catch (...) {
+				Common::exceptionDispatcherWarning("Failed to decode sound channel %s", formatChannel(&channel).c_str());
+			}
 		}
 
-		// Try to buffer some more data
-		bufferData(i);
+		Common::StackLock lock(_mutex);
+
+		channel.users--;
+
+		// Free the channel if it is no longer playing, and delete it if it was freed in the meantime
+		if      (channel.freed && (channel.users == 0))
+			destroyChannel(&channel);
+		else if (!channel.freed && !playing)
+			freeChannel(channel.index);
 	}
 
-	debugC(Common::kDebugSound, 9, "Active sound channel: %s", Common::composeString(channelCount).c_str());
+	debugC(Common::kDebugSound, 9, "Active sound channel: %s", Common::composeString(_updateChannels.size()).c_str());
+
+	_updateChannels.clear();
 }
 
 ChannelHandle SoundManager::newChannel() {
 	size_t foundChannel = kChannelInvalid;
 
-	for (size_t i = 0; (i < kChannelCount) && (foundChannel == kChannelInvalid); i++)
-		if (!_channels[i])
-			foundChannel = i;
+	// Reuse a freed channel slot, or take one that's never been used
+	if (!_freeChannels.empty()) {
+		foundChannel = _freeChannels.back();
+		_freeChannels.pop_back();
+	} else if (_unusedChannel < kChannelCount)
+		foundChannel = _unusedChannel++;
 
 	if (foundChannel == kChannelInvalid)
 		throw Common::Exception("All sound channels occupied");
@@ -772,6 +1034,8 @@ void SoundManager::pauseChannel(Channel *channel, bool pause) {
 	if (!channel || channel->id == 0)
 		return;
 
+	Common::StackLock channelLock(channel->mutex);
+
 	ALenum error = AL_NO_ERROR;
 	if (pause) {
 		if (_hasSound) {
@@ -792,6 +1056,8 @@ void SoundManager::pauseChannel(Channel *channel) {
 	if (!channel)
 		return;
 
+	Common::StackLock channelLock(channel->mutex);
+
 	if      (channel->state == AL_PAUSED)
 		pauseChannel(channel, false);
 	else if (channel->state == AL_PLAYING)
@@ -813,35 +1079,73 @@ void SoundManager::freeChannel(size_t channel) {
 	if (channel >= kChannelCount)
 		return;
 
-	Channel *c = _channels[channel].get();
+	Channel *c = _channels[channel].release();
 	if (!c)
 		// Nothing to do
 		return;
 
-	// Discard the stream
-	c->stream.reset();
+	// Remove the channel from the type list
+	if (c->typeIt != _types[c->type].list.end())
+		_types[c->type].list.erase(c->typeIt);
+
+	c->typeIt = _types[c->type].list.end();
+
+	// Remove the channel from the active list, moving the last active channel into its place
+	Channel *last = _activeChannels.back();
+
+	_activeChannels[c->activeIndex] = last;
+	last->activeIndex = c->activeIndex;
+
+	_activeChannels.pop_back();
+
+	_freeChannels.push_back(channel);
+
+	// If an update pass is still working on the channel, it will delete the channel when done
+	{
+		Common::StackLock channelLock(c->mutex);
+
+		c->freed = true;
+	}
+
+	if (c->users == 0)
+		destroyChannel(c);
+}
+
+void SoundManager::destroyChannel(Channel *channel) {
+	if (!channel)
+		return;
+
+	// Discard the stream and the prefilled buffers
+	channel->stream.reset();
+
+	for (PCMBufferList::iterator pcm = channel->decoded.begin(); pcm != channel->decoded.end(); ++pcm)
+		returnPCMBuffer(*pcm);
+
+	channel->decoded.clear();
 
 	if (_hasSound) {
 		// Delete the channel's OpenAL source
-		if (c->source)
-			alDeleteSources(1, &c->source);
+		if (channel->source)
+			alDeleteSources(1, &channel->source);
 
 		// Delete the OpenAL buffers
-		for (std::list<ALuint>::iterator buffer = c->buffers.begin(); buffer != c->buffers.end(); ++buffer)
+		for (std::list<ALuint>::iterator buffer = channel->buffers.begin(); buffer != channel->buffers.end(); ++buffer)
 			alDeleteBuffers(1, &*buffer);
 	}
 
-	// Remove the channel from the type list
-	if (c->typeIt != _types[c->type].list.end())
-		_types[c->type].list.erase(c->typeIt);
-
 	// And finally delete the channel itself
-	_channels[channel].reset();
+	delete channel;
 }
 
 void SoundManager::threadMethod() {
+	FrameProf.setThreadName("Sound");
+
 	while (!_killThread) {
-		update();
+		{
+			Common::ProfileZone profile("update");
+			update();
+		}
+
 		_needUpdate.wait(100);
 	}
 }
@@ -36,6 +36,7 @@
 #endif
 
 #include <list>
+#include <vector>
 #include <map>
 
 #include "src/common/types.h"
@@ -157,6 +158,9 @@ public:
 
 	/** Set the pitch of the channel. */
 	void setChannelPitch(const ChannelHandle &handle, float pitch);
+
+	/** Return the number of times the channel ran out of data while playing. */
+	uint32 getChannelUnderruns(const ChannelHandle &handle);
 	// '---
 
 	// .--- Type properties
@@ -182,6 +186,15 @@ private:
 	struct Channel;
 	typedef std::list<Channel *> TypeList;
 
+	/** A staging buffer of decoded PCM data, waiting to be handed to OpenAL. */
+	struct PCMBuffer {
+		Common::ScopedArray<byte> data; ///< The decoded 16-bit samples.
+		ALsizei size;                   ///< Number of valid bytes in the buffer.
+
+		PCMBuffer();
+	};
+	typedef std::list<PCMBuffer *> PCMBufferList;
+
 	/** A sound type. */
 	struct Type {
 		float    gain; ///< The sound type's current gain.
@@ -212,6 +225,29 @@ private:
 
 		float gain; ///< The channel's gain.
 
+		/** Prefilled PCM data not yet handed to OpenAL, in playing order. */
+		PCMBufferList decoded;
+
+		/** Number of times the channel ran out of queued data while playing. */
+		uint32 underruns;
+
+		uint32 nullTimestamp; ///< Timestamp of the last null output update.
+		uint64 nullPlayTime;  ///< Milliseconds the channel played on the null output.
+
+		/** Protects the channel's state, stream, buffers and OpenAL source.
+		 *
+		 *  Always locked after the global mutex, if both are needed. Decoding is
+		 *  done under this mutex alone, everything touching OpenAL under both.
+		 */
+		Common::Mutex mutex;
+
+		size_t activeIndex; ///< The channel's index within the active channels list.
+
+		/** Number of update passes currently working on the channel. */
+		uint32 users;
+		/** Was the channel freed while an update pass was working on it? */
+		bool freed;
+
 		Channel(uint32 i, size_t idx, SoundType t, const TypeList::iterator &ti, AudioStream *s, bool d);
 	};
 
@@ -219,12 +255,24 @@ private:
 
 	bool _hasSound; ///< Do we have working sound output?
 
+	/** Are we consuming sounds without an audio device, in real time? */
+	bool _nullOutput;
+
 	bool _hasMultiChannel; ///< Do we have the multi-channel extension?
 	ALenum _format51; ///< The value for the 5.1 multi-channel format.
 
 	Common::ScopedPtr<Channel> _channels[kChannelCount]; ///< The sound channels.
 	Type _types[kSoundTypeMAX]; ///< The sound types.
 
+	std::vector<Channel *> _activeChannels; ///< All allocated channels, densely packed.
+	std::vector<Channel *> _updateChannels; ///< The channels the current update pass works on.
+
+	std::vector<size_t> _freeChannels; ///< Indices of channels that have been freed.
+	size_t _unusedChannel;             ///< Lowest channel index that has never been used.
+
+	std::vector<PCMBuffer *> _pcmBuffers; ///< Unused PCM staging buffers, for reuse.
+	Common::Mutex _pcmMutex;              ///< Protects the PCM staging buffers.
+
 	uint32 _curID; ///< The ID the next sound will get.
 
 	Common::Mutex _mutex;
@@ -238,19 +286,29 @@ private:
 	/** Check that the SoundManager was properly initialized. */
 	void checkReady();
 
-	/** Update the sound information. Called regularly from within the thread method. */
+	/** Update the sound information. Called regularly from within the thread method.
+	 *
+	 *  The global mutex is only held while updating the OpenAL state of each
+	 *  channel. Prefilling the buffers is done under the channel's own mutex alone,
+	 *  so that it doesn't hold up the creation and control of other channels.
+	 */
 	void update();
 
-	/** Look for a free place in the channel vector. */
+	/** Take a free place in the channel vector. */
 	ChannelHandle newChannel();
 
+	/** Unqueue the OpenAL buffers that finished playing. */
+	void unqueueBuffers(Channel &channel);
 	/** Buffer more sound from the channel to the OpenAL buffers. */
 	void bufferData(Channel &channel);
-	/** Buffer more sound from the channel to the OpenAL buffers. */
-	void bufferData(size_t channel);
+	/** Discard as much sound from the channel as would have been played by now. */
+	void consumeNullOutput(Channel &channel);
 
 	/** Is that channel currently playing a sound? */
-	bool isPlaying(size_t channel) const;
+	bool isPlaying(Channel &channel);
+
+	/** Return the number of samples the channel played so far. */
+	uint64 getSamplesPlayed(Channel &channel);
 
 	/** Pause/Unpause a channel. */
 	void pauseChannel(Channel *channel, bool pause);
@@ -262,6 +320,9 @@ private:
 	/** Stop and free a channel. */
 	void freeChannel(size_t channel);
 
+	/** Release all resources of a channel no longer in the channel vector, and delete it. */
+	void destroyChannel(Channel *channel);
+
 	/** Return the channel the handle refers to. */
 	const Channel *getChannel(const ChannelHandle &handle) const;
 	/** Return the channel the handle refers to. */
@@ -269,9 +330,24 @@ private:
 
 	void threadMethod();
 
-	/** Fill the buffer with data from the audio stream. */
-	bool fillBuffer(const Channel &channel, ALuint alBuffer,
-	                AudioStream *stream, ALsizei &bufferedSize) const;
+	/** Fill the buffer with data from the audio stream.
+	 *
+	 *  The prefilled buffers are used first. Only if there are none left,
+	 *  the stream is decoded right away.
+	 */
+	bool fillBuffer(Channel &channel, ALuint alBuffer, ALsizei &bufferedSize);
+
+	/** Decode the next chunk of the channel's audio stream into a staging buffer. */
+	PCMBuffer *decodeBuffer(Channel &channel);
+	/** Synchronously decode the channel's audio stream into a few more staging buffers. */
+	void prefillBuffers(Channel &channel);
+
+	/** Take a PCM staging buffer out of the pool, or create a new one. */
+	PCMBuffer *getPCMBuffer();
+	/** Return a PCM staging buffer into the pool. */
+	void returnPCMBuffer(PCMBuffer *buffer);
+	/** Delete all pooled PCM staging buffers. */
+	void clearPCMBuffers();
 
 	/** Return a string representing this channel. */
 	Common::UString formatChannel(const Channel *channel) const;
@@ -0,0 +1,150 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark the audio decoders, counting their heap allocations.
+ *
+ *  This is a separate program, because counting the allocations
+ *  means replacing the global operator new and delete.
+ */
+
+#define SDL_MAIN_HANDLED
+
+#include "src/common/atomic.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+
+#include "src/sound/benchmark.h"
+
+#if __cplusplus >= 201103L
+	#define THROW_BAD_ALLOC
+	#define THROW_NOTHING noexcept
+#else
+	#define THROW_BAD_ALLOC throw(std::bad_alloc)
+	#define THROW_NOTHING throw()
+#endif
+
+static boost::atomic<bool>   countAllocations(false);
+static boost::atomic<uint64> allocationCount(0);
+static boost::atomic<uint64> allocationSize(0);
+
+static void *allocate(std::size_t size) {
+	if (countAllocations.load(boost::memory_order_relaxed)) {
+		allocationCount.fetch_add(1, boost::memory_order_relaxed);
+		allocationSize.fetch_add(size, boost::memory_order_relaxed);
+	}
+
+	return std::malloc(size ? size : 1);
+}
+
+void *operator new(std::size_t size) THROW_BAD_ALLOC {
+	void *ptr = allocate(size);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void *operator new[](std::size_t size) THROW_BAD_ALLOC {
+	void *ptr = allocate(size);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) THROW_NOTHING {
+	return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) THROW_NOTHING {
+	return allocate(size);
+}
+
+void operator delete(void *ptr) THROW_NOTHING {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) THROW_NOTHING {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) THROW_NOTHING {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) THROW_NOTHING {
+	std::free(ptr);
+}
+
+/** Counts the allocations made through the operators above. */
+class GlobalAllocationCounter : public Sound::AllocationCounter {
+public:
+	void start() {
+		allocationCount.store(0);
+		allocationSize.store(0);
+
+		countAllocations.store(true);
+	}
+
+	void stop(uint64 &count, uint64 &size) {
+		countAllocations.store(false);
+
+		count = allocationCount.load();
+		size  = allocationSize.load();
+	}
+};
+
+int main(int argc, char **argv) {
+	std::vector<Common::UString> args;
+
+	try {
+		Common::Platform::init();
+		Common::Platform::getParameters(argc, argv, args);
+	} catch (...) {
+		Common::exceptionDispatcherError();
+		return 1;
+	}
+
+	if (args.size() != 2) {
+		std::printf("Usage: %s <PATH>\n\n", args.empty() ? "soundbench" : args[0].c_str());
+		std::printf("Benchmark the audio decoders with the audio file PATH,\n");
+		std::printf("or with all audio files found in the directory PATH.\n");
+		return 1;
+	}
+
+	GlobalAllocationCounter counter;
+
+	try {
+		return Sound::benchmarkDecoders(args[1], &counter) ? 0 : 1;
+	} catch (...) {
+		Common::exceptionDispatcherError();
+	}
+
+	return 1;
+}
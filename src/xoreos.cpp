@@ -38,8 +38,10 @@
 #include "src/common/platform.h"
 #include "src/common/filepath.h"
 #include "src/common/threads.h"
+#include "src/common/threadpool.h"
 #include "src/common/debugman.h"
 #include "src/common/configman.h"
+#include "src/common/frameprofiler.h"
 #include "src/common/xml.h"
 
 #include "src/aurora/resman.h"
@@ -48,6 +50,8 @@
 #include "src/aurora/talkman.h"
 #include "src/aurora/util.h"
 
+#include "src/aurora/nwscript/profiler.h"
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/graphics.h"
 
@@ -126,6 +130,9 @@ int main(int argc, char **argv) {
 	if (!ConfigMan.setGame(target) || !ConfigMan.isInGame())
 		error("No target \"%s\" in the config file", target.c_str());
 
+	// Write the log in the background from now on
+	DebugMan.startLogWriter();
+
 	/* Open the log file.
 	 *
 	 * NOTE: A log is opened by default, unless the logfile config value
@@ -188,8 +195,10 @@ int main(int argc, char **argv) {
 		Common::exceptionDispatcherError();
 	}
 
-	if (EventMan.fatalErrorRaised())
+	if (EventMan.fatalErrorRaised()) {
+		DebugMan.stopLogWriter();
 		std::exit(1);
+	}
 
 	status("Shutting down");
 
@@ -201,6 +210,26 @@ int main(int argc, char **argv) {
 	destroyEngineProbes(probes);
 
 	try {
+		// Write the script profile, if we recorded one
+		if (ScriptProf.isEnabled()) {
+			const Common::UString profileFile = Common::FilePath::getUserDataFile("scriptprofile.txt");
+
+			if (ScriptProf.dump(profileFile))
+				status("Wrote the script profile to \"%s\"", profileFile.c_str());
+			else
+				warning("Failed to write the script profile to \"%s\"", profileFile.c_str());
+		}
+
+		// Write the frame profile trace, if we recorded one
+		if (FrameProf.isEnabled()) {
+			const Common::UString traceFile = Common::FilePath::getUserDataFile("frameprofile.json");
+
+			if (FrameProf.dumpTrace(traceFile))
+				status("Wrote the frame profile trace to \"%s\"", traceFile.c_str());
+			else
+				warning("Failed to write the frame profile trace to \"%s\"", traceFile.c_str());
+		}
+
 		// Sync changed debug channel settings
 		DebugMan.setConfigToVerbosityLevels();
 
@@ -253,6 +282,7 @@ static void initConfig() {
 	ConfigMan.setDouble(Common::kConfigRealmDefault, "volume_video", 1.0);
 
 	ConfigMan.setBool(Common::kConfigRealmDefault, "showfps", false);
+	ConfigMan.setBool(Common::kConfigRealmDefault, "showprofile", false);
 
 	ConfigMan.setBool(Common::kConfigRealmDefault, "skipvideos", false);
 
@@ -285,6 +315,21 @@ static void init() {
 	// Init threading system
 	Common::initThreads();
 
+	// Start the worker threads shared by all subsystems
+	Common::ThreadPoolManager::instance();
+
+	// Record where the frames spend their time, if requested
+	FrameProf.setThreadName("Main");
+	FrameProf.setEnabled(ConfigMan.getBool("profile", false));
+
+	// Size of the cache of unpacked resources, in MB
+	if (ConfigMan.hasKey("resourcecache"))
+		ResMan.setCacheSize(((size_t) MAX(ConfigMan.getInt("resourcecache"), 0)) * 1024 * 1024);
+
+	// Size up to which archives within archives are copied into memory, in KB
+	if (ConfigMan.hasKey("archivecopysize"))
+		ResMan.setArchiveCopySize(((size_t) MAX(ConfigMan.getInt("archivecopysize"), 0)) * 1024);
+
 	// Init libxml2
 	Common::initXML();
 
@@ -319,6 +364,7 @@ static void deinit() {
 	Aurora::LanguageManager::destroy();
 	Aurora::TalkManager::destroy();
 	Aurora::TwoDARegistry::destroy();
+	Aurora::NWScript::ScriptProfiler::destroy();
 	Aurora::ResourceManager::destroy();
 	Aurora::FileTypeManager::destroy();
 
@@ -333,6 +379,9 @@ static void deinit() {
 	Graphics::GraphicsManager::destroy();
 	Graphics::QueueManager::destroy();
 
+	Common::ThreadPoolManager::destroy();
+
+	Common::FrameProfiler::destroy();
 	Common::DebugManager::destroy();
 	Common::ConfigManager::destroy();
 }